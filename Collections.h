@@ -38,6 +38,13 @@ namespace bpp{
 
 #include "Collections/Combination.h"
 #include "Collections/Serialize.h"
+#include "Collections/Map/AdaptiveRadixMap.h"
+#include "Collections/Map/BTree.h"
+#include "Collections/Map/CompactTreeAVL.h"
+#include "Collections/Map/ConcurrentTreeAVL.h"
+#include "Collections/Map/FrozenTreeAVL.h"
+#include "Collections/Map/PersistentTreeAVL.h"
+#include "Collections/Map/RadixTrie.h"
 #include "Collections/Map/TreeAVL.h"
 #include "Collections/Map/Trie.h"
 
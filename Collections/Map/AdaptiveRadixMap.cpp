@@ -0,0 +1,650 @@
+#ifndef BPP_COLLECTIONS_MAP_ADAPTIVERADIXMAP_CPP
+#define BPP_COLLECTIONS_MAP_ADAPTIVERADIXMAP_CPP
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+// Empty initialization
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::AdaptiveRadixMap() :
+	counter(0),
+	layout(Inline4){ }
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::AdaptiveRadixMap(const Allocator& alloc) :
+	alloc(alloc),
+	counter(0),
+	layout(Inline4){ }
+
+// Iterator initialization
+template <class Key, class T, class Allocator> template <class InputIt> AdaptiveRadixMap<Key,T,Allocator>::AdaptiveRadixMap(InputIt first, InputIt last, const Allocator& alloc) :
+	alloc(alloc),
+	counter(0),
+	layout(Inline4){
+	this->insert(first, last);
+}
+
+// Copy initialization
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::AdaptiveRadixMap(const AdaptiveRadixMap& other) :
+	alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc)),
+	counter(0),
+	layout(Inline4){
+	this->assign(other);
+}
+
+// Move initialization
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::AdaptiveRadixMap(AdaptiveRadixMap&& other) noexcept :
+	alloc(other.alloc),
+	counter(0),
+	layout(Inline4){
+	this->steal(other);
+}
+
+// List initialization
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::AdaptiveRadixMap(std::initializer_list<value_type> init, const Allocator& alloc) :
+	alloc(alloc),
+	counter(0),
+	layout(Inline4){
+	this->insert(init.begin(), init.end());
+}
+
+// Destructor
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::~AdaptiveRadixMap(){
+	this->release();
+}
+
+// Assignment
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>& AdaptiveRadixMap<Key,T,Allocator>::operator=(const AdaptiveRadixMap& other){
+	if(this != &other){
+		this->release();
+		if constexpr(std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value){
+			this->alloc = other.alloc;
+		}
+		this->assign(other);
+	}
+	return *this;
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>& AdaptiveRadixMap<Key,T,Allocator>::operator=(AdaptiveRadixMap&& other) noexcept{
+	if(this != &other){
+		this->release();
+		this->alloc = other.alloc;
+		this->steal(other);
+	}
+	return *this;
+}
+
+// Get allocator
+template <class Key, class T, class Allocator> Allocator AdaptiveRadixMap<Key,T,Allocator>::get_allocator() const noexcept{
+	return this->alloc;
+}
+
+// Element access
+template <class Key, class T, class Allocator> T& AdaptiveRadixMap<Key,T,Allocator>::at(const Key& key){
+	uint16_t position = this->search(byte(key));
+	if(position == end_position){ throw std::out_of_range("bpp::collections::map::AdaptiveRadixMap::at"); }
+	return this->value_at(position);
+}
+template <class Key, class T, class Allocator> const T& AdaptiveRadixMap<Key,T,Allocator>::at(const Key& key) const{
+	uint16_t position = this->search(byte(key));
+	if(position == end_position){ throw std::out_of_range("bpp::collections::map::AdaptiveRadixMap::at"); }
+	return this->value_at(position);
+}
+template <class Key, class T, class Allocator> T& AdaptiveRadixMap<Key,T,Allocator>::operator[](const Key& key){
+	return this->value_at(this->emplace(byte(key)).first);
+}
+
+// Iterators
+// Iterator
+template <class Key, class T, class Allocator> std::pair<const Key, T&> AdaptiveRadixMap<Key,T,Allocator>::iterator::operator*() const{
+	return std::pair<const Key, T&>(key_of(this->container->key_at(this->position)), this->container->value_at(this->position));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator::pointer AdaptiveRadixMap<Key,T,Allocator>::iterator::operator->() const{
+	return pointer{**this};
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator& AdaptiveRadixMap<Key,T,Allocator>::iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::iterator::operator++(int){
+	iterator pit(*this);
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator& AdaptiveRadixMap<Key,T,Allocator>::iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::iterator::operator--(int){
+	iterator pit(*this);
+	this->previous_element();
+	return pit;
+}
+// Constant Iterator
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator::const_iterator(const iterator& other) :
+	iterator_actions(other){ }
+template <class Key, class T, class Allocator> std::pair<const Key, const T&> AdaptiveRadixMap<Key,T,Allocator>::const_iterator::operator*() const{
+	return std::pair<const Key, const T&>(key_of(this->container->key_at(this->position)), this->container->value_at(this->position));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator::pointer AdaptiveRadixMap<Key,T,Allocator>::const_iterator::operator->() const{
+	return pointer{**this};
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator& AdaptiveRadixMap<Key,T,Allocator>::const_iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::const_iterator::operator++(int){
+	const_iterator pit(*this);
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator& AdaptiveRadixMap<Key,T,Allocator>::const_iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::const_iterator::operator--(int){
+	const_iterator pit(*this);
+	this->previous_element();
+	return pit;
+}
+
+// Iterator generation methods
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::begin() noexcept{
+	return iterator(this, this->sorted() ? (this->counter ? 0 : end_position) : this->next_present(0));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::begin() const noexcept{
+	return const_iterator(this, this->sorted() ? (this->counter ? 0 : end_position) : this->next_present(0));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::cbegin() const noexcept{
+	return this->begin();
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::end() noexcept{
+	return iterator(this, end_position);
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::end() const noexcept{
+	return const_iterator(this, end_position);
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::cend() const noexcept{
+	return this->end();
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::reverse_iterator AdaptiveRadixMap<Key,T,Allocator>::rbegin() noexcept{
+	return reverse_iterator(this->end());
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_reverse_iterator AdaptiveRadixMap<Key,T,Allocator>::rbegin() const noexcept{
+	return const_reverse_iterator(this->end());
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::reverse_iterator AdaptiveRadixMap<Key,T,Allocator>::rend() noexcept{
+	return reverse_iterator(this->begin());
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_reverse_iterator AdaptiveRadixMap<Key,T,Allocator>::rend() const noexcept{
+	return const_reverse_iterator(this->begin());
+}
+
+// Capacity
+template <class Key, class T, class Allocator> bool AdaptiveRadixMap<Key,T,Allocator>::empty() const noexcept{
+	return !this->counter;
+}
+template <class Key, class T, class Allocator> std::size_t AdaptiveRadixMap<Key,T,Allocator>::size() const noexcept{
+	return this->counter;
+}
+template <class Key, class T, class Allocator> std::size_t AdaptiveRadixMap<Key,T,Allocator>::max_size() const noexcept{
+	return 256;
+}
+template <class Key, class T, class Allocator> std::size_t AdaptiveRadixMap<Key,T,Allocator>::memory() const noexcept{
+	switch(this->layout){
+		case Sorted16: return sizeof(AdaptiveRadixMap) + sizeof(Node16);
+		case Indexed48: return sizeof(AdaptiveRadixMap) + sizeof(Node48);
+		case Direct256: return sizeof(AdaptiveRadixMap) + sizeof(Node256);
+		default: return sizeof(AdaptiveRadixMap);
+	}
+}
+
+// Modifiers
+// Clear
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::clear() noexcept{
+	this->release();
+}
+// Insert
+template <class Key, class T, class Allocator> std::pair<typename AdaptiveRadixMap<Key,T,Allocator>::iterator, bool> AdaptiveRadixMap<Key,T,Allocator>::insert(const value_type& value){
+	std::pair<uint16_t, bool> result = this->emplace(byte(value.first));
+	if(result.second){ this->value_at(result.first) = value.second; }
+	return std::pair<iterator, bool>(iterator(this, result.first), result.second);
+}
+template <class Key, class T, class Allocator> template <class InputIt> void AdaptiveRadixMap<Key,T,Allocator>::insert(InputIt first, InputIt last){
+	for(auto it = first; it != last; ++it){
+		std::pair<uint16_t, bool> result = this->emplace(byte(it->first));
+		if(result.second){ this->value_at(result.first) = it->second; }
+	}
+}
+// Insert or Assign
+template <class Key, class T, class Allocator> template <class M> std::pair<typename AdaptiveRadixMap<Key,T,Allocator>::iterator, bool> AdaptiveRadixMap<Key,T,Allocator>::insert_or_assign(const Key& k, M&& obj){
+	std::pair<uint16_t, bool> result = this->emplace(byte(k));
+	this->value_at(result.first) = std::forward<M>(obj);
+	return std::pair<iterator, bool>(iterator(this, result.first), result.second);
+}
+// Erase
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::erase(const_iterator pos){
+	// The removal may move the elements or change the layout, so the following element is searched again
+	unsigned char b = this->key_at(pos.position);
+	this->remove(b);
+	return iterator(this, this->bound(b, false));
+}
+template <class Key, class T, class Allocator> std::size_t AdaptiveRadixMap<Key,T,Allocator>::erase(const Key& key){
+	unsigned char b = byte(key);
+	if(this->search(b) == end_position){ return 0; }
+	this->remove(b);
+	return 1;
+}
+// Swap
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::swap(AdaptiveRadixMap& other) noexcept{
+	AdaptiveRadixMap tmp(std::move(other));
+	other = std::move(*this);
+	*this = std::move(tmp);
+}
+
+// Lookup
+// Count
+template <class Key, class T, class Allocator> std::size_t AdaptiveRadixMap<Key,T,Allocator>::count(const Key& key) const{
+	return this->search(byte(key)) != end_position ? 1 : 0;
+}
+// Find
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::find(const Key& key){
+	return iterator(this, this->search(byte(key)));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::find(const Key& key) const{
+	return const_iterator(this, this->search(byte(key)));
+}
+// Contains
+template <class Key, class T, class Allocator> bool AdaptiveRadixMap<Key,T,Allocator>::contains(const Key& key) const{
+	return this->search(byte(key)) != end_position;
+}
+// Bounds
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::lower_bound(const Key& key){
+	return iterator(this, this->bound(byte(key), false));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::lower_bound(const Key& key) const{
+	return const_iterator(this, this->bound(byte(key), false));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator AdaptiveRadixMap<Key,T,Allocator>::upper_bound(const Key& key){
+	return iterator(this, this->bound(byte(key), true));
+}
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::const_iterator AdaptiveRadixMap<Key,T,Allocator>::upper_bound(const Key& key) const{
+	return const_iterator(this, this->bound(byte(key), true));
+}
+
+// Observers
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::key_compare AdaptiveRadixMap<Key,T,Allocator>::key_comp() const{
+	return key_compare();
+}
+
+// Non-member functions
+// Operators
+template <class A, class B, class C> bool operator==(const AdaptiveRadixMap<A,B,C>& lhs, const AdaptiveRadixMap<A,B,C>& rhs){
+	if(lhs.size() != rhs.size()){ return false; }
+	for(auto lit = lhs.begin(), rit = rhs.begin(); lit != lhs.end(); ++lit, ++rit){
+		if(lit->first != rit->first || !(lit->second == rit->second)){ return false; }
+	}
+	return true;
+}
+
+// Private methods
+template <class Key, class T, class Allocator> template <class Pair> Pair* AdaptiveRadixMap<Key,T,Allocator>::arrow<Pair>::operator->(){
+	return &this->value;
+}
+template <class Key, class T, class Allocator> unsigned char AdaptiveRadixMap<Key,T,Allocator>::byte(const Key& key){
+	return std::bit_cast<unsigned char>(key) ^ sign_offset;
+}
+template <class Key, class T, class Allocator> Key AdaptiveRadixMap<Key,T,Allocator>::key_of(unsigned char byte){
+	return std::bit_cast<Key>((unsigned char) (byte ^ sign_offset));
+}
+template <class Key, class T, class Allocator> bool AdaptiveRadixMap<Key,T,Allocator>::sorted() const{
+	return this->layout <= Sorted16;
+}
+template <class Key, class T, class Allocator> unsigned char* AdaptiveRadixMap<Key,T,Allocator>::sorted_keys() const{
+	return this->layout == Inline4 ? const_cast<unsigned char*>(this->keys) : this->node16->keys;
+}
+template <class Key, class T, class Allocator> T* AdaptiveRadixMap<Key,T,Allocator>::sorted_values() const{
+	return this->layout == Inline4 ? const_cast<T*>(this->values) : this->node16->values;
+}
+template <class Key, class T, class Allocator> const uint64_t* AdaptiveRadixMap<Key,T,Allocator>::present() const{
+	return this->layout == Indexed48 ? this->node48->present : this->node256->present;
+}
+template <class Key, class T, class Allocator> uint16_t AdaptiveRadixMap<Key,T,Allocator>::search(unsigned char byte) const{
+	// Returns the position of the element with key byte, its slot in the sorted layouts and the byte itself in the indexed ones
+	switch(this->layout){
+		case Inline4:
+			for(uint16_t i=0; i<this->counter; ++i){
+				if(this->keys[i] == byte){ return i; }
+			}
+			return end_position;
+		case Sorted16:{
+			#if defined(__SSE2__)
+				// All sixteen keys are compared at once, and the lanes past the last one are masked out
+				__m128i cmp = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) this->node16->keys), _mm_set1_epi8((char) byte));
+				unsigned mask = (unsigned) _mm_movemask_epi8(cmp) & ((1u << this->counter) - 1);
+				return mask ? (uint16_t) std::countr_zero(mask) : end_position;
+			#else
+				for(uint16_t i=0; i<this->counter; ++i){
+					if(this->node16->keys[i] == byte){ return i; }
+				}
+				return end_position;
+			#endif
+		}
+		case Indexed48:
+			return this->node48->slots[byte] ? byte : end_position;
+		default:
+			return ((this->node256->present[byte >> 6] >> (byte & 63)) & 1) ? byte : end_position;
+	}
+}
+template <class Key, class T, class Allocator> uint16_t AdaptiveRadixMap<Key,T,Allocator>::bound(unsigned char byte, bool upper) const{
+	// Returns the position of the first element with key not less than byte (greater if upper)
+	uint16_t position = 0;
+	switch(this->layout){
+		case Inline4:
+			while(position < this->counter && (this->keys[position] < byte || (upper && this->keys[position] == byte))){ ++position; }
+			break;
+		case Sorted16:{
+			#if defined(__SSE2__)
+				// The keys are sorted, so the number of them before byte is the position. Bytes are compared as signed after flipping their top bit
+				__m128i bias = _mm_set1_epi8((char) 0x80);
+				__m128i k = _mm_xor_si128(_mm_loadu_si128((const __m128i*) this->node16->keys), bias);
+				__m128i b = _mm_set1_epi8((char) (byte ^ 0x80));
+				__m128i before = upper ? _mm_or_si128(_mm_cmplt_epi8(k, b), _mm_cmpeq_epi8(k, b)) : _mm_cmplt_epi8(k, b);
+				position = (uint16_t) std::popcount((unsigned) _mm_movemask_epi8(before) & ((1u << this->counter) - 1));
+			#else
+				while(position < this->counter && (this->node16->keys[position] < byte || (upper && this->node16->keys[position] == byte))){ ++position; }
+			#endif
+			break;
+		}
+		default:
+			return (upper && byte == 255) ? end_position : this->next_present(upper ? byte+1 : byte);
+	}
+	return position < this->counter ? position : end_position;
+}
+template <class Key, class T, class Allocator> uint16_t AdaptiveRadixMap<Key,T,Allocator>::next_present(unsigned bit) const{
+	// First byte at or after bit present in an indexed layout
+	if(bit >= 256){ return end_position; }
+	const uint64_t* present = this->present();
+	unsigned word = bit >> 6;
+	uint64_t bits = present[word] & (~0ULL << (bit & 63));
+	while(!bits){
+		if(++word == 4){ return end_position; }
+		bits = present[word];
+	}
+	return (uint16_t) (word*64 + std::countr_zero(bits));
+}
+template <class Key, class T, class Allocator> uint16_t AdaptiveRadixMap<Key,T,Allocator>::previous_present(unsigned bit) const{
+	// Last byte before bit present in an indexed layout
+	if(!bit){ return end_position; }
+	const uint64_t* present = this->present();
+	unsigned word = (bit-1) >> 6;
+	uint64_t bits = present[word] & (~0ULL >> (63 - ((bit-1) & 63)));
+	while(!bits){
+		if(!word--){ return end_position; }
+		bits = present[word];
+	}
+	return (uint16_t) (word*64 + 63 - std::countl_zero(bits));
+}
+template <class Key, class T, class Allocator> unsigned char AdaptiveRadixMap<Key,T,Allocator>::key_at(uint16_t position) const{
+	return this->sorted() ? this->sorted_keys()[position] : (unsigned char) position;
+}
+template <class Key, class T, class Allocator> T& AdaptiveRadixMap<Key,T,Allocator>::value_at(uint16_t position) const{
+	switch(this->layout){
+		case Inline4: return const_cast<T&>(this->values[position]);
+		case Sorted16: return this->node16->values[position];
+		case Indexed48: return this->node48->values[this->node48->slots[position]-1];
+		default: return this->node256->values[position];
+	}
+}
+template <class Key, class T, class Allocator> std::pair<uint16_t, bool> AdaptiveRadixMap<Key,T,Allocator>::emplace(unsigned char byte){
+	// Returns the position of the element with key byte, inserting a value-initialized one (and growing first if full) if missing
+	uint16_t position = this->search(byte);
+	if(position != end_position){ return std::pair<uint16_t, bool>(position, false); }
+	if((this->layout == Inline4 && this->counter == capacity_inline) || (this->layout == Sorted16 && this->counter == capacity_sorted) || (this->layout == Indexed48 && this->counter == capacity_indexed)){
+		this->grow();
+	}
+	switch(this->layout){
+		case Inline4:
+		case Sorted16:{
+			unsigned char* k = this->sorted_keys();
+			T* v = this->sorted_values();
+			position = this->bound(byte, false);
+			position = position == end_position ? this->counter : position;
+			std::memmove(k + position + 1, k + position, this->counter - position);
+			std::memmove(v + position + 1, v + position, (this->counter - position) * sizeof(T));
+			k[position] = byte;
+			v[position] = T();
+			break;
+		}
+		case Indexed48:{
+			uint16_t slot = (uint16_t) std::countr_one(this->node48->used);
+			this->node48->used |= 1ULL << slot;
+			this->node48->slots[byte] = (unsigned char) (slot+1);
+			this->node48->present[byte >> 6] |= 1ULL << (byte & 63);
+			this->node48->values[slot] = T();
+			position = byte;
+			break;
+		}
+		default:
+			this->node256->present[byte >> 6] |= 1ULL << (byte & 63);
+			this->node256->values[byte] = T();
+			position = byte;
+	}
+	++this->counter;
+	return std::pair<uint16_t, bool>(position, true);
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::remove(unsigned char byte){
+	// Removes the element with key byte, which must exist, and shrinks into the previous layout if small enough
+	switch(this->layout){
+		case Inline4:
+		case Sorted16:{
+			unsigned char* k = this->sorted_keys();
+			T* v = this->sorted_values();
+			uint16_t position = this->search(byte);
+			std::memmove(k + position, k + position + 1, this->counter - position - 1);
+			std::memmove(v + position, v + position + 1, (this->counter - position - 1) * sizeof(T));
+			break;
+		}
+		case Indexed48:
+			this->node48->used &= ~(1ULL << (this->node48->slots[byte]-1));
+			this->node48->slots[byte] = 0;
+			this->node48->present[byte >> 6] &= ~(1ULL << (byte & 63));
+			break;
+		default:
+			this->node256->present[byte >> 6] &= ~(1ULL << (byte & 63));
+	}
+	--this->counter;
+	if((this->layout == Sorted16 && this->counter == shrink_sorted) || (this->layout == Indexed48 && this->counter == shrink_indexed) || (this->layout == Direct256 && this->counter == shrink_direct)){
+		this->shrink();
+	}
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::grow(){
+	switch(this->layout){
+		case Inline4:{
+			// The inline values share their storage with the pointer to the new node
+			AllocatorNode16 nodeAlloc(this->alloc);
+			Node16* node = nodeAlloc.allocate(1);
+			std::memcpy(node->keys, this->keys, this->counter);
+			std::memcpy(node->values, this->values, this->counter * sizeof(T));
+			this->node16 = node;
+			this->layout = Sorted16;
+			break;
+		}
+		case Sorted16:{
+			AllocatorNode16 oldAlloc(this->alloc);
+			AllocatorNode48 nodeAlloc(this->alloc);
+			Node16* old = this->node16;
+			Node48* node = nodeAlloc.allocate(1);
+			std::memset(node->present, 0, sizeof(node->present));
+			std::memset(node->slots, 0, sizeof(node->slots));
+			node->used = (1ULL << this->counter) - 1;
+			for(uint16_t i=0; i<this->counter; ++i){
+				node->slots[old->keys[i]] = (unsigned char) (i+1);
+				node->present[old->keys[i] >> 6] |= 1ULL << (old->keys[i] & 63);
+				node->values[i] = old->values[i];
+			}
+			oldAlloc.deallocate(old, 1);
+			this->node48 = node;
+			this->layout = Indexed48;
+			break;
+		}
+		default:{
+			AllocatorNode48 oldAlloc(this->alloc);
+			AllocatorNode256 nodeAlloc(this->alloc);
+			Node48* old = this->node48;
+			Node256* node = nodeAlloc.allocate(1);
+			std::memcpy(node->present, old->present, sizeof(node->present));
+			for(uint16_t b = this->next_present(0); b != end_position; b = this->next_present(b+1)){
+				node->values[b] = old->values[old->slots[b]-1];
+			}
+			oldAlloc.deallocate(old, 1);
+			this->node256 = node;
+			this->layout = Direct256;
+		}
+	}
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::shrink(){
+	switch(this->layout){
+		case Sorted16:{
+			// The node is read before the inline values overwrite the pointer to it
+			AllocatorNode16 oldAlloc(this->alloc);
+			Node16* old = this->node16;
+			std::memcpy(this->keys, old->keys, this->counter);
+			std::memcpy(this->values, old->values, this->counter * sizeof(T));
+			oldAlloc.deallocate(old, 1);
+			this->layout = Inline4;
+			break;
+		}
+		case Indexed48:{
+			AllocatorNode48 oldAlloc(this->alloc);
+			AllocatorNode16 nodeAlloc(this->alloc);
+			Node48* old = this->node48;
+			Node16* node = nodeAlloc.allocate(1);
+			uint16_t i = 0;
+			for(uint16_t b = this->next_present(0); b != end_position; b = this->next_present(b+1), ++i){
+				node->keys[i] = (unsigned char) b;
+				node->values[i] = old->values[old->slots[b]-1];
+			}
+			oldAlloc.deallocate(old, 1);
+			this->node16 = node;
+			this->layout = Sorted16;
+			break;
+		}
+		default:{
+			AllocatorNode256 oldAlloc(this->alloc);
+			AllocatorNode48 nodeAlloc(this->alloc);
+			Node256* old = this->node256;
+			Node48* node = nodeAlloc.allocate(1);
+			std::memcpy(node->present, old->present, sizeof(node->present));
+			std::memset(node->slots, 0, sizeof(node->slots));
+			node->used = (1ULL << this->counter) - 1;
+			uint16_t i = 0;
+			for(uint16_t b = this->next_present(0); b != end_position; b = this->next_present(b+1), ++i){
+				node->slots[b] = (unsigned char) (i+1);
+				node->values[i] = old->values[b];
+			}
+			oldAlloc.deallocate(old, 1);
+			this->node48 = node;
+			this->layout = Indexed48;
+		}
+	}
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::release() noexcept{
+	switch(this->layout){
+		case Sorted16:{
+			AllocatorNode16 nodeAlloc(this->alloc);
+			nodeAlloc.deallocate(this->node16, 1);
+			break;
+		}
+		case Indexed48:{
+			AllocatorNode48 nodeAlloc(this->alloc);
+			nodeAlloc.deallocate(this->node48, 1);
+			break;
+		}
+		case Direct256:{
+			AllocatorNode256 nodeAlloc(this->alloc);
+			nodeAlloc.deallocate(this->node256, 1);
+			break;
+		}
+		default: break;
+	}
+	this->counter = 0;
+	this->layout = Inline4;
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::assign(const AdaptiveRadixMap& other){
+	// Copies the layout of other into this empty container
+	switch(other.layout){
+		case Sorted16:{
+			AllocatorNode16 nodeAlloc(this->alloc);
+			this->node16 = nodeAlloc.allocate(1);
+			std::memcpy(this->node16, other.node16, sizeof(Node16));
+			break;
+		}
+		case Indexed48:{
+			AllocatorNode48 nodeAlloc(this->alloc);
+			this->node48 = nodeAlloc.allocate(1);
+			std::memcpy(this->node48, other.node48, sizeof(Node48));
+			break;
+		}
+		case Direct256:{
+			AllocatorNode256 nodeAlloc(this->alloc);
+			this->node256 = nodeAlloc.allocate(1);
+			std::memcpy(this->node256, other.node256, sizeof(Node256));
+			break;
+		}
+		default:
+			std::memcpy(this->keys, other.keys, other.counter);
+			std::memcpy(this->values, other.values, other.counter * sizeof(T));
+	}
+	this->counter = other.counter;
+	this->layout = other.layout;
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::steal(AdaptiveRadixMap& other) noexcept{
+	// Takes the elements of other into this empty container, leaving other empty
+	switch(other.layout){
+		case Sorted16: this->node16 = other.node16; break;
+		case Indexed48: this->node48 = other.node48; break;
+		case Direct256: this->node256 = other.node256; break;
+		default:
+			std::memcpy(this->keys, other.keys, other.counter);
+			std::memcpy(this->values, other.values, other.counter * sizeof(T));
+	}
+	this->counter = other.counter;
+	this->layout = other.layout;
+	other.counter = 0;
+	other.layout = Inline4;
+}
+
+// Iterator actions
+template <class Key, class T, class Allocator> AdaptiveRadixMap<Key,T,Allocator>::iterator_actions::iterator_actions(const AdaptiveRadixMap* container, uint16_t position) :
+	container(container),
+	position(position){ }
+template <class Key, class T, class Allocator> bool AdaptiveRadixMap<Key,T,Allocator>::iterator_actions::operator==(const iterator_actions& other) const{
+	return this->position == other.position;
+}
+template <class Key, class T, class Allocator> bool AdaptiveRadixMap<Key,T,Allocator>::iterator_actions::operator!=(const iterator_actions& other) const{
+	return this->position != other.position;
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::iterator_actions::next_element(){
+	if(this->position == end_position){ return; }
+	if(this->container->sorted()){
+		this->position = (this->position+1 < this->container->counter) ? this->position+1 : end_position;
+	}else{
+		this->position = this->container->next_present(this->position+1);
+	}
+}
+template <class Key, class T, class Allocator> void AdaptiveRadixMap<Key,T,Allocator>::iterator_actions::previous_element(){
+	// Regressing end() points at the last element, the first element becomes end()
+	if(this->container->sorted()){
+		if(this->position == end_position){
+			this->position = this->container->counter ? this->container->counter-1 : end_position;
+		}else{
+			this->position = this->position ? this->position-1 : end_position;
+		}
+	}else{
+		this->position = this->container->previous_present(this->position);
+	}
+}
+
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,315 @@
+#ifndef BPP_COLLECTIONS_MAP_ADAPTIVERADIXMAP_H
+#define BPP_COLLECTIONS_MAP_ADAPTIVERADIXMAP_H
+#include <bit>				// std::bit_cast, std::countr_zero, std::countl_zero, std::countr_one, std::popcount
+#include <cstdint>			// uint8_t, uint16_t, uint64_t
+#include <cstring>			// std::memcpy, std::memmove, std::memset
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list<>
+#include <iterator>			// std::bidirectional_iterator_tag, std::reverse_iterator<>
+#include <memory>			// std::allocator<>, std::allocator_traits<>
+#include <stdexcept>		// std::out_of_range
+#include <type_traits>		// std::conditional_t, std::is_integral_v, std::is_enum_v, std::is_signed_v, std::is_trivially_copyable_v, std::is_trivially_default_constructible_v, std::underlying_type<>, std::type_identity<>
+#include <utility>			// std::pair, std::forward
+#if defined(__SSE2__)
+	#include <emmintrin.h>	// _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8, _mm_cmplt_epi8, _mm_xor_si128, _mm_movemask_epi8
+#endif
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+//! AdaptiveRadixMap is a sorted associative container that contains key-value pairs with unique byte-sized keys, meant to hold the children of the nodes of a Trie (e.g. Trie<char, T, AdaptiveRadixMap<char>>). Keys are sorted as by std::less<Key>. Search, removal, and insertion operations have constant complexity.
+//! The elements are stored in one of four layouts chosen by their number, as the inner nodes of an adaptive radix tree: up to 4 sorted keys and values held inside the container itself, so that small nodes need no allocation, up to 16 sorted keys and values searched with SIMD comparisons, up to 48 values reached through a 256-entry index, or 256 values indexed directly by key. The container grows into the next layout when it is full and shrinks into the previous one when it falls well below its capacity.
+//! Key must be an integral or enumeration type of one byte, and T must be trivially copyable and trivially default constructible (e.g. a pointer). Any insertion or removal invalidates the iterators.
+template <class Key, class T = void*, class Allocator = std::allocator<std::pair<const Key, T>>> class AdaptiveRadixMap{
+	private:
+		static_assert(sizeof(Key) == 1 && (std::is_integral_v<Key> || std::is_enum_v<Key>), "AdaptiveRadixMap requires integral or enumeration keys of one byte");
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>, "AdaptiveRadixMap requires trivially copyable and trivially default constructible mapped values");
+		struct Node16;
+		struct Node48;
+		struct Node256;
+		struct iterator_actions;
+		template <class Pair> struct arrow;
+		// Rebind Allocator
+		using AllocatorNode16 = typename std::allocator_traits<Allocator>::rebind_alloc<Node16>;
+		using AllocatorNode48 = typename std::allocator_traits<Allocator>::rebind_alloc<Node48>;
+		using AllocatorNode256 = typename std::allocator_traits<Allocator>::rebind_alloc<Node256>;
+		// Layouts with their capacities, and the sizes at which a layout shrinks into the previous one, kept under the capacity of that one so that alternating insertions and removals do not reallocate every time
+		enum Layout : uint8_t{ Inline4, Sorted16, Indexed48, Direct256 };
+		static constexpr uint16_t capacity_inline = 4, capacity_sorted = 16, capacity_indexed = 48;
+		static constexpr uint16_t shrink_sorted = 3, shrink_indexed = 12, shrink_direct = 40;
+		// Position of end(), past every slot and byte
+		static constexpr uint16_t end_position = 256;
+		// Keys are stored as bytes ordered as the keys (signed keys are offset by 0x80)
+		using underlying_key = typename std::conditional_t<std::is_enum_v<Key>, std::underlying_type<Key>, std::type_identity<Key>>::type;
+		static constexpr unsigned char sign_offset = std::is_signed_v<underlying_key> ? 0x80 : 0x00;
+	public:
+		// Declares member types
+		//! Type of the keys for the key-value pairs.
+		using key_type = Key;
+		//! Type of the mapped values for the key-value pairs.
+		using mapped_type = T;
+		//! Type of the values stored in the map.
+		using value_type = std::pair<const Key, T>;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences (unused).
+		using difference_type = std::ptrdiff_t;
+		//! Type of compare used in key comparison.
+		using key_compare = std::less<Key>;
+		//! Type of allocator used.
+		using allocator_type = Allocator;
+		//! Type of references to values, which pair the key with a reference to the mapped value.
+		using reference = std::pair<const Key, T&>;
+		//! Type of constant references to values, which pair the key with a constant reference to the mapped value.
+		using const_reference = std::pair<const Key, const T&>;
+		//! Type of the storage used by each element (its key byte and mapped value).
+		using node_type = std::pair<uint8_t, T>;
+		
+		//! Constructs an empty container.
+		AdaptiveRadixMap();
+		//! Constructs an empty container. Receives the allocator to use for all memory allocations.
+		explicit AdaptiveRadixMap(const Allocator& alloc);
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, the first one is inserted. Receives the allocator to use for all memory allocations.
+		template <class InputIt> AdaptiveRadixMap(InputIt first, InputIt last, const Allocator& alloc = Allocator());
+		//! Copy constructor. Constructs the container with the copy of the contents of other.
+		AdaptiveRadixMap(const AdaptiveRadixMap& other);
+		//! Move constructor. Constructs the container with the contents of other using move semantics. After the move, other is guaranteed to be empty().
+		AdaptiveRadixMap(AdaptiveRadixMap&& other) noexcept;
+		//! Constructs the container with the contents of the initializer list init. If multiple elements in the range have keys that compare equivalent, the first one is inserted. Can receive the allocator to use for all memory allocations.
+		AdaptiveRadixMap(std::initializer_list<value_type> init, const Allocator& alloc = Allocator());
+		
+		//! Destructs the map. The used storage is deallocated. Note, that if the elements are pointers, the pointed-to objects are not destroyed.
+		~AdaptiveRadixMap();
+		
+		// Assignment
+		//! Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		AdaptiveRadixMap& operator=(const AdaptiveRadixMap& other);
+		//! Move assignment operator. Replaces the contents with those of other using move semantics. After the move, other is guaranteed to be empty().
+		AdaptiveRadixMap& operator=(AdaptiveRadixMap&& other) noexcept;
+		
+		// Get allocator
+		//! Returns the allocator associated with the container.
+		Allocator get_allocator() const noexcept;
+		
+		// Element access
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		T& at(const Key& key);
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		const T& at(const Key& key) const;
+		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion of a value-initialized T if such key does not already exist.
+		T& operator[](const Key& key);
+		
+		// Iterators
+		//! iterator is an object that allows iteration of the container in the order of the sorted keys. Dereferencing it yields the key paired with a reference to the mapped value.
+		struct iterator : public iterator_actions{
+			using iterator_actions::iterator_actions;
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::ptrdiff_t;
+			//! Type of the proxy returned by operator->().
+			using pointer = arrow<std::pair<const Key, T&>>;
+			//! Type of references to values.
+			using reference = std::pair<const Key, T&>;
+			//! Returns the key paired with a reference to the mapped value pointed at by the iterator.
+			std::pair<const Key, T&> operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			arrow<std::pair<const Key, T&>> operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. Regressing end() points at the last element.
+			iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. Regressing end() points at the last element.
+			iterator operator--(int);
+		};
+		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only.
+		struct const_iterator : public iterator_actions{
+			using iterator_actions::iterator_actions;
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::ptrdiff_t;
+			//! Type of the proxy returned by operator->().
+			using pointer = arrow<std::pair<const Key, const T&>>;
+			//! Type of references to values.
+			using reference = std::pair<const Key, const T&>;
+			//! Constructs a constant iterator pointing at the same element as other.
+			const_iterator(const iterator& other);
+			//! Returns the key paired with a constant reference to the mapped value pointed at by the iterator.
+			std::pair<const Key, const T&> operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			arrow<std::pair<const Key, const T&>> operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. Regressing end() points at the last element.
+			const_iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. Regressing end() points at the last element.
+			const_iterator operator--(int);
+		};
+		//! reverse_iterator is an object that allows iteration of the container in the inverse order of the sorted keys.
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		//! const_reverse_iterator is an object that allows iteration of the container in the inverse order of the sorted keys for access only.
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		iterator begin() noexcept;
+		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator begin() const noexcept;
+		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator cbegin() const noexcept;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		iterator end() noexcept;
+		//! Returns a constant iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator end() const noexcept;
+		//! Returns a constant iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator cend() const noexcept;
+		//! Returns a reverse iterator to the first element of the reversed map. It corresponds to the last element of the non-reversed map. If the map is empty, the returned iterator is equal to rend().
+		reverse_iterator rbegin() noexcept;
+		//! Returns a constant reverse iterator to the first element of the reversed map. It corresponds to the last element of the non-reversed map. If the map is empty, the returned iterator is equal to rend().
+		const_reverse_iterator rbegin() const noexcept;
+		//! Returns a reverse iterator to the element following the last element of the reversed map. This element acts as a placeholder, attempting to access it results in undefined behavior.
+		reverse_iterator rend() noexcept;
+		//! Returns a constant reverse iterator to the element following the last element of the reversed map. This element acts as a placeholder, attempting to access it results in undefined behavior.
+		const_reverse_iterator rend() const noexcept;
+		
+		// Capacity
+		//! Checks if the container has no elements, i.e. whether begin() == end().
+		bool empty() const noexcept;
+		//! Returns the number of elements in the container.
+		std::size_t size() const noexcept;
+		//! Returns the maximum number of elements the container is able to hold, one per key.
+		std::size_t max_size() const noexcept;
+		//! Returns the total space in memory, including the container itself.
+		std::size_t memory() const noexcept;
+		
+		// Modifiers
+		// Clear
+		//! Erases all elements from the container. After this call, size() returns zero.
+		void clear() noexcept;
+		// Insert
+		//! Inserts value into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
+		std::pair<iterator, bool> insert(const value_type& value);
+		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, the first one is inserted.
+		template <class InputIt> void insert(InputIt first, InputIt last);
+		// Insert or Assign
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		template <class M> std::pair<iterator, bool> insert_or_assign(const Key& k, M&& obj);
+		// Erase
+		//! Removes element at pos from the container. Returns iterator following the removed element.
+		iterator erase(const_iterator pos);
+		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
+		std::size_t erase(const Key& key);
+		// Swap
+		//! Exchanges the contents of the container with those of other.
+		void swap(AdaptiveRadixMap& other) noexcept;
+		
+		// Lookup
+		// Count
+		//! Returns the number of elements with key that compares equivalent to the specified key, which is either 1 or 0 since this container does not allow duplicates.
+		std::size_t count(const Key& key) const;
+		// Find
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned.
+		iterator find(const Key& key);
+		//! Finds an element with key equivalent to key and returns a constant iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned.
+		const_iterator find(const Key& key) const;
+		// Contains
+		//! Checks if there is an element with key that compares equivalent to the value of key.
+		bool contains(const Key& key) const;
+		// Bounds
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		iterator lower_bound(const Key& key);
+		//! Returns a constant iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		const_iterator lower_bound(const Key& key) const;
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		iterator upper_bound(const Key& key);
+		//! Returns a constant iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		const_iterator upper_bound(const Key& key) const;
+		
+		// Observers
+		//! Returns the function object that compares the keys.
+		key_compare key_comp() const;
+		
+		// Non-member
+		// Operators
+		//! Checks if the contents of lhs and rhs are equal, that is, they have the same number of elements and each element in lhs compares equal with the element in rhs at the same position.
+		template <class A, class B, class C> friend bool operator==(const AdaptiveRadixMap<A,B,C>& lhs, const AdaptiveRadixMap<A,B,C>& rhs);
+		
+	private:
+		// Heap layouts, the inline one lives in the container
+		struct Node16{
+			unsigned char keys[capacity_sorted];
+			T values[capacity_sorted];
+		};
+		struct Node48{
+			uint64_t present[4];
+			uint64_t used;
+			unsigned char slots[256];
+			T values[capacity_indexed];
+		};
+		struct Node256{
+			uint64_t present[4];
+			T values[256];
+		};
+		// Proxy returned by the operator->() of the iterators, which holds the pair it points to
+		template <class Pair> struct arrow{
+			Pair value;
+			Pair* operator->();
+		};
+		[[no_unique_address]] Allocator alloc;
+		unsigned char keys[capacity_inline];
+		uint16_t counter;
+		Layout layout;
+		union{
+			T values[capacity_inline];
+			Node16* node16;
+			Node48* node48;
+			Node256* node256;
+		};
+		inline static unsigned char byte(const Key& key);
+		inline static Key key_of(unsigned char byte);
+		inline bool sorted() const;
+		inline unsigned char* sorted_keys() const;
+		inline T* sorted_values() const;
+		inline const uint64_t* present() const;
+		inline uint16_t search(unsigned char byte) const;
+		inline uint16_t bound(unsigned char byte, bool upper) const;
+		inline uint16_t next_present(unsigned bit) const;
+		inline uint16_t previous_present(unsigned bit) const;
+		inline unsigned char key_at(uint16_t position) const;
+		inline T& value_at(uint16_t position) const;
+		inline std::pair<uint16_t, bool> emplace(unsigned char byte);
+		inline void remove(unsigned char byte);
+		inline void grow();
+		inline void shrink();
+		inline void release() noexcept;
+		inline void assign(const AdaptiveRadixMap& other);
+		inline void steal(AdaptiveRadixMap& other) noexcept;
+		// Iterator base structure
+		struct iterator_actions{
+			friend class AdaptiveRadixMap<Key,T,Allocator>;
+			iterator_actions(const AdaptiveRadixMap* container = 0, uint16_t position = end_position);
+			bool operator==(const iterator_actions& other) const;
+			bool operator!=(const iterator_actions& other) const;
+			protected:
+				const AdaptiveRadixMap* container;
+				uint16_t position;
+				inline void next_element();
+				inline void previous_element();
+		};
+};
+
+		}
+	}
+}
+
+#include "AdaptiveRadixMap.cpp"
+
+#endif
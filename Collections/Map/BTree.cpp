@@ -0,0 +1,1008 @@
+#ifndef BPP_COLLECTIONS_MAP_BTREE_CPP
+#define BPP_COLLECTIONS_MAP_BTREE_CPP
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+// Empty initialization
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree() :
+	root(0),
+	head(0),
+	tail(0),
+	counter(0),
+	leaves(0),
+	inners(0){ }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(const Compare& comp, const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	cmp(comp),
+	root(0),
+	head(0),
+	tail(0),
+	counter(0),
+	leaves(0),
+	inners(0){ }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	root(0),
+	head(0),
+	tail(0),
+	counter(0),
+	leaves(0),
+	inners(0){ }
+
+// Iterator initilization
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class InputIt> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(InputIt first, InputIt last, const Compare& comp, const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	cmp(comp),
+	root(0),
+	head(0),
+	tail(0),
+	counter(0),
+	leaves(0),
+	inners(0){
+	if(this->build_sorted(first, last)){ return; }
+	for(auto it = first; it != last; ++it){
+		this->emplace_unique(it->first, *it);
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class InputIt> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(InputIt first, InputIt last, const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	root(0),
+	head(0),
+	tail(0),
+	counter(0),
+	leaves(0),
+	inners(0){
+	if(this->build_sorted(first, last)){ return; }
+	for(auto it = first; it != last; ++it){
+		this->emplace_unique(it->first, *it);
+	}
+}
+
+// Copy constructor
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(const BTree& other) :
+	leafAlloc(std::allocator_traits<AllocatorLeaves>::select_on_container_copy_construction(other.leafAlloc)),
+	innerAlloc(std::allocator_traits<AllocatorInners>::select_on_container_copy_construction(other.innerAlloc)),
+	cmp(other.cmp),
+	root(0),
+	head(0),
+	tail(0),
+	counter(other.counter),
+	leaves(other.leaves),
+	inners(other.inners){
+	if(other.root){ this->root = this->copy(other.root, 0, this->tail); }
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(const BTree& other, const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	cmp(other.cmp),
+	root(0),
+	head(0),
+	tail(0),
+	counter(other.counter),
+	leaves(other.leaves),
+	inners(other.inners){
+	if(other.root){ this->root = this->copy(other.root, 0, this->tail); }
+}
+
+// Move constructor
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(BTree&& other) :
+	leafAlloc(std::move(other.leafAlloc)),
+	innerAlloc(std::move(other.innerAlloc)),
+	cmp(std::move(other.cmp)),
+	root(other.root),
+	head(other.head),
+	tail(other.tail),
+	counter(other.counter),
+	leaves(other.leaves),
+	inners(other.inners){
+	other.root = 0;
+	other.head = other.tail = 0;
+	other.counter = other.leaves = other.inners = 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(BTree&& other, const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	cmp(std::move(other.cmp)),
+	root(0),
+	head(0),
+	tail(0),
+	counter(other.counter),
+	leaves(other.leaves),
+	inners(other.inners){
+	if(this->leafAlloc == other.leafAlloc && this->innerAlloc == other.innerAlloc){
+		this->root = other.root;
+		this->head = other.head;
+		this->tail = other.tail;
+		other.root = 0;
+		other.head = other.tail = 0;
+		other.counter = other.leaves = other.inners = 0;
+	}else{
+		if(other.root){ this->root = this->copy(other.root, 0, this->tail); }
+		other.clear();
+	}
+}
+
+// Initializer list initialization
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp, const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	cmp(comp),
+	root(0),
+	head(0),
+	tail(0),
+	counter(0),
+	leaves(0),
+	inners(0){
+	if(this->build_sorted(ilist.begin(), ilist.end())){ return; }
+	for(auto& it : ilist){
+		this->emplace_unique(it.first, it);
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::BTree(std::initializer_list<std::pair<const Key, T>> ilist, const Allocator& alloc) :
+	leafAlloc(alloc),
+	innerAlloc(alloc),
+	root(0),
+	head(0),
+	tail(0),
+	counter(0),
+	leaves(0),
+	inners(0){
+	if(this->build_sorted(ilist.begin(), ilist.end())){ return; }
+	for(auto& it : ilist){
+		this->emplace_unique(it.first, it);
+	}
+}
+
+// Destructor
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::~BTree(){
+	if(this->root){ this->destroy_nodes(); }
+}
+
+// Assignment
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>& BTree<Key,T,Compare,Allocator,NodeSize>::operator=(const BTree& other){
+	this->sp_copy(other, typename std::allocator_traits<Allocator>::propagate_on_container_copy_assignment());
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>& BTree<Key,T,Compare,Allocator,NodeSize>::operator=(BTree&& other){
+	this->sp_move(std::move(other), typename std::allocator_traits<Allocator>::propagate_on_container_move_assignment());
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>& BTree<Key,T,Compare,Allocator,NodeSize>::operator=(std::initializer_list<std::pair<const Key, T>> ilist){
+	this->clear();
+	if(this->build_sorted(ilist.begin(), ilist.end())){ return *this; }
+	for(auto& it : ilist){
+		this->emplace_unique(it.first, it);
+	}
+	return *this;
+}
+
+// Get allocator
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> Allocator BTree<Key,T,Compare,Allocator,NodeSize>::get_allocator() const noexcept{
+	return Allocator(this->leafAlloc);
+}
+
+// Element access
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> const T& BTree<Key,T,Compare,Allocator,NodeSize>::at(const Key& key) const{
+	auto pos = this->locate(key);
+	if(!pos.first){ throw std::out_of_range("bpp::collections::map::BTree::at"); }
+	return pos.first->values()[pos.second].second;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> T& BTree<Key,T,Compare,Allocator,NodeSize>::operator[](const Key& key){
+	return this->emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> T& BTree<Key,T,Compare,Allocator,NodeSize>::operator[](Key&& key){
+	return this->emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::tuple<>()).first->second;
+}
+
+// Iterators
+// Iterator
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<const Key, T>& BTree<Key,T,Compare,Allocator,NodeSize>::iterator::operator*() const{
+	return this->current ? this->current->values()[this->index] : this->nullvalue;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<const Key, T>* BTree<Key,T,Compare,Allocator,NodeSize>::iterator::operator->() const{
+	return this->current ? this->current->values() + this->index : 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator& BTree<Key,T,Compare,Allocator,NodeSize>::iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::iterator::operator++(int){
+	iterator pit{{this->current, this->index}};
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator& BTree<Key,T,Compare,Allocator,NodeSize>::iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::iterator::operator--(int){
+	iterator pit{{this->current, this->index}};
+	this->previous_element();
+	return pit;
+}
+// Constant Iterator
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> const std::pair<const Key, T>& BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator::operator*() const{
+	return this->current ? this->current->values()[this->index] : this->nullvalue;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> const std::pair<const Key, T>* BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator::operator->() const{
+	return this->current ? this->current->values() + this->index : 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator& BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator::operator++(int){
+	const_iterator pit{{this->current, this->index}};
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator& BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator::operator--(int){
+	const_iterator pit{{this->current, this->index}};
+	this->previous_element();
+	return pit;
+}
+// Reverse Iterator
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> constexpr BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator::base() const{ return iterator{{this->current, this->index}}; }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<const Key, T>& BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator::operator*() const{
+	return this->current ? this->current->values()[this->index] : this->nullvalue;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<const Key, T>* BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator::operator->() const{
+	return this->current ? this->current->values() + this->index : 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator& BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator::operator++(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator::operator++(int){
+	reverse_iterator pit{{this->current, this->index}};
+	this->previous_element();
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator& BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator::operator--(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator::operator--(int){
+	reverse_iterator pit{{this->current, this->index}};
+	this->next_element();
+	return pit;
+}
+// Constant Reverse Iterator
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> constexpr BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator::base() const{ return const_iterator{{this->current, this->index}}; }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> const std::pair<const Key, T>& BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator::operator*() const{
+	return this->current ? this->current->values()[this->index] : this->nullvalue;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> const std::pair<const Key, T>* BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator::operator->() const{
+	return this->current ? this->current->values() + this->index : 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator& BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator::operator++(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator::operator++(int){
+	const_reverse_iterator pit{{this->current, this->index}};
+	this->previous_element();
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator& BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator::operator--(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator::operator--(int){
+	const_reverse_iterator pit{{this->current, this->index}};
+	this->next_element();
+	return pit;
+}
+
+// Iterator generation methods
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::begin() noexcept{
+	return iterator(this->head);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::begin() const noexcept{
+	return const_iterator(this->head);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::cbegin() const noexcept{
+	return const_iterator(this->head);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::end() noexcept{
+	return iterator();
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::end() const noexcept{
+	return const_iterator();
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::cend() const noexcept{
+	return const_iterator();
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::rbegin() noexcept{
+	return reverse_iterator{{this->tail, this->tail ? this->tail->size - 1 : 0}};
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::rbegin() const noexcept{
+	return const_reverse_iterator{{this->tail, this->tail ? this->tail->size - 1 : 0}};
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::crbegin() const noexcept{
+	return const_reverse_iterator{{this->tail, this->tail ? this->tail->size - 1 : 0}};
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::rend() noexcept{
+	return reverse_iterator();
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::rend() const noexcept{
+	return const_reverse_iterator();
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::const_reverse_iterator BTree<Key,T,Compare,Allocator,NodeSize>::crend() const noexcept{
+	return const_reverse_iterator();
+}
+
+// Capacity
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> bool BTree<Key,T,Compare,Allocator,NodeSize>::empty() const noexcept{
+	return this->counter == 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::size_t BTree<Key,T,Compare,Allocator,NodeSize>::size() const noexcept{
+	return this->counter;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::size_t BTree<Key,T,Compare,Allocator,NodeSize>::memory() const noexcept{
+	return sizeof(BTree) + this->leaves*sizeof(LeafNode) + this->inners*sizeof(InnerNode);
+}
+
+// Modifiers
+// Clear
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::clear() noexcept{
+	if(this->root){
+		this->destroy_nodes();
+		this->root = 0;
+		this->head = this->tail = 0;
+		this->counter = this->leaves = this->inners = 0;
+	}
+}
+// Insert
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, bool> BTree<Key,T,Compare,Allocator,NodeSize>::insert(const std::pair<const Key, T>& value){
+	return this->emplace_unique(value.first, value);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, bool> BTree<Key,T,Compare,Allocator,NodeSize>::insert(std::pair<const Key, T>&& value){
+	return this->emplace_unique(value.first, std::move(value));
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::insert(iterator hint, const std::pair<const Key, T>& value){
+	if(!hint.current && this->tail && this->cmp(this->tail->values()[this->tail->size - 1].first, value.first)){ return this->emplace_back(value); }
+	return this->emplace_unique(value.first, value).first;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::insert(iterator hint, std::pair<const Key, T>&& value){
+	if(!hint.current && this->tail && this->cmp(this->tail->values()[this->tail->size - 1].first, value.first)){ return this->emplace_back(std::move(value)); }
+	return this->emplace_unique(value.first, std::move(value)).first;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class InputIt> void BTree<Key,T,Compare,Allocator,NodeSize>::insert(InputIt first, InputIt last){
+	if(!this->counter && this->build_sorted(first, last)){ return; }
+	for(auto it = first; it != last; ++it){
+		this->emplace_unique(it->first, *it);
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::insert(std::initializer_list<std::pair<const Key, T>> ilist){
+	if(!this->counter && this->build_sorted(ilist.begin(), ilist.end())){ return; }
+	for(auto& it : ilist){
+		this->emplace_unique(it.first, it);
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class InputIt> void BTree<Key,T,Compare,Allocator,NodeSize>::assign_sorted(InputIt first, InputIt last){
+	this->clear();
+	for(auto it = first; it != last; ++it){
+		this->emplace_back(*it);
+	}
+}
+// Insert or Assign
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class M> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, bool> BTree<Key,T,Compare,Allocator,NodeSize>::insert_or_assign(const Key& k, M&& obj){
+	std::pair<iterator, bool> result = this->emplace_unique(k, k, std::forward<M>(obj));
+	if(!result.second){ result.first->second = std::forward<M>(obj); }
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class M> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, bool> BTree<Key,T,Compare,Allocator,NodeSize>::insert_or_assign(Key&& k, M&& obj){
+	std::pair<iterator, bool> result = this->emplace_unique(k, std::move(k), std::forward<M>(obj));
+	if(!result.second){ result.first->second = std::forward<M>(obj); }
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class M> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, bool> BTree<Key,T,Compare,Allocator,NodeSize>::insert_or_assign(iterator hint, const Key& k, M&& obj){
+	if(!hint.current && this->tail && this->cmp(this->tail->values()[this->tail->size - 1].first, k)){ return std::pair<iterator, bool>(this->emplace_back(k, std::forward<M>(obj)), true); }
+	return this->insert_or_assign(k, std::forward<M>(obj));
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class M> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, bool> BTree<Key,T,Compare,Allocator,NodeSize>::insert_or_assign(iterator hint, Key&& k, M&& obj){
+	if(!hint.current && this->tail && this->cmp(this->tail->values()[this->tail->size - 1].first, k)){ return std::pair<iterator, bool>(this->emplace_back(std::move(k), std::forward<M>(obj)), true); }
+	return this->insert_or_assign(std::move(k), std::forward<M>(obj));
+}
+// Erase
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::erase(iterator pos){
+	return this->erase_at(pos.current, pos.index);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::erase(const_iterator pos){
+	return this->erase_at(pos.current, pos.index);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::erase(iterator first, iterator last){
+	// Removals move elements between leaves, so the range is measured before erasing
+	std::size_t n = 0;
+	for(iterator it = first; it != last; ++it){ ++n; }
+	while(n--){ first = this->erase_at(first.current, first.index); }
+	return first;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::erase(const_iterator first, const_iterator last){
+	std::size_t n = 0;
+	iterator it{{first.current, first.index}};
+	for(const_iterator cit = first; cit != last; ++cit){ ++n; }
+	while(n--){ it = this->erase_at(it.current, it.index); }
+	return it;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::size_t BTree<Key,T,Compare,Allocator,NodeSize>::erase(const Key& key){
+	auto pos = this->locate(key);
+	if(!pos.first){ return 0; }
+	this->erase_at(pos.first, pos.second);
+	return 1;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> std::size_t BTree<Key,T,Compare,Allocator,NodeSize>::erase(K&& key){
+	auto pos = this->locate(key);
+	if(!pos.first){ return 0; }
+	this->erase_at(pos.first, pos.second);
+	return 1;
+}
+
+// Lookup
+// Count
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> std::size_t BTree<Key,T,Compare,Allocator,NodeSize>::count(const K& key) const{
+	return this->locate(key).first ? 1 : 0;
+}
+// Find
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::find(const K& key){
+	auto pos = this->locate(key);
+	return iterator{{pos.first, pos.second}};
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::find(const K& key) const{
+	auto pos = this->locate(key);
+	return const_iterator{{pos.first, pos.second}};
+}
+
+// Contains
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> bool BTree<Key,T,Compare,Allocator,NodeSize>::contains(const K& key) const{
+	return this->locate(key).first;
+}
+
+// Bounds
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::lower_bound(const K& key){
+	LeafNode* leaf = this->find_leaf(key);
+	iterator it{{leaf, leaf ? this->leaf_lower(leaf, key) : 0}};
+	if(leaf && it.index == leaf->size){
+		it.current = leaf->next;
+		it.index = 0;
+	}
+	return it;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::lower_bound(const K& key) const{
+	LeafNode* leaf = this->find_leaf(key);
+	const_iterator it{{leaf, leaf ? this->leaf_lower(leaf, key) : 0}};
+	if(leaf && it.index == leaf->size){
+		it.current = leaf->next;
+		it.index = 0;
+	}
+	return it;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::upper_bound(const K& key){
+	iterator it = this->lower_bound(key);
+	if(it.current && !this->cmp(key, it.current->values()[it.index].first)){ ++it; }
+	return it;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator BTree<Key,T,Compare,Allocator,NodeSize>::upper_bound(const K& key) const{
+	const_iterator it = this->lower_bound(key);
+	if(it.current && !this->cmp(key, it.current->values()[it.index].first)){ ++it; }
+	return it;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator> BTree<Key,T,Compare,Allocator,NodeSize>::equal_range(const K& key){
+	return std::pair<iterator,iterator>(this->lower_bound(key), this->upper_bound(key));
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator,typename BTree<Key,T,Compare,Allocator,NodeSize>::const_iterator> BTree<Key,T,Compare,Allocator,NodeSize>::equal_range(const K& key) const{
+	return std::pair<const_iterator,const_iterator>(this->lower_bound(key), this->upper_bound(key));
+}
+
+// Non-member functions
+// Operators
+template <class A, class B, class C, class D, std::size_t E> bool operator==(const BTree<A,B,C,D,E>& lhs, const BTree<A,B,C,D,E>& rhs){
+	bool result;
+	if(result = (lhs.size() == rhs.size())){
+		auto it = lhs.begin(), ito = rhs.begin(), ite = lhs.end();
+		while(it != ite){
+			if((*it) != (*ito)){ return false; }
+			++it;
+			++ito;
+		}
+	}
+	return result;
+}
+template <class A, class B, class C, class D, std::size_t E> std::strong_ordering operator<=>(const BTree<A,B,C,D,E>& lhs, const BTree<A,B,C,D,E>& rhs){
+	auto it = lhs.begin(), ito = rhs.begin(), ite = lhs.end(), itoe = rhs.end();
+	while(it != ite && ito != itoe){
+		if((*it) != (*ito)){ break; }
+		++it;
+		++ito;
+	}
+	if(it == ite && ito == itoe){ return std::strong_ordering::equal; }
+	if(it == ite){ return std::strong_ordering::less; }
+	if(ito == itoe || (*ito) < (*it)){ return std::strong_ordering::greater; }
+	return std::strong_ordering::less;
+}
+
+// Nested structures NodeBase, LeafNode and InnerNode
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::NodeBase::NodeBase(bool leaf) :
+	parent(0),
+	size(0),
+	leaf(leaf){ }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::LeafNode::LeafNode() :
+	NodeBase(true),
+	prev(0),
+	next(0){ }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::LeafNode::~LeafNode(){
+	std::destroy(this->values(), this->values() + this->size);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<const Key, T>* BTree<Key,T,Compare,Allocator,NodeSize>::LeafNode::values(){
+	return std::launder(reinterpret_cast<std::pair<const Key, T>*>(this->storage));
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::LeafNode::relocate(std::pair<const Key, T>* src, std::size_t n, std::pair<const Key, T>* dst){
+	// Moves n elements to a possibly overlapping destination, trivially copyable elements are moved as raw bytes
+	if constexpr(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>){
+		std::memmove((void*) dst, (const void*) src, n * sizeof(std::pair<const Key, T>));
+	}else if(dst < src){
+		for(std::size_t i = 0; i < n; ++i){
+			std::construct_at(dst + i, std::move(src[i]));
+			std::destroy_at(src + i);
+		}
+	}else{
+		for(std::size_t i = n; i--; ){
+			std::construct_at(dst + i, std::move(src[i]));
+			std::destroy_at(src + i);
+		}
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::InnerNode::InnerNode() :
+	NodeBase(false){ }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::InnerNode::insert(std::size_t pos, const Key& key, NodeBase* child){
+	for(std::size_t i = this->size; i > pos; --i){
+		this->keys[i] = std::move(this->keys[i - 1]);
+		this->children[i + 1] = this->children[i];
+	}
+	this->keys[pos] = key;
+	this->children[pos + 1] = child;
+	child->parent = this;
+	++this->size;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::size_t BTree<Key,T,Compare,Allocator,NodeSize>::InnerNode::index_of(NodeBase* child) const{
+	std::size_t i = 0;
+	while(this->children[i] != child){ ++i; }
+	return i;
+}
+
+// Private members
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> BTree<Key,T,Compare,Allocator,NodeSize>::LeafNode* BTree<Key,T,Compare,Allocator,NodeSize>::find_leaf(const K& key) const{
+	// Descends to the child following the last separator that compares not greater than key
+	NodeBase* node = this->root;
+	while(node && !node->leaf){
+		InnerNode* inner = (InnerNode*) node;
+		std::size_t lo = 0, hi = inner->size;
+		while(lo < hi){
+			std::size_t mid = (lo + hi) >> 1;
+			if(this->cmp(key, inner->keys[mid])){ hi = mid; }else{ lo = mid + 1; }
+		}
+		node = inner->children[lo];
+	}
+	return (LeafNode*) node;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> std::size_t BTree<Key,T,Compare,Allocator,NodeSize>::leaf_lower(LeafNode* leaf, const K& key) const{
+	std::pair<const Key, T>* values = leaf->values();
+	std::size_t lo = 0, hi = leaf->size;
+	while(lo < hi){
+		std::size_t mid = (lo + hi) >> 1;
+		if(this->cmp(values[mid].first, key)){ lo = mid + 1; }else{ hi = mid; }
+	}
+	return lo;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::LeafNode*, std::size_t> BTree<Key,T,Compare,Allocator,NodeSize>::locate(const K& key) const{
+	LeafNode* leaf = this->find_leaf(key);
+	std::size_t pos = leaf ? this->leaf_lower(leaf, key) : 0;
+	if(!leaf || pos == leaf->size || this->cmp(key, leaf->values()[pos].first)){ return std::pair<LeafNode*, std::size_t>(0, 0); }
+	return std::pair<LeafNode*, std::size_t>(leaf, pos);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class K, class... Args> std::pair<typename BTree<Key,T,Compare,Allocator,NodeSize>::iterator, bool> BTree<Key,T,Compare,Allocator,NodeSize>::emplace_unique(const K& key, Args&&... args){
+	LeafNode* leaf = this->find_leaf(key);
+	std::size_t pos;
+	if(!leaf){ return std::pair<iterator, bool>(this->emplace_back(std::forward<Args>(args)...), true); }
+	pos = this->leaf_lower(leaf, key);
+	if(pos < leaf->size && !this->cmp(key, leaf->values()[pos].first)){ return std::pair<iterator, bool>(iterator{{leaf, pos}}, false); }
+	return std::pair<iterator, bool>(this->emplace_at(leaf, pos, std::forward<Args>(args)...), true);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class... Args> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::emplace_at(LeafNode* leaf, std::size_t pos, Args&&... args){
+	// Full leaves are split in halves, unless the element is appended to the last leaf where the new leaf starts empty to keep sequential insertions compact
+	LeafNode* target = leaf;
+	if(leaf->size == leaf_slots){
+		LeafNode* right = this->new_leaf();
+		std::size_t keep = (pos == leaf_slots && !leaf->next) ? leaf_slots : (leaf_slots + 1) >> 1;
+		LeafNode::relocate(leaf->values() + keep, leaf_slots - keep, right->values());
+		right->size = leaf_slots - keep;
+		leaf->size = keep;
+		right->prev = leaf;
+		right->next = leaf->next;
+		if(leaf->next){ leaf->next->prev = right; }else{ this->tail = right; }
+		leaf->next = right;
+		if(pos > keep || keep == leaf_slots){
+			target = right;
+			pos -= keep;
+		}
+		LeafNode::relocate(target->values() + pos, target->size - pos, target->values() + pos + 1);
+		std::construct_at(target->values() + pos, std::forward<Args>(args)...);
+		++target->size;
+		++this->counter;
+		this->insert_parent(leaf, right->values()[0].first, right);
+		return iterator{{target, pos}};
+	}
+	LeafNode::relocate(target->values() + pos, target->size - pos, target->values() + pos + 1);
+	std::construct_at(target->values() + pos, std::forward<Args>(args)...);
+	++target->size;
+	++this->counter;
+	return iterator{{target, pos}};
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class... Args> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::emplace_back(Args&&... args){
+	if(!this->tail){
+		this->root = this->head = this->tail = this->new_leaf();
+	}
+	return this->emplace_at(this->tail, this->tail->size, std::forward<Args>(args)...);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::insert_parent(NodeBase* left, const Key& separator, NodeBase* right){
+	InnerNode *parent = left->parent, *target, *sibling;
+	std::size_t pos, mid;
+	if(!parent){
+		parent = this->new_inner();
+		parent->keys[0] = separator;
+		parent->children[0] = left;
+		parent->children[1] = right;
+		parent->size = 1;
+		left->parent = right->parent = parent;
+		this->root = parent;
+		return;
+	}
+	pos = parent->index_of(left);
+	if(parent->size < inner_slots){
+		parent->insert(pos, separator, right);
+		return;
+	}
+	// The middle separator moves up, when appending at the end the left node is kept full
+	sibling = this->new_inner();
+	mid = (pos == inner_slots) ? inner_slots - 1 : inner_slots >> 1;
+	Key up = std::move(parent->keys[mid]);
+	sibling->size = inner_slots - mid - 1;
+	for(std::size_t i = 0; i < sibling->size; ++i){ sibling->keys[i] = std::move(parent->keys[mid + 1 + i]); }
+	for(std::size_t i = 0; i <= sibling->size; ++i){
+		sibling->children[i] = parent->children[mid + 1 + i];
+		sibling->children[i]->parent = sibling;
+	}
+	parent->size = mid;
+	target = (pos > mid) ? sibling : parent;
+	target->insert(pos > mid ? pos - mid - 1 : pos, separator, right);
+	this->insert_parent(parent, up, sibling);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator BTree<Key,T,Compare,Allocator,NodeSize>::erase_at(LeafNode* leaf, std::size_t pos){
+	// Underfull leaves borrow an element from a sibling with spare elements, or are merged with one
+	InnerNode* parent = leaf->parent;
+	LeafNode *left, *right;
+	std::size_t idx;
+	std::destroy_at(leaf->values() + pos);
+	LeafNode::relocate(leaf->values() + pos + 1, leaf->size - pos - 1, leaf->values() + pos);
+	--leaf->size;
+	--this->counter;
+	if(!parent){
+		if(!leaf->size){
+			this->delete_leaf(leaf);
+			this->root = 0;
+			this->head = this->tail = 0;
+			return iterator();
+		}
+	}else if(leaf->size < (leaf_slots >> 1)){
+		idx = parent->index_of(leaf);
+		left = idx ? (LeafNode*) parent->children[idx - 1] : 0;
+		right = idx < parent->size ? (LeafNode*) parent->children[idx + 1] : 0;
+		if(left && left->size > (leaf_slots >> 1)){
+			LeafNode::relocate(leaf->values(), leaf->size, leaf->values() + 1);
+			LeafNode::relocate(left->values() + left->size - 1, 1, leaf->values());
+			--left->size;
+			++leaf->size;
+			++pos;
+			parent->keys[idx - 1] = leaf->values()[0].first;
+		}else if(right && right->size > (leaf_slots >> 1)){
+			LeafNode::relocate(right->values(), 1, leaf->values() + leaf->size);
+			LeafNode::relocate(right->values() + 1, right->size - 1, right->values());
+			--right->size;
+			++leaf->size;
+			parent->keys[idx] = right->values()[0].first;
+		}else if(left){
+			LeafNode::relocate(leaf->values(), leaf->size, left->values() + left->size);
+			pos += left->size;
+			left->size += leaf->size;
+			leaf->size = 0;
+			left->next = leaf->next;
+			if(leaf->next){ leaf->next->prev = left; }else{ this->tail = left; }
+			this->delete_leaf(leaf);
+			leaf = left;
+			this->remove_inner(parent, idx - 1);
+		}else{
+			LeafNode::relocate(right->values(), right->size, leaf->values() + leaf->size);
+			leaf->size += right->size;
+			right->size = 0;
+			leaf->next = right->next;
+			if(right->next){ right->next->prev = leaf; }else{ this->tail = leaf; }
+			this->delete_leaf(right);
+			this->remove_inner(parent, idx);
+		}
+	}
+	if(pos == leaf->size){ return iterator(leaf->next); }
+	return iterator{{leaf, pos}};
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::remove_inner(InnerNode* node, std::size_t pos){
+	// Removes the separator at pos along with the child to its right, underfull nodes rotate through the parent or are merged
+	InnerNode *parent, *left, *right;
+	std::size_t idx;
+	for(std::size_t i = pos + 1; i < node->size; ++i){
+		node->keys[i - 1] = std::move(node->keys[i]);
+		node->children[i] = node->children[i + 1];
+	}
+	--node->size;
+	parent = node->parent;
+	if(!parent){
+		if(!node->size){
+			this->root = node->children[0];
+			this->root->parent = 0;
+			this->delete_inner(node);
+		}
+		return;
+	}
+	if(node->size >= (inner_slots >> 1)){ return; }
+	idx = parent->index_of(node);
+	left = idx ? (InnerNode*) parent->children[idx - 1] : 0;
+	right = idx < parent->size ? (InnerNode*) parent->children[idx + 1] : 0;
+	if(left && left->size > (inner_slots >> 1)){
+		for(std::size_t i = node->size; i > 0; --i){ node->keys[i] = std::move(node->keys[i - 1]); }
+		for(std::size_t i = node->size + 1; i > 0; --i){ node->children[i] = node->children[i - 1]; }
+		node->keys[0] = std::move(parent->keys[idx - 1]);
+		node->children[0] = left->children[left->size];
+		node->children[0]->parent = node;
+		parent->keys[idx - 1] = std::move(left->keys[left->size - 1]);
+		--left->size;
+		++node->size;
+	}else if(right && right->size > (inner_slots >> 1)){
+		node->keys[node->size] = std::move(parent->keys[idx]);
+		node->children[node->size + 1] = right->children[0];
+		node->children[node->size + 1]->parent = node;
+		++node->size;
+		parent->keys[idx] = std::move(right->keys[0]);
+		for(std::size_t i = 1; i < right->size; ++i){ right->keys[i - 1] = std::move(right->keys[i]); }
+		for(std::size_t i = 1; i <= right->size; ++i){ right->children[i - 1] = right->children[i]; }
+		--right->size;
+	}else{
+		if(!left){
+			left = node;
+			node = right;
+			++idx;
+		}
+		left->keys[left->size] = std::move(parent->keys[idx - 1]);
+		for(std::size_t i = 0; i < node->size; ++i){ left->keys[left->size + 1 + i] = std::move(node->keys[i]); }
+		for(std::size_t i = 0; i <= node->size; ++i){
+			left->children[left->size + 1 + i] = node->children[i];
+			node->children[i]->parent = left;
+		}
+		left->size += node->size + 1;
+		this->delete_inner(node);
+		this->remove_inner(parent, idx - 1);
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::LeafNode* BTree<Key,T,Compare,Allocator,NodeSize>::new_leaf(){
+	LeafNode* leaf = this->leafAlloc.allocate(1);
+	std::construct_at(leaf);
+	++this->leaves;
+	return leaf;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::InnerNode* BTree<Key,T,Compare,Allocator,NodeSize>::new_inner(){
+	InnerNode* inner = this->innerAlloc.allocate(1);
+	std::construct_at(inner);
+	++this->inners;
+	return inner;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::delete_leaf(LeafNode* leaf){
+	std::destroy_at(leaf);
+	this->leafAlloc.deallocate(leaf, 1);
+	--this->leaves;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::delete_inner(InnerNode* inner){
+	std::destroy_at(inner);
+	this->innerAlloc.deallocate(inner, 1);
+	--this->inners;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::destroy(NodeBase* node){
+	if(node->leaf){
+		this->delete_leaf((LeafNode*) node);
+	}else{
+		InnerNode* inner = (InnerNode*) node;
+		for(std::size_t i = 0; i <= inner->size; ++i){ this->destroy(inner->children[i]); }
+		this->delete_inner(inner);
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::destroy_nodes(){
+	// Arena allocators release all their chunks at once if this tree owns every node allocated on them
+	if constexpr(requires(AllocatorLeaves& a, AllocatorInners& b, std::size_t n){ { a.release(n) } -> std::same_as<bool>; { a == b } -> std::convertible_to<bool>; }){
+		// Both allocators are rebound from the same one, so leaves and inner nodes share the arena
+		if(std::is_trivially_destructible_v<std::pair<const Key,T>> && std::is_trivially_destructible_v<Key> && this->leafAlloc == this->innerAlloc && this->leafAlloc.release(this->leaves + this->inners)){ return; }
+	}
+	this->destroy(this->root);
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::NodeBase* BTree<Key,T,Compare,Allocator,NodeSize>::copy(const NodeBase* src, InnerNode* parent, LeafNode*& last){
+	// Copies the subtree in order so that the leaves can be linked as they are created
+	if(src->leaf){
+		LeafNode* leaf = this->leafAlloc.allocate(1);
+		const LeafNode* from = (const LeafNode*) src;
+		std::construct_at(leaf);
+		for(; leaf->size < from->size; ++leaf->size){
+			std::construct_at(leaf->values() + leaf->size, const_cast<LeafNode*>(from)->values()[leaf->size]);
+		}
+		leaf->parent = parent;
+		leaf->prev = last;
+		if(last){ last->next = leaf; }else{ this->head = leaf; }
+		last = leaf;
+		return leaf;
+	}
+	InnerNode* inner = this->innerAlloc.allocate(1);
+	const InnerNode* from = (const InnerNode*) src;
+	std::construct_at(inner);
+	inner->parent = parent;
+	inner->size = from->size;
+	for(std::size_t i = 0; i < from->size; ++i){ inner->keys[i] = from->keys[i]; }
+	for(std::size_t i = 0; i <= from->size; ++i){ inner->children[i] = this->copy(from->children[i], inner, last); }
+	return inner;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> template <class InputIt> bool BTree<Key,T,Compare,Allocator,NodeSize>::build_sorted(InputIt first, InputIt last){
+	if constexpr(std::forward_iterator<InputIt>){
+		InputIt it = first, prev = first;
+		if(it != last){
+			for(++it; it != last; prev = it, ++it){
+				if(!this->cmp(prev->first, it->first)){ return false; }
+			}
+		}
+		for(it = first; it != last; ++it){ this->emplace_back(*it); }
+		return true;
+	}
+	return false;
+}
+
+// Iterator actions
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions::iterator_actions(LeafNode* init, std::size_t index) :
+	current(init),
+	index(index){ }
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions::next_element(){
+	if(this->current && ++this->index == this->current->size){
+		this->current = this->current->next;
+		this->index = 0;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions::previous_element(){
+	if(this->current){
+		if(this->index){
+			--this->index;
+		}else{
+			this->current = this->current->prev;
+			this->index = this->current ? this->current->size - 1 : 0;
+		}
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> bool BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions::operator==(const BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions& other) const{
+	return this->current == other.current && this->index == other.index;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> bool BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions::operator!=(const BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions& other) const{
+	return this->current != other.current || this->index != other.index;
+}
+
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::pair<const Key, T> BTree<Key,T,Compare,Allocator,NodeSize>::iterator_actions::nullvalue;
+
+// Specialized copy/move calls
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::sp_copy(const BTree& other, std::true_type){
+	if(this == &other){ return; }
+	this->clear();
+	this->leafAlloc = other.leafAlloc;
+	this->innerAlloc = other.innerAlloc;
+	this->sp_copy(other, std::false_type());
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::sp_copy(const BTree& other, std::false_type){
+	if(this == &other){ return; }
+	this->clear();
+	this->cmp = other.cmp;
+	if(other.root){
+		this->root = this->copy(other.root, 0, this->tail);
+		this->counter = other.counter;
+		this->leaves = other.leaves;
+		this->inners = other.inners;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::sp_move(BTree&& other, std::true_type) noexcept{
+	if(this == &other){ return; }
+	this->clear();
+	this->leafAlloc = std::move(other.leafAlloc);
+	this->innerAlloc = std::move(other.innerAlloc);
+	this->cmp = std::move(other.cmp);
+	this->root = other.root;
+	this->head = other.head;
+	this->tail = other.tail;
+	this->counter = other.counter;
+	this->leaves = other.leaves;
+	this->inners = other.inners;
+	other.root = 0;
+	other.head = other.tail = 0;
+	other.counter = other.leaves = other.inners = 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::size_t NodeSize> void BTree<Key,T,Compare,Allocator,NodeSize>::sp_move(BTree&& other, std::false_type){
+	if(this->leafAlloc == other.leafAlloc && this->innerAlloc == other.innerAlloc){
+		this->sp_move(std::move(other), std::true_type());
+	}else{
+		this->sp_copy(other, std::false_type());
+		other.clear();
+	}
+}
+
+		}
+		namespace serialize{
+
+//! Specialization of the Serialize template to support BTree objects.
+template <typename Buff, class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::size_t Serialize<Buff,bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>>::operator()(Buff& buffer, const bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>& obj) const{
+	std::size_t objs = obj.size();
+	std::size_t res = serialize(buffer, objs);
+	for(auto it = obj.begin(); it != obj.end(); ++it){
+		res += serialize(buffer, *it);
+	}
+	return res;
+}
+template <typename Buff, class Key, class T, class Compare, class Allocator, std::size_t NodeSize> std::size_t Deserialize<Buff,bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>>::operator()(Buff& buffer, bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>& obj) const{
+	// The elements were written in order, so every element is appended to the last leaf
+	std::size_t objs;
+	std::size_t res = deserialize(buffer, objs);
+	obj.clear();
+	for(std::size_t i=0; i<objs; ++i){
+		std::pair<Key,T> value;
+		res += deserialize(buffer, value);
+		obj.emplace_back(std::move(value.first), std::move(value.second));
+	}
+	return res;
+}
+
+		}
+	}
+}
+
+// Non-member
+// Other
+template <class A, class B, class C, class D, std::size_t E, class Pred> std::size_t std::erase_if(bpp::collections::map::BTree<A,B,C,D,E>& tree, Pred pred){
+	auto original = tree.size();
+	for (auto i = tree.begin(), last = tree.end(); i != last; ){
+		if(pred(*i)){
+			i = tree.erase(i);
+		}else{
+			++i;
+		}
+	}
+	return original - tree.size();
+}
+template <class A, class B, class C, class D, std::size_t E> void std::swap(bpp::collections::map::BTree<A,B,C,D,E>& lhs, bpp::collections::map::BTree<A,B,C,D,E>& rhs){
+	std::swap(lhs.leafAlloc, rhs.leafAlloc);
+	std::swap(lhs.innerAlloc, rhs.innerAlloc);
+	std::swap(lhs.cmp, rhs.cmp);
+	std::swap(lhs.root, rhs.root);
+	std::swap(lhs.head, rhs.head);
+	std::swap(lhs.tail, rhs.tail);
+	std::swap(lhs.counter, rhs.counter);
+	std::swap(lhs.leaves, rhs.leaves);
+	std::swap(lhs.inners, rhs.inners);
+}
+
+#endif
@@ -0,0 +1,416 @@
+#ifndef BPP_COLLECTIONS_MAP_BTREE_H
+#define BPP_COLLECTIONS_MAP_BTREE_H
+#include <compare>			// std::strong_ordering
+#include <concepts>			// std::same_as
+#include <cstdint>			// uint8_t
+#include <cstring>			// std::memmove
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list<>
+#include <iterator>			// std::forward_iterator
+#include <memory>			// std::allocator<>, std::allocator_traits<>, std::construct_at, std::destroy_at
+#include <new>				// std::launder
+#include <stdexcept>		// std::out_of_range
+#include <tuple>			// std::forward_as_tuple, std::tuple
+#include <type_traits>		// std::true_type, std::false_type, std::is_trivially_copyable_v, std::is_trivially_destructible_v
+#include <utility>			// std::pair, std::swap, std::move, std::forward, std::piecewise_construct
+#include "../Serialize.h"
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+//! BTree is a sorted associative container that contains key-value pairs with unique keys. Keys are sorted by using the comparison function Compare. Search, removal, and insertion operations have logarithmic complexity. This is an implementation of a B+ Tree: the key-value pairs are stored contiguously in linked leaves and the inner nodes only hold separator keys, which makes lookups and range scans cache-friendly.
+//! NodeSize is the approximate size in bytes of every node, which are aligned to cache lines. The number of elements per node is derived from it.
+template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>, std::size_t NodeSize = 512> class BTree{
+	private:
+		struct NodeBase;
+		struct LeafNode;
+		struct InnerNode;
+		struct iterator_actions;
+		// Rebind Allocator
+		using AllocatorLeaves = typename std::allocator_traits<Allocator>::rebind_alloc<LeafNode>;
+		using AllocatorInners = typename std::allocator_traits<Allocator>::rebind_alloc<InnerNode>;
+		// Node capacities
+		static constexpr std::size_t leaf_slots = (NodeSize > 64 + 4*sizeof(std::pair<const Key, T>)) ? (NodeSize - 64) / sizeof(std::pair<const Key, T>) : 4;
+		static constexpr std::size_t inner_slots = (NodeSize > 64 + 4*(sizeof(Key) + sizeof(void*))) ? (NodeSize - 64) / (sizeof(Key) + sizeof(void*)) : 4;
+	public:
+		// Declares member types
+		//! Type of the keys for the key-value pairs.
+		using key_type = Key;
+		//! Type of the mapped values for the key-value pairs.
+		using mapped_type = T;
+		//! Type of the values stored in the map.
+		using value_type = std::pair<const Key, T>;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences (unused).
+		using difference_type = std::ptrdiff_t;
+		//! Type of compare used in key comparison.
+		using key_compare = Compare;
+		//! Type of allocator used.
+		using allocator_type = Allocator;
+		//! Type of references to values.
+		using reference = value_type&;
+		//! Type of constant references to values.
+		using const_reference = const value_type&;
+		//! Type of container leaf node.
+		using node_type = LeafNode;
+		
+		//! Constructs an empty container.
+		BTree();
+		//! Constructs an empty container. Receives the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		explicit BTree(const Compare& comp, const Allocator& alloc = Allocator());
+		//! Constructs an empty container. Receives the allocator to use for all memory allocations.
+		explicit BTree(const Allocator& alloc);
+		
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations. If the range is sorted in strictly increasing order of keys, the leaves are filled in linear time.
+		template <class InputIt> BTree(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Receives the allocator to use for all memory allocations. If the range is sorted in strictly increasing order of keys, the leaves are filled in linear time.
+		template <class InputIt> BTree(InputIt first, InputIt last, const Allocator& alloc);
+		
+		//! Copy constructor. Constructs the container with the copy of the contents of other.
+		BTree(const BTree& other);
+		//! Copy constructor. Constructs the container with the copy of the contents of other. Receives the allocator to use for all memory allocations.
+		BTree(const BTree& other, const Allocator& alloc);
+		
+		//! Move constructor. Constructs the container with the contents of other using move semantics. After the move, other is guaranteed to be empty().
+		BTree(BTree&& other);
+		//! Move constructor. Constructs the container with the contents of other using move semantics. After the move, other is guaranteed to be empty(). Receives the allocator to use for all memory allocations.
+		BTree(BTree&& other, const Allocator& alloc);
+		
+		//! Constructs the container with the contents of the initializer list init. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		BTree(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! Constructs the container with the contents of the initializer list init. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Receives the allocator to use for all memory allocations.
+		BTree(std::initializer_list<std::pair<const Key, T>> ilist, const Allocator& alloc);
+		
+		//! Destructs the map. The destructors of the elements are called and the used storage is deallocated. Note, that if the elements are pointers, the pointed-to objects are not destroyed.
+		~BTree();
+		
+		// Assignment
+		//! Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		BTree& operator=(const BTree& other);
+		//! Move assignment operator. Replaces the contents with those of other using move semantics (i.e. the data in other is moved from other into this container). After the move, other is in a valid but unspecified state.
+		BTree& operator=(BTree&& other);
+		//! Replaces the contents with those identified by initializer list ilist.
+		BTree& operator=(std::initializer_list<std::pair<const Key, T>> ilist);
+		
+		// Get allocator
+		//! Returns the allocator associated with the container.
+		Allocator get_allocator() const noexcept;
+		
+		// Element access
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		const T& at(const Key& key) const;
+		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		T& operator[](const Key& key);
+		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		T& operator[](Key&& key);
+		
+		// Iterators
+		//! iterator is an object that allows iteration of the container in the order of the sorted keys. Beware that any insertion or removal in the tree may invalidate the iterators and produce undefined behaviour.
+		struct iterator : public iterator_actions{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::size_t;
+			//! Type of objects pointed to by the iterator.
+			using pointer = LeafNode*;
+			//! Type of references to values.
+			using reference = std::pair<const Key, T>&;
+			//! References the key-value pair pointed at by the iterator.
+			std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			iterator operator--(int);
+		};
+		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only. Beware that any insertion or removal in the tree may invalidate the iterators and produce undefined behaviour.
+		struct const_iterator : public iterator_actions{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = const std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::size_t;
+			//! Type of objects pointed to by the iterator.
+			using pointer = LeafNode*;
+			//! Type of references to values.
+			using reference = const std::pair<const Key, T>&;
+			//! References the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator operator--(int);
+		};
+		//! reverse_iterator is an object that allows iteration of the container in the inverse order of the sorted keys. Beware that any insertion or removal in the tree may invalidate the iterators and produce undefined behaviour.
+		struct reverse_iterator : public iterator_actions{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::size_t;
+			//! Type of objects pointed to by the iterator.
+			using pointer = LeafNode*;
+			//! Type of references to values.
+			using reference = std::pair<const Key, T>&;
+			//! Returns the underlying base iterator.
+			inline constexpr iterator base() const;
+			//! References the key-value pair pointed at by the iterator.
+			std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the previous key-value in the map.
+			reverse_iterator& operator++();
+			//! Advances the iterator to the previous key-value in the map.
+			reverse_iterator operator++(int);
+			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			reverse_iterator& operator--();
+			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			reverse_iterator operator--(int);
+		};
+		//! const_reverse_iterator is an object that allows iteration of the container in the inverse order of the sorted keys for access only. Beware that any insertion or removal in the tree may invalidate the iterators and produce undefined behaviour.
+		struct const_reverse_iterator : public iterator_actions{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = const std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::size_t;
+			//! Type of objects pointed to by the iterator.
+			using pointer = LeafNode*;
+			//! Type of references to values.
+			using reference = const std::pair<const Key, T>&;
+			//! Returns the underlying base iterator.
+			inline constexpr const_iterator base() const;
+			//! References the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the previous key-value in the map.
+			const_reverse_iterator& operator++();
+			//! Advances the iterator to the previous key-value in the map.
+			const_reverse_iterator operator++(int);
+			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			const_reverse_iterator& operator--();
+			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			const_reverse_iterator operator--(int);
+		};
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		iterator begin() noexcept;
+		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator begin() const noexcept;
+		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator cbegin() const noexcept;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		iterator end() noexcept;
+		//! Returns a constant iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator end() const noexcept;
+		//! Returns a constant iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator cend() const noexcept;
+		//! Returns a reverse iterator to the first element of the reversed map. It corresponds to the last element of the non-reversed map. If the map is empty, the returned iterator is equal to rend().
+		reverse_iterator rbegin() noexcept;
+		//! Returns a constant reverse iterator to the first element of the reversed map. It corresponds to the last element of the non-reversed map. If the map is empty, the returned iterator is equal to rend().
+		const_reverse_iterator rbegin() const noexcept;
+		//! Returns a constant reverse iterator to the first element of the reversed map. It corresponds to the last element of the non-reversed map. If the map is empty, the returned iterator is equal to rend().
+		const_reverse_iterator crbegin() const noexcept;
+		//! Returns a reverse iterator to the element following the last element of the reversed map. It corresponds to the element preceding the first element of the non-reversed map. This element acts as a placeholder, attempting to access it results in undefined behavior.
+		reverse_iterator rend() noexcept;
+		//! Returns a constant reverse iterator to the element following the last element of the reversed map. It corresponds to the element preceding the first element of the non-reversed map. This element acts as a placeholder, attempting to access it results in undefined behavior.
+		const_reverse_iterator rend() const noexcept;
+		//! Returns a constant reverse iterator to the element following the last element of the reversed map. It corresponds to the element preceding the first element of the non-reversed map. This element acts as a placeholder, attempting to access it results in undefined behavior.
+		const_reverse_iterator crend() const noexcept;
+		
+		// Capacity
+		//! Checks if the container has no elements, i.e. whether begin() == end().
+		bool empty() const noexcept;
+		//! Returns the number of elements in the container.
+		std::size_t size() const noexcept;
+		//! Returns the total space in memory.
+		std::size_t memory() const noexcept;
+		
+		// Modifiers
+		// Clear
+		//! Erases all elements from the container. After this call, size() returns zero. Invalidates any references, pointers, or iterators referring to contained elements. Any past-the-end iterator remains valid. If the allocator supports releasing its storage at once (see bpp::utility::memory::ArenaAllocator) and the elements are trivially destructible, the nodes are released without visiting them.
+		void clear() noexcept;
+		// Insert
+		//! Inserts element(s) into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
+		std::pair<iterator, bool> insert(const std::pair<const Key, T>& value);
+		//! Inserts element(s) into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
+		std::pair<iterator, bool> insert(std::pair<const Key, T>&& value);
+		//! Inserts value in the position as close as possible to hint. Returns an iterator to the inserted element, or to the element that prevented the insertion. If hint is end() and the key of value compares greater than every key in the container, the value is appended to the last leaf without searching.
+		iterator insert(iterator hint, const std::pair<const Key, T>& value);
+		//! Inserts value in the position as close as possible to hint. Returns an iterator to the inserted element, or to the element that prevented the insertion. If hint is end() and the key of value compares greater than every key in the container, the value is appended to the last leaf without searching.
+		iterator insert(iterator hint, std::pair<const Key, T>&& value);
+		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. If the container is empty and the range is sorted in strictly increasing order of keys, the leaves are filled in linear time.
+		template <class InputIt> void insert(InputIt first, InputIt last);
+		//! Inserts elements from initializer list ilist. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		void insert(std::initializer_list<std::pair<const Key, T>> ilist);
+		//! Replaces the contents with the elements from range [first, last), which must be sorted in strictly increasing order of keys (otherwise the behaviour is undefined). The leaves are filled completely one after the other in linear time without any comparisons.
+		template <class InputIt> void assign_sorted(InputIt first, InputIt last);
+		// Insert or Assign
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		template <class M> std::pair<iterator, bool> insert_or_assign(const Key& k, M&& obj);
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		template <class M> std::pair<iterator, bool> insert_or_assign(Key&& k, M&& obj);
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		template <class M> std::pair<iterator, bool> insert_or_assign(iterator hint, const Key& k, M&& obj);
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		template <class M> std::pair<iterator, bool> insert_or_assign(iterator hint, Key&& k, M&& obj);
+		// Erase
+		//! Removes element at pos from the container. Returns iterator following the last removed element.
+		iterator erase(iterator pos);
+		//! Removes element at pos from the container. Returns iterator following the last removed element.
+		iterator erase(const_iterator pos);
+		//! Removes the elements in the range [first; last), which must be a valid range in *this.
+		iterator erase(iterator first, iterator last);
+		//! Removes the elements in the range [first; last), which must be a valid range in *this.
+		iterator erase(const_iterator first, const_iterator last);
+		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
+		std::size_t erase(const Key& key);
+		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
+		template <class K> std::size_t erase(K&& key);
+		
+		// Lookup
+		// Count
+		//! Returns the number of elements with key that compares equivalent to the specified argument, which is either 1 or 0 since this container does not allow duplicates.
+		template <class K> std::size_t count(const K& key) const;
+		// Find
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator find(const K& key);
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see cend()) iterator is returned.
+		template <class K> const_iterator find(const K& key) const;
+		// Contains
+		//! Checks if there is an element with key that compares equivalent to the value of key.
+		template <class K> bool contains(const K& key) const;
+		// Bounds
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator lower_bound(const K& key);
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see cend()) iterator is returned.
+		template <class K> const_iterator lower_bound(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator upper_bound(const K& key);
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see cend()) iterator is returned.
+		template <class K> const_iterator upper_bound(const K& key) const;
+		//! Returns a range containing all elements with the given key in the container. The range is defined by two iterators, one pointing to the first element that is not less than key and another pointing to the first element greater than key. Alternatively, the first iterator may be obtained with lower_bound(), and the second with upper_bound().
+		template <class K> std::pair<iterator,iterator> equal_range(const K& key);
+		//! Returns a range containing all elements with the given key in the container. The range is defined by two iterators, one pointing to the first element that is not less than key and another pointing to the first element greater than key. Alternatively, the first iterator may be obtained with lower_bound(), and the second with upper_bound().
+		template <class K> std::pair<const_iterator,const_iterator> equal_range(const K& key) const;
+		
+		// Non-member
+		// Operators
+		//! Checks if the contents of lhs and rhs are equal, that is, they have the same number of elements and each element in lhs compares equal with the element in rhs at the same position.
+		template <class A, class B, class C, class D, std::size_t E> friend bool operator==(const BTree<A,B,C,D,E>& lhs, const BTree<A,B,C,D,E>& rhs);
+		//! Compares the contents of lhs and rhs lexicographically.
+		template <class A, class B, class C, class D, std::size_t E> friend std::strong_ordering operator<=>(const BTree<A,B,C,D,E>& lhs, const BTree<A,B,C,D,E>& rhs);
+		// Other
+		//! Erases all elements that satisfy the predicate pred from the container.
+		template <class A, class B, class C, class D, std::size_t E, class Pred> friend std::size_t std::erase_if(BTree<A,B,C,D,E>& tree, Pred pred);
+		//! Specialized swapping function.
+		template <class A, class B, class C, class D, std::size_t E> friend void std::swap(BTree<A,B,C,D,E> &lhs, BTree<A,B,C,D,E>& rhs);
+		// Friendship
+		//! Specialization of the Serialize template to support BTree objects.
+		template <typename Buff, typename... Types> friend struct bpp::collections::serialize::Serialize;
+		//! Specialization of the Deserialize template to support BTree objects.
+		template <typename Buff, typename... Types> friend struct bpp::collections::serialize::Deserialize;
+		
+	private:
+		// Nested structures NodeBase, LeafNode and InnerNode
+		struct NodeBase{
+			InnerNode* parent;
+			std::size_t size;
+			bool leaf;
+			NodeBase(bool leaf);
+		};
+		struct alignas(64) LeafNode : public NodeBase{
+			LeafNode *prev, *next;
+			alignas(std::pair<const Key, T>) unsigned char storage[leaf_slots * sizeof(std::pair<const Key, T>)];
+			LeafNode();
+			~LeafNode();
+			inline std::pair<const Key, T>* values();
+			inline static void relocate(std::pair<const Key, T>* src, std::size_t n, std::pair<const Key, T>* dst);
+		};
+		struct alignas(64) InnerNode : public NodeBase{
+			Key keys[inner_slots];
+			NodeBase* children[inner_slots + 1];
+			InnerNode();
+			inline void insert(std::size_t pos, const Key& key, NodeBase* child);
+			inline std::size_t index_of(NodeBase* child) const;
+		};
+		AllocatorLeaves leafAlloc;
+		AllocatorInners innerAlloc;
+		Compare cmp;
+		NodeBase* root;
+		LeafNode *head, *tail;
+		std::size_t counter, leaves, inners;
+		template <class K> inline LeafNode* find_leaf(const K& key) const;
+		template <class K> inline std::size_t leaf_lower(LeafNode* leaf, const K& key) const;
+		template <class K> inline std::pair<LeafNode*, std::size_t> locate(const K& key) const;
+		template <class K, class... Args> std::pair<iterator, bool> emplace_unique(const K& key, Args&&... args);
+		template <class... Args> iterator emplace_at(LeafNode* leaf, std::size_t pos, Args&&... args);
+		template <class... Args> inline iterator emplace_back(Args&&... args);
+		void insert_parent(NodeBase* left, const Key& separator, NodeBase* right);
+		iterator erase_at(LeafNode* leaf, std::size_t pos);
+		void remove_inner(InnerNode* node, std::size_t pos);
+		inline LeafNode* new_leaf();
+		inline InnerNode* new_inner();
+		inline void delete_leaf(LeafNode* leaf);
+		inline void delete_inner(InnerNode* inner);
+		void destroy(NodeBase* node);
+		inline void destroy_nodes();
+		NodeBase* copy(const NodeBase* src, InnerNode* parent, LeafNode*& last);
+		template <class InputIt> inline bool build_sorted(InputIt first, InputIt last);
+		// Iterator base structure
+		struct iterator_actions{
+			friend class BTree<Key,T,Compare,Allocator,NodeSize>;
+			iterator_actions(LeafNode* init = 0, std::size_t index = 0);
+			bool operator==(const iterator_actions& other) const;
+			bool operator!=(const iterator_actions& other) const;
+			protected:
+				LeafNode* current;
+				std::size_t index;
+				static std::pair<const Key, T> nullvalue;
+				inline void next_element();
+				inline void previous_element();
+		};
+		// Specialized copy/move calls
+		inline void sp_copy(const BTree& other, std::true_type);
+		inline void sp_copy(const BTree& other, std::false_type);
+		inline void sp_move(BTree&& other, std::true_type) noexcept;
+		inline void sp_move(BTree&& other, std::false_type);
+};
+
+		}
+		namespace serialize{
+
+//! Specialization of the Serialize template to support BTree objects. The elements are stored in order.
+template <typename Buff, class Key, class T, class Compare, class Allocator, std::size_t NodeSize> struct Serialize<Buff,bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>>{
+	std::size_t operator()(Buff& buffer, const bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>& obj) const;
+};
+//! Specialization of the Deserialize template to support BTree objects. Since the elements are stored in order, the leaves are filled completely without searching.
+template <typename Buff, class Key, class T, class Compare, class Allocator, std::size_t NodeSize> struct Deserialize<Buff,bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>>{
+	std::size_t operator()(Buff& buffer, bpp::collections::map::BTree<Key,T,Compare,Allocator,NodeSize>& obj) const;
+};
+
+		}
+	}
+}
+
+#include "BTree.cpp"
+
+#endif
@@ -0,0 +1,728 @@
+#ifndef BPP_COLLECTIONS_MAP_COMPACTTREEAVL_CPP
+#define BPP_COLLECTIONS_MAP_COMPACTTREEAVL_CPP
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+// Empty initialization
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::CompactTreeAVL() :
+	root(nil),
+	counter(0),
+	chunks(),
+	used(1),
+	released(nil){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::CompactTreeAVL(const Compare& comp, const Allocator& alloc) :
+	alloc(alloc),
+	cmp(comp),
+	root(nil),
+	counter(0),
+	chunks(),
+	used(1),
+	released(nil){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::CompactTreeAVL(const Allocator& alloc) :
+	alloc(alloc),
+	root(nil),
+	counter(0),
+	chunks(),
+	used(1),
+	released(nil){ }
+
+// Iterator initilization
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class InputIt> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::CompactTreeAVL(InputIt first, InputIt last, const Compare& comp, const Allocator& alloc) :
+	CompactTreeAVL(comp, alloc){
+	this->insert(first, last);
+}
+
+// Initializer list initialization
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::CompactTreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp, const Allocator& alloc) :
+	CompactTreeAVL(comp, alloc){
+	this->insert(ilist.begin(), ilist.end());
+}
+
+// Copy constructor
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::CompactTreeAVL(const CompactTreeAVL& other) :
+	alloc(std::allocator_traits<AllocatorNodes>::select_on_container_copy_construction(other.alloc)),
+	cmp(other.cmp),
+	root(nil),
+	counter(0),
+	chunks(),
+	used(1),
+	released(nil){
+	this->copy_pool(other);
+}
+
+// Move constructor
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::CompactTreeAVL(CompactTreeAVL&& other) noexcept :
+	alloc(std::move(other.alloc)),
+	cmp(std::move(other.cmp)),
+	root(other.root),
+	counter(other.counter),
+	used(other.used),
+	released(other.released){
+	for(unsigned i=0; i<max_chunks; ++i){
+		this->chunks[i] = other.chunks[i];
+		other.chunks[i] = 0;
+	}
+	other.root = nil;
+	other.counter = 0;
+	other.used = 1;
+	other.released = nil;
+}
+
+// Destructor
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::~CompactTreeAVL(){
+	this->release_pool();
+}
+
+// Assignment
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::operator=(const CompactTreeAVL& other){
+	if(this != &other){
+		this->clear();
+		if constexpr(std::allocator_traits<AllocatorNodes>::propagate_on_container_copy_assignment::value){ this->alloc = other.alloc; }
+		this->cmp = other.cmp;
+		this->copy_pool(other);
+	}
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::operator=(CompactTreeAVL&& other) noexcept{
+	if(this != &other){
+		this->clear();
+		this->alloc = std::move(other.alloc);
+		this->cmp = std::move(other.cmp);
+		std::swap(this->root, other.root);
+		std::swap(this->counter, other.counter);
+		std::swap(this->chunks, other.chunks);
+		std::swap(this->used, other.used);
+		std::swap(this->released, other.released);
+	}
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::operator=(std::initializer_list<std::pair<const Key, T>> ilist){
+	this->clear();
+	this->insert(ilist.begin(), ilist.end());
+	return *this;
+}
+
+// Get allocator
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> Allocator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::get_allocator() const noexcept{
+	return Allocator(this->alloc);
+}
+
+// Element access
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> T& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::at(const Key& key){
+	Index index = this->find_node(key);
+	if(!index){ throw std::out_of_range("bpp::collections::map::CompactTreeAVL::at"); }
+	return this->node(index)->data.second;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> const T& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::at(const Key& key) const{
+	Index index = this->find_node(key);
+	if(!index){ throw std::out_of_range("bpp::collections::map::CompactTreeAVL::at"); }
+	return this->node(index)->data.second;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> T& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::operator[](const Key& key){
+	return this->node(this->get_forward(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first)->data.second;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> T& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::operator[](Key&& key){
+	return this->node(this->get_forward(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::tuple<>()).first)->data.second;
+}
+
+// Iterators
+// Iterator
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::iterator() :
+	iterator_actions(0, nil){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::iterator(const iterator_actions& position) :
+	iterator_actions(position){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::pair<const Key, T>& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::operator*() const{
+	return this->tree->node(this->current)->data;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::pair<const Key, T>* CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::operator->() const{
+	return &this->tree->node(this->current)->data;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::operator++(int){
+	iterator pit(*this);
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator::operator--(int){
+	iterator pit(*this);
+	this->previous_element();
+	return pit;
+}
+// Constant Iterator
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::const_iterator() :
+	iterator_actions(0, nil){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::const_iterator(const iterator& it) :
+	iterator_actions(it){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::const_iterator(const iterator_actions& position) :
+	iterator_actions(position){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> const std::pair<const Key, T>& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::operator*() const{
+	return this->tree->node(this->current)->data;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> const std::pair<const Key, T>* CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::operator->() const{
+	return &this->tree->node(this->current)->data;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::operator++(int){
+	const_iterator pit(*this);
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator& CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator::operator--(int){
+	const_iterator pit(*this);
+	this->previous_element();
+	return pit;
+}
+// Iterator generation methods
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::begin() noexcept{
+	iterator_actions it(this, nil);
+	if(this->root){ it.descend(this->root, false); }
+	return iterator(it);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::begin() const noexcept{
+	iterator_actions it(this, nil);
+	if(this->root){ it.descend(this->root, false); }
+	return const_iterator(it);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::cbegin() const noexcept{
+	return this->begin();
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::end() noexcept{
+	return iterator(iterator_actions(this, nil));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::end() const noexcept{
+	return const_iterator(iterator_actions(this, nil));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::cend() const noexcept{
+	return const_iterator(iterator_actions(this, nil));
+}
+
+// Capacity
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> bool CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::empty() const noexcept{
+	return !this->counter;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::size_t CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::size() const noexcept{
+	return this->counter;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::size_t CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::max_size() const noexcept{
+	return std::size_t(taller) - 1;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::size_t CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::memory() const noexcept{
+	std::size_t result = sizeof(*this);
+	for(unsigned i=0; i<max_chunks && this->chunks[i]; ++i){ result += chunk_size(i) * sizeof(NodeAVL); }
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::reserve(std::size_t n){
+	if(n > this->max_size()){ throw std::length_error("bpp::collections::map::CompactTreeAVL::reserve"); }
+	// Index n is the last one needed, since index 0 is never used
+	if(!n){ return; }
+	for(unsigned i=0; i<max_chunks && (std::size_t(1) << (i + first_chunk)) - (std::size_t(1) << first_chunk) <= n; ++i){
+		if(!this->chunks[i]){
+			this->chunks[i] = this->alloc.allocate(chunk_size(i));
+			for(std::size_t j=0; j<chunk_size(i); ++j){ std::construct_at(this->chunks[i] + j); }
+		}
+	}
+}
+
+// Modifiers
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::clear() noexcept{
+	this->release_pool();
+	this->root = nil;
+	this->counter = 0;
+	this->used = 1;
+	this->released = nil;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::pair<typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator, bool> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::insert(const std::pair<const Key, T>& value){
+	std::pair<Index, bool> result = this->get_forward(value.first, value);
+	return std::pair<iterator, bool>(iterator(this->locate(result.first)), result.second);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::pair<typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator, bool> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::insert(std::pair<const Key, T>&& value){
+	std::pair<Index, bool> result = this->get_forward(value.first, std::move(value));
+	return std::pair<iterator, bool>(iterator(this->locate(result.first)), result.second);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class InputIt> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::insert(InputIt first, InputIt last){
+	for(; first != last; ++first){ this->get_forward(first->first, *first); }
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::insert(std::initializer_list<std::pair<const Key, T>> ilist){
+	this->insert(ilist.begin(), ilist.end());
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class M> std::pair<typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator, bool> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::insert_or_assign(const Key& k, M&& obj){
+	std::pair<Index, bool> result = this->get_forward(k, k, std::forward<M>(obj));
+	if(!result.second){ this->node(result.first)->data.second = std::forward<M>(obj); }
+	return std::pair<iterator, bool>(iterator(this->locate(result.first)), result.second);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::erase(iterator pos){
+	return this->erase(const_iterator(pos));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::erase(const_iterator pos){
+	// The nodes are not moved by the removal, so the following element is located again by its Index
+	Path path;
+	const_iterator next = pos;
+	++next;
+	if constexpr(Parents){
+		path.depth = 0;
+		for(Index index = pos.current; index; index = this->node(index)->parent){ ++path.depth; }
+		std::size_t depth = path.depth;
+		for(Index index = pos.current; index; index = this->node(index)->parent){ path.nodes[--depth] = index; }
+	}else{
+		path = pos.ancestors;
+		for(std::size_t i=0; i<path.depth; ++i){ path.nodes[i] &= ~taller; }
+		path.nodes[path.depth++] = pos.current;
+	}
+	this->remove_node(path);
+	return iterator(this->locate(next.current));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> std::size_t CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::erase(const K& key){
+	lookup_key<K> k = key;
+	Path path;
+	Index index = this->root;
+	path.depth = 0;
+	while(index){
+		NodeAVL* node = this->node(index);
+		path.nodes[path.depth++] = index;
+		if(this->cmp(k, node->data.first)){
+			index = node->child(false);
+		}else if(this->cmp(node->data.first, k)){
+			index = node->child(true);
+		}else{
+			this->remove_node(path);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Lookup
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> std::size_t CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::count(const K& key) const{
+	lookup_key<K> k = key;
+	return this->find_node(k) ? 1 : 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> bool CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::contains(const K& key) const{
+	lookup_key<K> k = key;
+	return this->find_node(k);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::find(const K& key){
+	return iterator(static_cast<const CompactTreeAVL*>(this)->find(key));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::find(const K& key) const{
+	lookup_key<K> k = key;
+	iterator_actions it = this->search([&](NodeAVL* node){ return !this->cmp(node->data.first, k); });
+	if(it.current && this->cmp(k, this->node(it.current)->data.first)){ return this->end(); }
+	return const_iterator(it);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::lower_bound(const K& key){
+	return iterator(static_cast<const CompactTreeAVL*>(this)->lower_bound(key));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::lower_bound(const K& key) const{
+	lookup_key<K> k = key;
+	return const_iterator(this->search([&](NodeAVL* node){ return !this->cmp(node->data.first, k); }));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::upper_bound(const K& key){
+	return iterator(static_cast<const CompactTreeAVL*>(this)->upper_bound(key));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::const_iterator CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::upper_bound(const K& key) const{
+	lookup_key<K> k = key;
+	return const_iterator(this->search([&](NodeAVL* node){ return this->cmp(k, node->data.first); }));
+}
+
+// Observers
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> Compare CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::key_comp() const{
+	return this->cmp;
+}
+
+// Operators
+template <class A, class B, class C, class D, std::unsigned_integral E, bool F> bool operator==(const CompactTreeAVL<A,B,C,D,E,F>& lhs, const CompactTreeAVL<A,B,C,D,E,F>& rhs){
+	if(lhs.size() != rhs.size()){ return false; }
+	for(auto it = lhs.begin(), ito = rhs.begin(); it != lhs.end(); ++it, ++ito){
+		if(it->first != ito->first || it->second != ito->second){ return false; }
+	}
+	return true;
+}
+
+// Nested class NodeAVL
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::NodeAVL::NodeAVL() :
+	children{nil, nil},
+	parent(){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::NodeAVL::~NodeAVL(){ }
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> Index CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::NodeAVL::child(bool right) const{
+	return this->children[right] & ~taller;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::NodeAVL::link(bool right, Index node){
+	this->children[right] = node | (this->children[right] & taller);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> int CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::NodeAVL::balance() const{
+	return int(bool(this->children[1] & taller)) - int(bool(this->children[0] & taller));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::NodeAVL::set_balance(int balance){
+	this->children[0] = (this->children[0] & ~taller) | (balance < 0 ? taller : 0);
+	this->children[1] = (this->children[1] & ~taller) | (balance > 0 ? taller : 0);
+}
+
+// Private members
+// Pool
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::NodeAVL* CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::node(Index index) const{
+	// Shifting the indices by the size of the first chunk makes the position of the highest bit select the chunk
+	std::size_t shifted = std::size_t(index) + (std::size_t(1) << first_chunk);
+	unsigned chunk = std::bit_width(shifted) - 1 - first_chunk;
+	return this->chunks[chunk] + (shifted - (std::size_t(1) << (chunk + first_chunk)));
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::size_t CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::chunk_size(unsigned chunk){
+	return std::size_t(1) << (chunk + first_chunk);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class... Args> Index CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::create(Args&&... args){
+	// Released nodes are reused first, they are chained through their left link
+	Index index = this->released;
+	if(index){
+		this->released = this->node(index)->children[0];
+	}else{
+		if(this->used > this->max_size()){ throw std::length_error("bpp::collections::map::CompactTreeAVL::insert"); }
+		std::size_t shifted = this->used + (std::size_t(1) << first_chunk);
+		unsigned chunk = std::bit_width(shifted) - 1 - first_chunk;
+		if(!this->chunks[chunk]){
+			this->chunks[chunk] = this->alloc.allocate(chunk_size(chunk));
+			for(std::size_t j=0; j<chunk_size(chunk); ++j){ std::construct_at(this->chunks[chunk] + j); }
+		}
+		index = Index(this->used);
+		++this->used;
+	}
+	NodeAVL* node = this->node(index);
+	try{
+		std::construct_at(&node->data, std::forward<Args>(args)...);
+	}catch(...){
+		this->release(index);
+		throw;
+	}
+	node->children[0] = node->children[1] = nil;
+	this->set_parent(index, nil);
+	return index;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::release(Index index){
+	NodeAVL* node = this->node(index);
+	node->children[0] = this->released;
+	this->released = index;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::release_pool() noexcept{
+	// Visits the linked nodes in order to destroy their elements, then the chunks are returned to the allocator
+	if constexpr(!std::is_trivially_destructible_v<std::pair<const Key,T>>){
+		for(iterator it = this->begin(); it != this->end(); ++it){ std::destroy_at(&*it); }
+	}
+	for(unsigned i=0; i<max_chunks && this->chunks[i]; ++i){
+		std::destroy(this->chunks[i], this->chunks[i] + chunk_size(i));
+		this->alloc.deallocate(this->chunks[i], chunk_size(i));
+		this->chunks[i] = 0;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::copy_pool(const CompactTreeAVL& other){
+	// Every node keeps its index, so the links are copied as they are and only the linked elements are constructed
+	this->reserve(other.used - 1);
+	for(std::size_t i=1; i<other.used; ++i){
+		NodeAVL *src = other.node(Index(i)), *dst = this->node(Index(i));
+		dst->children[0] = src->children[0];
+		dst->children[1] = src->children[1];
+		if constexpr(Parents){ dst->parent = src->parent; }
+	}
+	this->used = other.used;
+	this->released = other.released;
+	for(const_iterator it = other.begin(); it != other.end(); ++it){ std::construct_at(&this->node(it.current)->data, *it); }
+	this->root = other.root;
+	this->counter = other.counter;
+}
+// Tree
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> Index CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::lower_node(const K& key) const{
+	Index index = this->root, result = nil;
+	while(index){
+		NodeAVL* node = this->node(index);
+		bool right = this->cmp(node->data.first, key);
+		result = right ? result : index;
+		index = node->child(right);
+	}
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K> Index CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::find_node(const K& key) const{
+	Index index = this->lower_node(key);
+	return index && !this->cmp(key, this->node(index)->data.first) ? index : nil;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class Pred> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::search(Pred pred) const{
+	// Returns the first node satisfying pred, recording the descent and cutting it at that node if the ancestors are kept by the iterators
+	iterator_actions result(this, nil);
+	Index index = this->root;
+	if constexpr(Parents){
+		while(index){
+			NodeAVL* node = this->node(index);
+			bool left = pred(node);
+			result.current = left ? index : result.current;
+			index = node->child(!left);
+		}
+	}else{
+		std::size_t depth = 0, found = 0;
+		while(index){
+			NodeAVL* node = this->node(index);
+			bool left = pred(node);
+			result.ancestors.nodes[depth++] = index | (left ? 0 : taller);
+			found = left ? depth : found;
+			index = node->child(!left);
+		}
+		if(found){
+			result.current = result.ancestors.nodes[found - 1];
+			result.ancestors.depth = found - 1;
+		}
+	}
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> typename CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::locate(Index index) const{
+	if constexpr(Parents){
+		return iterator_actions(this, index);
+	}else{
+		if(!index){ return iterator_actions(this, nil); }
+		const Key& key = this->node(index)->data.first;
+		return this->search([&](NodeAVL* node){ return !this->cmp(node->data.first, key); });
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> template <class K, class... Args> std::pair<Index, bool> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::get_forward(const K& key, Args&&... args){
+	Path path;
+	Index index = this->root;
+	bool right = false;
+	path.depth = 0;
+	while(index){
+		NodeAVL* node = this->node(index);
+		if(this->cmp(key, node->data.first)){
+			right = false;
+		}else if(this->cmp(node->data.first, key)){
+			right = true;
+		}else{
+			return std::pair<Index, bool>(index, false);
+		}
+		path.nodes[path.depth++] = index;
+		index = node->child(right);
+	}
+	index = this->create(std::forward<Args>(args)...);
+	if(path.depth){
+		Index parent = path.nodes[path.depth - 1];
+		this->node(parent)->link(right, index);
+		this->set_parent(index, parent);
+		this->rebalance_insert(path, index);
+	}else{
+		this->root = index;
+	}
+	this->counter++;
+	return std::pair<Index, bool>(index, true);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::remove_node(Path& path){
+	// The successor node takes the place of a node with two children, so the other elements are never moved. The path ends at the removed node and is left at the node where the height changed
+	std::size_t slot = path.depth - 1;
+	Index index = path.nodes[slot], parent = slot ? path.nodes[slot - 1] : nil;
+	NodeAVL* node = this->node(index);
+	Index left = node->child(false), right = node->child(true);
+	bool side;
+	if(left && right){
+		Index successor = right;
+		path.nodes[path.depth++] = successor;
+		while(this->node(successor)->child(false)){
+			successor = this->node(successor)->child(false);
+			path.nodes[path.depth++] = successor;
+		}
+		NodeAVL* snode = this->node(successor);
+		if(successor == right){
+			side = true;
+			path.depth = slot + 1;
+		}else{
+			side = false;
+			--path.depth;
+			Index from = path.nodes[path.depth - 1], inner = snode->child(true);
+			this->node(from)->link(false, inner);
+			if(inner){ this->set_parent(inner, from); }
+			snode->link(true, right);
+			this->set_parent(right, successor);
+		}
+		snode->link(false, left);
+		this->set_parent(left, successor);
+		snode->set_balance(node->balance());
+		this->replace_child(parent, index, successor);
+		this->set_parent(successor, parent);
+		path.nodes[slot] = successor;
+	}else{
+		Index child = left ? left : right;
+		side = parent && this->node(parent)->child(true) == index;
+		this->replace_child(parent, index, child);
+		if(child){ this->set_parent(child, parent); }
+		path.depth = slot;
+	}
+	std::destroy_at(&node->data);
+	this->release(index);
+	this->counter--;
+	this->rebalance_erase(path, side);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::replace_child(Index parent, Index child, Index replacement){
+	if(parent){
+		NodeAVL* node = this->node(parent);
+		node->link(node->child(true) == child, replacement);
+	}else{
+		this->root = replacement;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::set_parent(Index index, Index parent){
+	if constexpr(Parents){ this->node(index)->parent = parent; }
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> Index CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::rotation(Index index, bool right, Index parent){
+	// The child on the given side takes the place of the node, the balance factors are left for the caller to update
+	NodeAVL* node = this->node(index);
+	Index top = node->child(right);
+	NodeAVL* tnode = this->node(top);
+	Index inner = tnode->child(!right);
+	node->link(right, inner);
+	if(inner){ this->set_parent(inner, index); }
+	tnode->link(!right, index);
+	this->replace_child(parent, index, top);
+	this->set_parent(top, parent);
+	this->set_parent(index, top);
+	return top;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> std::pair<Index, bool> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::rebalance_node(Index index, int balance, Index parent){
+	// Restores a node with a balance factor of +-2, returns the new root of the subtree and whether the subtree became shorter
+	bool right = balance > 0;
+	int sign = right ? 1 : -1;
+	Index child = this->node(index)->child(right);
+	int cbalance = this->node(child)->balance();
+	if(cbalance == -sign){
+		Index inner = this->node(child)->child(!right);
+		int ibalance = this->node(inner)->balance();
+		this->rotation(child, !right, index);
+		this->rotation(index, right, parent);
+		this->node(index)->set_balance(ibalance == sign ? -sign : 0);
+		this->node(child)->set_balance(ibalance == -sign ? sign : 0);
+		this->node(inner)->set_balance(0);
+		return std::pair<Index, bool>(inner, true);
+	}
+	this->rotation(index, right, parent);
+	this->node(index)->set_balance(cbalance ? 0 : sign);
+	this->node(child)->set_balance(cbalance ? 0 : -sign);
+	return std::pair<Index, bool>(child, cbalance != 0);
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::rebalance_insert(Path& path, Index index){
+	// The subtree of index grew by one level, stops as soon as an ancestor absorbs it
+	while(path.depth){
+		Index parent = path.nodes[--path.depth];
+		NodeAVL* node = this->node(parent);
+		int balance = node->balance() + (node->child(true) == index ? 1 : -1);
+		if(!balance){
+			node->set_balance(0);
+			return;
+		}
+		if(balance != 1 && balance != -1){
+			this->rebalance_node(parent, balance, path.depth ? path.nodes[path.depth - 1] : nil);
+			return;
+		}
+		node->set_balance(balance);
+		index = parent;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::rebalance_erase(Path& path, bool right){
+	// The subtree at the given side of the last node of the path lost one level, stops as soon as the height of an ancestor is kept
+	while(path.depth){
+		Index index = path.nodes[--path.depth], parent = path.depth ? path.nodes[path.depth - 1] : nil;
+		NodeAVL* node = this->node(index);
+		bool side = parent && this->node(parent)->child(true) == index;
+		int balance = node->balance() + (right ? -1 : 1);
+		if(balance == 1 || balance == -1){
+			node->set_balance(balance);
+			return;
+		}
+		if(!balance){
+			node->set_balance(0);
+		}else if(!this->rebalance_node(index, balance, parent).second){
+			return;
+		}
+		right = side;
+	}
+}
+
+// Iterator actions
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions::iterator_actions(const CompactTreeAVL* tree, Index current) :
+	tree(tree),
+	current(current){
+	if constexpr(!Parents){ this->ancestors.depth = 0; }
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions::descend(Index index, bool right){
+	// Moves to the first (or last if right) node of the subtree of index, the ancestors are marked with the side taken from them
+	this->current = index;
+	for(Index next = this->tree->node(index)->child(right); next; next = this->tree->node(next)->child(right)){
+		if constexpr(!Parents){ this->ancestors.nodes[this->ancestors.depth++] = this->current | (right ? taller : 0); }
+		this->current = next;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions::next_element(){
+	if(this->current){
+		NodeAVL* node = this->tree->node(this->current);
+		if(node->child(true)){
+			if constexpr(!Parents){ this->ancestors.nodes[this->ancestors.depth++] = this->current | taller; }
+			this->descend(node->child(true), false);
+		}else if constexpr(Parents){
+			while(node->parent && this->tree->node(node->parent)->child(true) == this->current){
+				this->current = node->parent;
+				node = this->tree->node(this->current);
+			}
+			this->current = node->parent;
+		}else{
+			// The ancestors left from the right are skipped without loading them
+			while(this->ancestors.depth && (this->ancestors.nodes[this->ancestors.depth - 1] & taller)){ --this->ancestors.depth; }
+			this->current = this->ancestors.depth ? this->ancestors.nodes[--this->ancestors.depth] : nil;
+		}
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> void CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions::previous_element(){
+	if(this->current){
+		NodeAVL* node = this->tree->node(this->current);
+		if(node->child(false)){
+			if constexpr(!Parents){ this->ancestors.nodes[this->ancestors.depth++] = this->current; }
+			this->descend(node->child(false), true);
+		}else if constexpr(Parents){
+			while(node->parent && this->tree->node(node->parent)->child(false) == this->current){
+				this->current = node->parent;
+				node = this->tree->node(this->current);
+			}
+			this->current = node->parent;
+		}else{
+			while(this->ancestors.depth && !(this->ancestors.nodes[this->ancestors.depth - 1] & taller)){ --this->ancestors.depth; }
+			this->current = this->ancestors.depth ? this->ancestors.nodes[--this->ancestors.depth] & ~taller : nil;
+		}
+	}
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> bool CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions::operator==(const iterator_actions& other) const{
+	return this->current == other.current;
+}
+template <class Key, class T, class Compare, class Allocator, std::unsigned_integral Index, bool Parents> bool CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>::iterator_actions::operator!=(const iterator_actions& other) const{
+	return this->current != other.current;
+}
+
+		}
+	}
+}
+
+// Non-member
+// Other
+template <class A, class B, class C, class D, std::unsigned_integral E, bool F> void std::swap(bpp::collections::map::CompactTreeAVL<A,B,C,D,E,F>& lhs, bpp::collections::map::CompactTreeAVL<A,B,C,D,E,F>& rhs){
+	std::swap(lhs.alloc, rhs.alloc);
+	std::swap(lhs.cmp, rhs.cmp);
+	std::swap(lhs.root, rhs.root);
+	std::swap(lhs.counter, rhs.counter);
+	std::swap(lhs.chunks, rhs.chunks);
+	std::swap(lhs.used, rhs.used);
+	std::swap(lhs.released, rhs.released);
+}
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef BPP_COLLECTIONS_MAP_COMPACTTREEAVL_H
+#define BPP_COLLECTIONS_MAP_COMPACTTREEAVL_H
+#include <bit>				// std::bit_width
+#include <concepts>			// std::unsigned_integral
+#include <cstdint>			// uint32_t
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list<>
+#include <iterator>			// std::bidirectional_iterator_tag
+#include <limits>			// std::numeric_limits<>
+#include <memory>			// std::allocator<>, std::allocator_traits<>, std::construct_at, std::destroy_at, std::destroy
+#include <stdexcept>		// std::out_of_range, std::length_error
+#include <tuple>			// std::forward_as_tuple, std::tuple<>
+#include <type_traits>		// std::conditional_t, std::is_same_v, std::is_trivially_destructible_v
+#include <utility>			// std::pair, std::piecewise_construct, std::swap, std::move, std::forward
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+//! CompactTreeAVL is a sorted associative container that contains key-value pairs with unique keys, laid out to use as little memory per element as possible. Keys are sorted by using the comparison function Compare. Search, removal, and insertion operations have logarithmic complexity. This is an implementation of an Adelson-Velsky and Landis Tree.
+//! Nodes are kept in a pool of chunks owned by the container and link each other by their Index in the pool instead of by pointers. The balance factor of each node is stored in the highest bit of both child links, which marks the taller child, so a node only adds three Index values to its key-value pair (20 bytes in total for int keys and values with the default 32-bit Index, against 40 bytes in TreeAVL). The container can hold up to 2^31 - 1 elements with a 32-bit Index, a 64-bit Index lifts this limit.
+//! Chunks double in size as the container grows and are never moved, so references to the elements remain valid until they are erased. Erased nodes are reused by later insertions, the storage is only released by clear() and the destructor.
+//! If Parents is false the nodes do not keep the Index of their parent (16 bytes in total for int keys and values), modifications rebalance along the path recorded while descending and iterators carry the stack of ancestors of their element instead, so scans never load a node just to climb back from it. In that case any insertion or removal invalidates the iterators.
+template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>, std::unsigned_integral Index = uint32_t, bool Parents = true> class CompactTreeAVL{
+	private:
+		struct NodeAVL;
+		struct iterator_actions;
+		// Rebind Allocator
+		using AllocatorNodes = typename std::allocator_traits<Allocator>::rebind_alloc<NodeAVL>;
+		// Heterogeneous lookup, keys of other types are converted once to Key unless Compare is transparent
+		static constexpr bool transparent = requires{ typename Compare::is_transparent; };
+		template <class K> using lookup_key = std::conditional_t<transparent || std::is_same_v<K, Key>, const K&, const Key>;
+		// Links, the highest bit of each child link marks the taller child and index 0 is never used by any node
+		static constexpr Index taller = Index(1) << (std::numeric_limits<Index>::digits - 1);
+		static constexpr Index nil = 0;
+		// Pool, chunk k holds 2^(k + first_chunk) nodes
+		static constexpr unsigned first_chunk = 4;
+		static constexpr unsigned max_chunks = std::numeric_limits<Index>::digits - first_chunk;
+		// Bound of the height of a tree with 2^digits nodes (about 1.44 log n), sizes the recorded paths
+		static constexpr std::size_t max_height = std::numeric_limits<Index>::digits * 3 / 2;
+		struct Empty{};
+		struct Path{
+			Index nodes[max_height];
+			std::size_t depth;
+		};
+	public:
+		// Declares member types
+		//! Type of the keys for the key-value pairs.
+		using key_type = Key;
+		//! Type of the mapped values for the key-value pairs.
+		using mapped_type = T;
+		//! Type of the values stored in the map.
+		using value_type = std::pair<const Key, T>;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences (unused).
+		using difference_type = std::ptrdiff_t;
+		//! Type of compare used in key comparison.
+		using key_compare = Compare;
+		//! Type of allocator used.
+		using allocator_type = Allocator;
+		//! Type of references to values.
+		using reference = value_type&;
+		//! Type of constant references to values.
+		using const_reference = const value_type&;
+		
+		//! Constructs an empty container.
+		CompactTreeAVL();
+		//! Constructs an empty container. Receives the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		explicit CompactTreeAVL(const Compare& comp, const Allocator& alloc = Allocator());
+		//! Constructs an empty container. Receives the allocator to use for all memory allocations.
+		explicit CompactTreeAVL(const Allocator& alloc);
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		template <class InputIt> CompactTreeAVL(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! Constructs the container with the contents of the initializer list init. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		CompactTreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! Copy constructor. Constructs the container with the copy of the contents of other. The nodes keep the same positions in the pool, so no comparison or rebalancing takes place.
+		CompactTreeAVL(const CompactTreeAVL& other);
+		//! Move constructor. Constructs the container with the contents of other using move semantics. After the move, other is guaranteed to be empty().
+		CompactTreeAVL(CompactTreeAVL&& other) noexcept;
+		//! Destructs the map. The destructors of the elements are called and the used storage is deallocated.
+		~CompactTreeAVL();
+		
+		// Assignment
+		//! Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		CompactTreeAVL& operator=(const CompactTreeAVL& other);
+		//! Move assignment operator. Replaces the contents with those of other using move semantics. After the move, other is guaranteed to be empty().
+		CompactTreeAVL& operator=(CompactTreeAVL&& other) noexcept;
+		//! Replaces the contents with those identified by initializer list ilist.
+		CompactTreeAVL& operator=(std::initializer_list<std::pair<const Key, T>> ilist);
+		
+		// Get allocator
+		//! Returns the allocator associated with the container.
+		Allocator get_allocator() const noexcept;
+		
+		// Element access
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		T& at(const Key& key);
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		const T& at(const Key& key) const;
+		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		T& operator[](const Key& key);
+		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		T& operator[](Key&& key);
+		
+		// Iterators
+		//! iterator is an object that allows iteration of the container in the order of the sorted keys. It keeps the container and the Index of its node, and the ancestors of the node if Parents is false. Beware that erasing the element it points at invalidates the iterator, and any insertion or removal does if Parents is false.
+		struct iterator : public iterator_actions{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = std::pair<const Key, T>*;
+			//! Type of references to values.
+			using reference = std::pair<const Key, T>&;
+			//! Constructs an iterator that does not point at any container.
+			iterator();
+			//! References the key-value pair pointed at by the iterator.
+			std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			iterator operator--(int);
+			private:
+				friend class CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>;
+				iterator(const iterator_actions& position);
+		};
+		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only. It keeps the container and the Index of its node, and the ancestors of the node if Parents is false. Beware that erasing the element it points at invalidates the iterator, and any insertion or removal does if Parents is false.
+		struct const_iterator : public iterator_actions{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = const std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = const std::pair<const Key, T>*;
+			//! Type of references to values.
+			using reference = const std::pair<const Key, T>&;
+			//! Constructs an iterator that does not point at any container.
+			const_iterator();
+			//! Constructs a constant iterator pointing at the same element as it.
+			const_iterator(const iterator& it);
+			//! References the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator operator--(int);
+			private:
+				friend class CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>;
+				const_iterator(const iterator_actions& position);
+		};
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		iterator begin() noexcept;
+		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator begin() const noexcept;
+		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator cbegin() const noexcept;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		iterator end() noexcept;
+		//! Returns a constant iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator end() const noexcept;
+		//! Returns a constant iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator cend() const noexcept;
+		
+		// Capacity
+		//! Checks if the container has no elements, i.e. whether begin() == end().
+		bool empty() const noexcept;
+		//! Returns the number of elements in the container.
+		std::size_t size() const noexcept;
+		//! Returns the maximum number of elements the container is able to hold with its Index type.
+		std::size_t max_size() const noexcept;
+		//! Returns the total space in memory, including the nodes of the pool that are not in use.
+		std::size_t memory() const noexcept;
+		//! Allocates the chunks needed to hold at least n elements without further allocations.
+		void reserve(std::size_t n);
+		
+		// Modifiers
+		//! Erases all elements from the container and releases the pool. After this call, size() returns zero. Invalidates any references, pointers, or iterators referring to contained elements.
+		void clear() noexcept;
+		//! Inserts value into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place. If the container already holds max_size() elements, an exception of type std::length_error is thrown.
+		std::pair<iterator, bool> insert(const std::pair<const Key, T>& value);
+		//! Inserts value into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place. If the container already holds max_size() elements, an exception of type std::length_error is thrown.
+		std::pair<iterator, bool> insert(std::pair<const Key, T>&& value);
+		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		template <class InputIt> void insert(InputIt first, InputIt last);
+		//! Inserts elements from initializer list ilist. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		void insert(std::initializer_list<std::pair<const Key, T>> ilist);
+		//! If a key equivalent to k already exists in the container, assigns std::forward<M>(obj) to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert. Returns a pair consisting of an iterator to the element and a bool denoting whether the insertion took place.
+		template <class M> std::pair<iterator, bool> insert_or_assign(const Key& k, M&& obj);
+		//! Removes the element at pos from the container. Returns the iterator following the removed element. The other elements keep their nodes, so only the iterators to the removed element are invalidated if Parents is true.
+		iterator erase(iterator pos);
+		//! Removes the element at pos from the container. Returns the iterator following the removed element. The other elements keep their nodes, so only the iterators to the removed element are invalidated if Parents is true.
+		iterator erase(const_iterator pos);
+		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
+		template <class K> std::size_t erase(const K& key);
+		
+		// Lookup
+		//! Returns the number of elements with key that compares equivalent to the specified argument, which is either 1 or 0 since this container does not allow duplicates.
+		template <class K> std::size_t count(const K& key) const;
+		//! Checks if there is an element with key that compares equivalent to the value of key.
+		template <class K> bool contains(const K& key) const;
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator find(const K& key);
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see cend()) iterator is returned.
+		template <class K> const_iterator find(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator lower_bound(const K& key);
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see cend()) iterator is returned.
+		template <class K> const_iterator lower_bound(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator upper_bound(const K& key);
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see cend()) iterator is returned.
+		template <class K> const_iterator upper_bound(const K& key) const;
+		
+		// Observers
+		//! Returns the function object that compares the keys, which is a copy of this container's constructor argument comp.
+		Compare key_comp() const;
+		
+		// Operators
+		//! Checks if the contents of lhs and rhs are equal, that is, they have the same number of elements and each element in lhs compares equal with the element in rhs at the same position.
+		template <class A, class B, class C, class D, std::unsigned_integral E, bool F> friend bool operator==(const CompactTreeAVL<A,B,C,D,E,F>& lhs, const CompactTreeAVL<A,B,C,D,E,F>& rhs);
+		
+		// Non-member
+		//! Specialized swapping function.
+		template <class A, class B, class C, class D, std::unsigned_integral E, bool F> friend void std::swap(CompactTreeAVL<A,B,C,D,E,F>& lhs, CompactTreeAVL<A,B,C,D,E,F>& rhs);
+		
+	private:
+		// Nested class NodeAVL, the element is only alive while the node is linked to the tree
+		struct NodeAVL{
+			Index children[2];
+			[[no_unique_address]] std::conditional_t<Parents, Index, Empty> parent;
+			union{
+				std::pair<const Key,T> data;
+			};
+			NodeAVL();
+			~NodeAVL();
+			inline Index child(bool right) const;
+			inline void link(bool right, Index node);
+			inline int balance() const;
+			inline void set_balance(int balance);
+		};
+		AllocatorNodes alloc;
+		Compare cmp;
+		Index root;
+		std::size_t counter;
+		// Pool
+		NodeAVL* chunks[max_chunks];
+		std::size_t used;
+		Index released;
+		inline NodeAVL* node(Index index) const;
+		inline static std::size_t chunk_size(unsigned chunk);
+		template <class... Args> Index create(Args&&... args);
+		inline void release(Index index);
+		void release_pool() noexcept;
+		void copy_pool(const CompactTreeAVL& other);
+		// Tree
+		template <class K> inline Index lower_node(const K& key) const;
+		template <class K> inline Index find_node(const K& key) const;
+		template <class Pred> iterator_actions search(Pred pred) const;
+		inline iterator_actions locate(Index index) const;
+		template <class K, class... Args> std::pair<Index, bool> get_forward(const K& key, Args&&... args);
+		void remove_node(Path& path);
+		inline void replace_child(Index parent, Index child, Index replacement);
+		inline void set_parent(Index index, Index parent);
+		inline Index rotation(Index index, bool right, Index parent);
+		std::pair<Index, bool> rebalance_node(Index index, int balance, Index parent);
+		void rebalance_insert(Path& path, Index index);
+		void rebalance_erase(Path& path, bool right);
+		// Iterator base structure
+		struct iterator_actions{
+			friend class CompactTreeAVL<Key,T,Compare,Allocator,Index,Parents>;
+			//! Checks whether both iterators point at the same element.
+			bool operator==(const iterator_actions& other) const;
+			//! Checks whether both iterators point at different elements.
+			bool operator!=(const iterator_actions& other) const;
+			protected:
+				const CompactTreeAVL* tree;
+				Index current;
+				[[no_unique_address]] std::conditional_t<Parents, Empty, Path> ancestors;
+				iterator_actions(const CompactTreeAVL* tree, Index current);
+				inline void descend(Index index, bool right);
+				inline void next_element();
+				inline void previous_element();
+		};
+};
+
+		}
+	}
+}
+
+#include "CompactTreeAVL.cpp"
+
+#endif
@@ -0,0 +1,536 @@
+#ifndef BPP_COLLECTIONS_MAP_CONCURRENTTREEAVL_CPP
+#define BPP_COLLECTIONS_MAP_CONCURRENTTREEAVL_CPP
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+// Empty initialization
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ConcurrentTreeAVL() :
+	root(0),
+	counter(0),
+	version(0),
+	epoch(0),
+	readers(),
+	graceParity(0){ }
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ConcurrentTreeAVL(const Compare& comp, const Allocator& alloc) :
+	alloc(alloc),
+	cmp(comp),
+	root(0),
+	counter(0),
+	version(0),
+	epoch(0),
+	readers(),
+	graceParity(0){ }
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ConcurrentTreeAVL(const Allocator& alloc) :
+	alloc(alloc),
+	root(0),
+	counter(0),
+	version(0),
+	epoch(0),
+	readers(),
+	graceParity(0){ }
+
+// Iterator initilization
+template <class Key, class T, class Compare, class Allocator> template <class InputIt> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ConcurrentTreeAVL(InputIt first, InputIt last, const Compare& comp, const Allocator& alloc) :
+	ConcurrentTreeAVL(comp, alloc){
+	this->insert(first, last);
+}
+
+// Initializer list initialization
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ConcurrentTreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp, const Allocator& alloc) :
+	ConcurrentTreeAVL(comp, alloc){
+	this->insert(ilist.begin(), ilist.end());
+}
+
+// Destructor
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::~ConcurrentTreeAVL(){
+	NodeAVL* node = this->root.load(std::memory_order_relaxed);
+	if(node){ this->destroy(node); }
+	for(auto it = this->retired.begin(); it != this->retired.end(); ++it){
+		std::destroy_at(*it);
+		this->alloc.deallocate(*it, 1);
+	}
+	for(auto it = this->grace.begin(); it != this->grace.end(); ++it){
+		std::destroy_at(*it);
+		this->alloc.deallocate(*it, 1);
+	}
+}
+
+// Get allocator
+template <class Key, class T, class Compare, class Allocator> Allocator ConcurrentTreeAVL<Key,T,Compare,Allocator>::get_allocator() const noexcept{
+	return this->alloc;
+}
+
+// Element access
+template <class Key, class T, class Compare, class Allocator> T ConcurrentTreeAVL<Key,T,Compare,Allocator>::at(const Key& key) const{
+	ReadGuard guard(this);
+	NodeAVL* node = this->search<false>([&](NodeAVL* n){ return !this->cmp(n->data.first, key); }).first;
+	if(!node || this->cmp(key, node->data.first)){ throw std::out_of_range("bpp::collections::map::ConcurrentTreeAVL::at"); }
+	return node->data.second;
+}
+
+// Iterators
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::const_iterator() :
+	current(0),
+	version(0){ }
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::const_iterator(ReadGuard&& guard, std::pair<NodeAVL*, uint64_t> position) :
+	guard(std::move(guard)),
+	current(position.first),
+	version(position.second){ }
+template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>& ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator*() const{
+	return this->current ? this->current->data : this->nullvalue;
+}
+template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>* ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator->() const{
+	return this->current ? &this->current->data : 0;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator& ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator++(){
+	// Steps through the parent links if no modification happened since the last step, otherwise searches again from the root
+	const ConcurrentTreeAVL* tree = this->guard.tree;
+	bool complete;
+	if(!this->current){ return *this; }
+	if(tree->version.load(std::memory_order_acquire) == this->version){
+		NodeAVL* next = next_node(this->current, complete);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(complete && tree->version.load(std::memory_order_relaxed) == this->version){
+			this->current = next;
+			return *this;
+		}
+	}
+	const Key& key = this->current->data.first;
+	std::pair<NodeAVL*, uint64_t> position = tree->template search<false>([&](NodeAVL* n){ return tree->cmp(key, n->data.first); });
+	this->current = position.first;
+	this->version = position.second;
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator++(int){
+	const_iterator pit(*this);
+	++(*this);
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator& ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator--(){
+	const ConcurrentTreeAVL* tree = this->guard.tree;
+	bool complete;
+	if(!this->current){ return *this; }
+	if(tree->version.load(std::memory_order_acquire) == this->version){
+		NodeAVL* previous = previous_node(this->current, complete);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(complete && tree->version.load(std::memory_order_relaxed) == this->version){
+			this->current = previous;
+			return *this;
+		}
+	}
+	const Key& key = this->current->data.first;
+	std::pair<NodeAVL*, uint64_t> position = tree->template search<true>([&](NodeAVL* n){ return tree->cmp(n->data.first, key); });
+	this->current = position.first;
+	this->version = position.second;
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator--(int){
+	const_iterator pit(*this);
+	--(*this);
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator==(const const_iterator& other) const{
+	return this->current == other.current;
+}
+template <class Key, class T, class Compare, class Allocator> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator!=(const const_iterator& other) const{
+	return this->current != other.current;
+}
+
+template <class Key, class T, class Compare, class Allocator> std::pair<const Key, T> ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator::nullvalue;
+
+// Iterator generation methods
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::begin() const{
+	ReadGuard guard(this);
+	std::pair<NodeAVL*, uint64_t> position = this->search<false>([](NodeAVL*){ return true; });
+	return position.first ? const_iterator(std::move(guard), position) : const_iterator();
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::cbegin() const{
+	return this->begin();
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::end() const noexcept{
+	return const_iterator();
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::cend() const noexcept{
+	return const_iterator();
+}
+
+// Capacity
+template <class Key, class T, class Compare, class Allocator> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::empty() const noexcept{
+	return this->counter.load(std::memory_order_relaxed) == 0;
+}
+template <class Key, class T, class Compare, class Allocator> std::size_t ConcurrentTreeAVL<Key,T,Compare,Allocator>::size() const noexcept{
+	return this->counter.load(std::memory_order_relaxed);
+}
+template <class Key, class T, class Compare, class Allocator> std::size_t ConcurrentTreeAVL<Key,T,Compare,Allocator>::memory() const noexcept{
+	return sizeof(ConcurrentTreeAVL) + this->counter.load(std::memory_order_relaxed)*sizeof(NodeAVL);
+}
+
+// Modifiers
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::clear(){
+	// The whole tree is unlinked at once and its nodes are retired
+	std::lock_guard<std::mutex> lock(this->writer);
+	NodeAVL *node = this->root.load(std::memory_order_relaxed), *next;
+	if(!node){ return; }
+	this->begin_write();
+	this->root.store(0, std::memory_order_release);
+	this->counter.store(0, std::memory_order_relaxed);
+	this->end_write();
+	while(node){
+		if(node->left()){
+			next = node->left();
+			node->children[0].store(0, std::memory_order_relaxed);
+		}else if(node->right()){
+			next = node->right();
+			node->children[1].store(0, std::memory_order_relaxed);
+		}else{
+			next = node->up();
+			this->retire(node);
+		}
+		node = next;
+	}
+	this->reclaim();
+}
+template <class Key, class T, class Compare, class Allocator> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::insert(const std::pair<const Key, T>& value){
+	return this->emplace(false, value.first, value);
+}
+template <class Key, class T, class Compare, class Allocator> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::insert(std::pair<const Key, T>&& value){
+	return this->emplace(false, value.first, std::move(value));
+}
+template <class Key, class T, class Compare, class Allocator> template <class InputIt> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::insert(InputIt first, InputIt last){
+	for(auto it = first; it != last; ++it){
+		this->emplace(false, it->first, *it);
+	}
+}
+template <class Key, class T, class Compare, class Allocator> template <class M> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::insert_or_assign(const Key& k, M&& obj){
+	return this->emplace(true, k, k, std::forward<M>(obj));
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> std::size_t ConcurrentTreeAVL<Key,T,Compare,Allocator>::erase(const K& key){
+	// Nodes with two children are replaced by their successor, which is relinked in their place
+	std::lock_guard<std::mutex> lock(this->writer);
+	NodeAVL *node = this->root.load(std::memory_order_relaxed), *successor, *child, *from;
+	while(node && (this->cmp(key, node->data.first) || this->cmp(node->data.first, key))){
+		node = this->cmp(key, node->data.first) ? node->left() : node->right();
+	}
+	if(!node){ return 0; }
+	this->begin_write();
+	if(node->left() && node->right()){
+		successor = node->right();
+		while(successor->left()){ successor = successor->left(); }
+		if(successor->up() != node){
+			from = successor->up();
+			child = successor->right();
+			from->children[0].store(child, std::memory_order_release);
+			if(child){ child->parent.store(from, std::memory_order_release); }
+			successor->children[1].store(node->right(), std::memory_order_release);
+			node->right()->parent.store(successor, std::memory_order_release);
+		}else{
+			from = successor;
+		}
+		successor->children[0].store(node->left(), std::memory_order_release);
+		node->left()->parent.store(successor, std::memory_order_release);
+		successor->parent.store(node->up(), std::memory_order_release);
+		successor->height = node->height;
+		this->replace_child(node->up(), node, successor);
+	}else{
+		child = node->left() ? node->left() : node->right();
+		from = node->up();
+		if(child){ child->parent.store(from, std::memory_order_release); }
+		this->replace_child(from, node, child);
+	}
+	if(from){ this->rebalance(from); }
+	this->counter.fetch_sub(1, std::memory_order_relaxed);
+	this->end_write();
+	this->retire(node);
+	this->reclaim();
+	return 1;
+}
+
+// Lookup
+template <class Key, class T, class Compare, class Allocator> template <class K> std::size_t ConcurrentTreeAVL<Key,T,Compare,Allocator>::count(const K& key) const{
+	return this->contains(key) ? 1 : 0;
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::contains(const K& key) const{
+	ReadGuard guard(this);
+	NodeAVL* node = this->search<false>([&](NodeAVL* n){ return !this->cmp(n->data.first, key); }).first;
+	return node && !this->cmp(key, node->data.first);
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::find(const K& key) const{
+	ReadGuard guard(this);
+	std::pair<NodeAVL*, uint64_t> position = this->search<false>([&](NodeAVL* n){ return !this->cmp(n->data.first, key); });
+	if(!position.first || this->cmp(key, position.first->data.first)){ return const_iterator(); }
+	return const_iterator(std::move(guard), position);
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::lower_bound(const K& key) const{
+	ReadGuard guard(this);
+	std::pair<NodeAVL*, uint64_t> position = this->search<false>([&](NodeAVL* n){ return !this->cmp(n->data.first, key); });
+	return position.first ? const_iterator(std::move(guard), position) : const_iterator();
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::const_iterator ConcurrentTreeAVL<Key,T,Compare,Allocator>::upper_bound(const K& key) const{
+	ReadGuard guard(this);
+	std::pair<NodeAVL*, uint64_t> position = this->search<false>([&](NodeAVL* n){ return this->cmp(key, n->data.first); });
+	return position.first ? const_iterator(std::move(guard), position) : const_iterator();
+}
+
+// Nested class NodeAVL
+template <class Key, class T, class Compare, class Allocator> template <class... Args> ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL::NodeAVL(Args&&... args) :
+	parent(0),
+	children{0, 0},
+	data(std::forward<Args>(args)...),
+	height(1){ }
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL::left() const{
+	return this->children[0].load(std::memory_order_acquire);
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL::right() const{
+	return this->children[1].load(std::memory_order_acquire);
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL::child(bool right) const{
+	return this->children[right].load(std::memory_order_acquire);
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL::up() const{
+	return this->parent.load(std::memory_order_acquire);
+}
+
+// Nested struct ReadGuard
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ReadGuard::ReadGuard() :
+	tree(0),
+	slot(0),
+	parity(0){ }
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ReadGuard::ReadGuard(const ConcurrentTreeAVL* tree) :
+	tree(tree),
+	slot(slot_index()){
+	// The registration is only valid if the epoch did not change meanwhile, otherwise the writer may have missed it
+	uint64_t current;
+	do{
+		current = tree->epoch.load();
+		this->parity = current & 1;
+		tree->readers[this->slot].count[this->parity].fetch_add(1);
+		if(tree->epoch.load() == current){ break; }
+		tree->readers[this->slot].count[this->parity].fetch_sub(1);
+	}while(true);
+}
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ReadGuard::ReadGuard(const ReadGuard& other) :
+	tree(other.tree),
+	slot(other.slot),
+	parity(other.parity){
+	if(this->tree){ this->tree->readers[this->slot].count[this->parity].fetch_add(1); }
+}
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ReadGuard::ReadGuard(ReadGuard&& other) noexcept :
+	tree(other.tree),
+	slot(other.slot),
+	parity(other.parity){
+	other.tree = 0;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::ReadGuard& ConcurrentTreeAVL<Key,T,Compare,Allocator>::ReadGuard::operator=(ReadGuard other) noexcept{
+	std::swap(this->tree, other.tree);
+	std::swap(this->slot, other.slot);
+	std::swap(this->parity, other.parity);
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator> ConcurrentTreeAVL<Key,T,Compare,Allocator>::ReadGuard::~ReadGuard(){
+	if(this->tree){ this->tree->readers[this->slot].count[this->parity].fetch_sub(1); }
+}
+
+// Private members
+// Readers
+template <class Key, class T, class Compare, class Allocator> template <bool Right, class Pred> std::pair<typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL*, uint64_t> ConcurrentTreeAVL<Key,T,Compare,Allocator>::search(Pred pred) const{
+	// Optimistic search validated against the version, after too many conflicts the writer lock is taken
+	NodeAVL* result;
+	uint64_t current;
+	bool complete;
+	for(std::size_t attempt = 0; attempt < search_retries; ++attempt){
+		current = this->version.load(std::memory_order_acquire);
+		if(current & 1){
+			std::this_thread::yield();
+			continue;
+		}
+		result = this->walk<Right>(pred, complete);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(complete && this->version.load(std::memory_order_relaxed) == current){ return std::pair<NodeAVL*, uint64_t>(result, current); }
+	}
+	std::lock_guard<std::mutex> lock(this->writer);
+	result = this->walk<Right>(pred, complete);
+	return std::pair<NodeAVL*, uint64_t>(result, this->version.load(std::memory_order_relaxed));
+}
+template <class Key, class T, class Compare, class Allocator> template <bool Right, class Pred> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::walk(Pred pred, bool& complete) const{
+	// Returns the last node satisfying pred when descending towards the Right (or left) of the nodes that satisfy it, the child is indexed instead of branching on pred
+	NodeAVL *node = this->root.load(std::memory_order_acquire), *result = 0;
+	std::size_t steps = 0;
+	bool side;
+	while(node && ++steps < search_steps){
+		side = pred(node);
+		result = side ? node : result;
+		node = node->child(side == Right);
+	}
+	complete = !node;
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::next_node(NodeAVL* node, bool& complete){
+	NodeAVL* tmp;
+	std::size_t steps = 0;
+	if((tmp = node->right())){
+		node = tmp;
+		while((tmp = node->left()) && ++steps < search_steps){ node = tmp; }
+	}else{
+		while((tmp = node->up()) && tmp->right() == node && ++steps < search_steps){ node = tmp; }
+		node = tmp;
+	}
+	complete = steps < search_steps;
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::previous_node(NodeAVL* node, bool& complete){
+	NodeAVL* tmp;
+	std::size_t steps = 0;
+	if((tmp = node->left())){
+		node = tmp;
+		while((tmp = node->right()) && ++steps < search_steps){ node = tmp; }
+	}else{
+		while((tmp = node->up()) && tmp->left() == node && ++steps < search_steps){ node = tmp; }
+		node = tmp;
+	}
+	complete = steps < search_steps;
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator> std::size_t ConcurrentTreeAVL<Key,T,Compare,Allocator>::slot_index(){
+	static std::atomic<std::size_t> threads(0);
+	thread_local std::size_t slot = threads.fetch_add(1, std::memory_order_relaxed) % reader_slots;
+	return slot;
+}
+// Writer
+template <class Key, class T, class Compare, class Allocator> template <class K, class... Args> bool ConcurrentTreeAVL<Key,T,Compare,Allocator>::emplace(bool assign, const K& key, Args&&... args){
+	// The node is constructed before entering the write section, so that readers are only invalidated while relinking
+	std::lock_guard<std::mutex> lock(this->writer);
+	NodeAVL *node = this->root.load(std::memory_order_relaxed), *parent = 0, *created;
+	while(node && (this->cmp(key, node->data.first) || this->cmp(node->data.first, key))){
+		parent = node;
+		node = this->cmp(key, node->data.first) ? node->left() : node->right();
+	}
+	if(node && !assign){ return false; }
+	created = this->alloc.allocate(1);
+	try{
+		std::construct_at(created, std::forward<Args>(args)...);
+	}catch(...){
+		this->alloc.deallocate(created, 1);
+		throw;
+	}
+	this->begin_write();
+	if(node){
+		created->children[0].store(node->left(), std::memory_order_relaxed);
+		created->children[1].store(node->right(), std::memory_order_relaxed);
+		created->parent.store(node->up(), std::memory_order_relaxed);
+		created->height = node->height;
+		if(node->left()){ node->left()->parent.store(created, std::memory_order_release); }
+		if(node->right()){ node->right()->parent.store(created, std::memory_order_release); }
+		this->replace_child(node->up(), node, created);
+	}else{
+		created->parent.store(parent, std::memory_order_relaxed);
+		if(!parent){
+			this->root.store(created, std::memory_order_release);
+		}else if(this->cmp(key, parent->data.first)){
+			parent->children[0].store(created, std::memory_order_release);
+		}else{
+			parent->children[1].store(created, std::memory_order_release);
+		}
+		if(parent){ this->rebalance(parent); }
+		this->counter.fetch_add(1, std::memory_order_relaxed);
+	}
+	this->end_write();
+	if(node){
+		this->retire(node);
+		this->reclaim();
+	}
+	return !node;
+}
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::begin_write(){
+	this->version.store(this->version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::end_write(){
+	this->version.store(this->version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::replace_child(NodeAVL* parent, NodeAVL* child, NodeAVL* replacement){
+	if(!parent){
+		this->root.store(replacement, std::memory_order_release);
+	}else if(parent->left() == child){
+		parent->children[0].store(replacement, std::memory_order_release);
+	}else{
+		parent->children[1].store(replacement, std::memory_order_release);
+	}
+}
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::rebalance(NodeAVL* node){
+	while(node){
+		std::size_t lz = height_of(node->left()), rz = height_of(node->right());
+		if(lz > rz + 1){
+			if(height_of(node->left()->right()) > height_of(node->left()->left())){ this->rotation_left(node->left()); }
+			node = this->rotation_right(node);
+		}else if(rz > lz + 1){
+			if(height_of(node->right()->left()) > height_of(node->right()->right())){ this->rotation_right(node->right()); }
+			node = this->rotation_left(node);
+		}else{
+			node->height = (lz > rz ? lz : rz) + 1;
+		}
+		node = node->up();
+	}
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::rotation_left(NodeAVL* node){
+	NodeAVL *result = node->right(), *inner = result->left(), *parent = node->up();
+	node->children[1].store(inner, std::memory_order_release);
+	if(inner){ inner->parent.store(node, std::memory_order_release); }
+	result->children[0].store(node, std::memory_order_release);
+	result->parent.store(parent, std::memory_order_release);
+	node->parent.store(result, std::memory_order_release);
+	this->replace_child(parent, node, result);
+	node->height = (height_of(node->left()) > height_of(inner) ? height_of(node->left()) : height_of(inner)) + 1;
+	result->height = (node->height > height_of(result->right()) ? node->height : height_of(result->right())) + 1;
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator> typename ConcurrentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* ConcurrentTreeAVL<Key,T,Compare,Allocator>::rotation_right(NodeAVL* node){
+	NodeAVL *result = node->left(), *inner = result->right(), *parent = node->up();
+	node->children[0].store(inner, std::memory_order_release);
+	if(inner){ inner->parent.store(node, std::memory_order_release); }
+	result->children[1].store(node, std::memory_order_release);
+	result->parent.store(parent, std::memory_order_release);
+	node->parent.store(result, std::memory_order_release);
+	this->replace_child(parent, node, result);
+	node->height = (height_of(node->right()) > height_of(inner) ? height_of(node->right()) : height_of(inner)) + 1;
+	result->height = (node->height > height_of(result->left()) ? node->height : height_of(result->left())) + 1;
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator> std::size_t ConcurrentTreeAVL<Key,T,Compare,Allocator>::height_of(NodeAVL* node){
+	return node ? node->height : 0;
+}
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::retire(NodeAVL* node){
+	this->retired.push_back(node);
+}
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::reclaim(){
+	// Nodes retired during an epoch are released once every reader registered on that epoch has finished, then the epoch advances
+	std::size_t active = 0;
+	if(!this->grace.empty()){
+		for(std::size_t i = 0; i < reader_slots; ++i){ active += this->readers[i].count[this->graceParity].load(); }
+		if(active){ return; }
+		for(auto it = this->grace.begin(); it != this->grace.end(); ++it){
+			std::destroy_at(*it);
+			this->alloc.deallocate(*it, 1);
+		}
+		this->grace.clear();
+	}
+	if(!this->retired.empty()){
+		this->grace.swap(this->retired);
+		this->graceParity = this->epoch.load() & 1;
+		this->epoch.fetch_add(1);
+	}
+}
+template <class Key, class T, class Compare, class Allocator> void ConcurrentTreeAVL<Key,T,Compare,Allocator>::destroy(NodeAVL* node){
+	NodeAVL *left = node->left(), *right = node->right();
+	if(left){ this->destroy(left); }
+	if(right){ this->destroy(right); }
+	std::destroy_at(node);
+	this->alloc.deallocate(node, 1);
+}
+
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef BPP_COLLECTIONS_MAP_CONCURRENTTREEAVL_H
+#define BPP_COLLECTIONS_MAP_CONCURRENTTREEAVL_H
+#include <atomic>			// std::atomic<>, std::atomic_thread_fence
+#include <cstdint>			// uint64_t
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list<>
+#include <iterator>			// std::bidirectional_iterator_tag
+#include <memory>			// std::allocator<>, std::allocator_traits<>, std::construct_at, std::destroy_at
+#include <mutex>			// std::mutex, std::lock_guard<>
+#include <stdexcept>		// std::out_of_range
+#include <thread>			// std::this_thread::yield
+#include <utility>			// std::pair, std::move, std::forward
+#include <vector>			// std::vector<>
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+//! ConcurrentTreeAVL is a sorted associative container that contains key-value pairs with unique keys, which can be read by any number of threads while it is being modified. Keys are sorted by using the comparison function Compare. Search, removal, and insertion operations have logarithmic complexity. This is an implementation of an Adelson-Velsky and Landis Tree.
+//! Modifications are serialized between them by an internal mutex. Readers are optimistic: every search is validated against a version counter that the writer increments around each modification, and it is retried if a modification overlapped with it. After a few failed attempts the reader takes the writer lock instead, so under heavy write contention readers may block behind the writer. The elements of a node are never modified once it is linked to the tree, assigning a value replaces the node instead. Removed nodes are only deallocated once every reader that could still reach them has finished.
+template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>> class ConcurrentTreeAVL{
+	private:
+		struct NodeAVL;
+		struct ReadGuard;
+		// Rebind Allocator
+		using AllocatorNodes = typename std::allocator_traits<Allocator>::rebind_alloc<NodeAVL>;
+		// Reader registration
+		static constexpr std::size_t reader_slots = 16;
+		static constexpr std::size_t search_retries = 8;
+		static constexpr std::size_t search_steps = 128;
+	public:
+		// Declares member types
+		//! Type of the keys for the key-value pairs.
+		using key_type = Key;
+		//! Type of the mapped values for the key-value pairs.
+		using mapped_type = T;
+		//! Type of the values stored in the map.
+		using value_type = std::pair<const Key, T>;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences (unused).
+		using difference_type = std::ptrdiff_t;
+		//! Type of compare used in key comparison.
+		using key_compare = Compare;
+		//! Type of allocator used.
+		using allocator_type = Allocator;
+		//! Type of references to values.
+		using reference = value_type&;
+		//! Type of constant references to values.
+		using const_reference = const value_type&;
+		
+		//! Constructs an empty container.
+		ConcurrentTreeAVL();
+		//! Constructs an empty container. Receives the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		explicit ConcurrentTreeAVL(const Compare& comp, const Allocator& alloc = Allocator());
+		//! Constructs an empty container. Receives the allocator to use for all memory allocations.
+		explicit ConcurrentTreeAVL(const Allocator& alloc);
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		template <class InputIt> ConcurrentTreeAVL(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! Constructs the container with the contents of the initializer list init. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		ConcurrentTreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! The container can not be copied, since it may be modified while being read.
+		ConcurrentTreeAVL(const ConcurrentTreeAVL& other) = delete;
+		//! The container can not be copied, since it may be modified while being read.
+		ConcurrentTreeAVL& operator=(const ConcurrentTreeAVL& other) = delete;
+		//! Destructs the map. The destructors of the elements are called and the used storage is deallocated. No other thread may be accessing the container or holding any of its iterators.
+		~ConcurrentTreeAVL();
+		
+		// Get allocator
+		//! Returns the allocator associated with the container.
+		Allocator get_allocator() const noexcept;
+		
+		// Element access
+		//! Returns a copy of the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown. Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		T at(const Key& key) const;
+		
+		// Iterators
+		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only. The iterator keeps the element it points at alive, even if it is removed from the container, and can be used while the container is modified: if a modification happened since its last step, the next step searches again for the element that follows the key of the current one. Holding iterators for a long time delays the deallocation of removed nodes.
+		struct const_iterator{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = const std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = const std::pair<const Key, T>*;
+			//! Type of references to values.
+			using reference = const std::pair<const Key, T>&;
+			//! Constructs an iterator equal to end().
+			const_iterator();
+			//! References the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator operator--(int);
+			//! Checks whether both iterators point at the same node.
+			bool operator==(const const_iterator& other) const;
+			//! Checks whether both iterators point at different nodes.
+			bool operator!=(const const_iterator& other) const;
+			private:
+				friend class ConcurrentTreeAVL<Key,T,Compare,Allocator>;
+				ReadGuard guard;
+				NodeAVL* current;
+				uint64_t version;
+				static std::pair<const Key, T> nullvalue;
+				const_iterator(ReadGuard&& guard, std::pair<NodeAVL*, uint64_t> position);
+		};
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end(). Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		const_iterator begin() const;
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end(). Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		const_iterator cbegin() const;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator end() const noexcept;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator cend() const noexcept;
+		
+		// Capacity
+		//! Checks if the container has no elements.
+		bool empty() const noexcept;
+		//! Returns the number of elements in the container.
+		std::size_t size() const noexcept;
+		//! Returns the total space in memory, without the removed nodes awaiting deallocation.
+		std::size_t memory() const noexcept;
+		
+		// Modifiers
+		//! Erases all elements from the container. After this call, size() returns zero. The nodes are deallocated once no reader can reach them.
+		void clear();
+		//! Inserts value into the container, if the container doesn't already contain an element with an equivalent key. Returns whether the insertion took place.
+		bool insert(const std::pair<const Key, T>& value);
+		//! Inserts value into the container, if the container doesn't already contain an element with an equivalent key. Returns whether the insertion took place.
+		bool insert(std::pair<const Key, T>&& value);
+		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		template <class InputIt> void insert(InputIt first, InputIt last);
+		//! If a key equivalent to k already exists in the container, replaces its element by one with the mapped value obj. If the key does not exist, inserts the new value as if by insert. Returns whether the insertion took place.
+		template <class M> bool insert_or_assign(const Key& k, M&& obj);
+		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
+		template <class K> std::size_t erase(const K& key);
+		
+		// Lookup
+		//! Returns the number of elements with key that compares equivalent to the specified argument, which is either 1 or 0 since this container does not allow duplicates. Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		template <class K> std::size_t count(const K& key) const;
+		//! Checks if there is an element with key that compares equivalent to the value of key. Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		template <class K> bool contains(const K& key) const;
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned. Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		template <class K> const_iterator find(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned. Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		template <class K> const_iterator lower_bound(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see end()) iterator is returned. Optimistic: does not take any lock unless modifications keep overlapping with it, in which case it waits for the writer lock.
+		template <class K> const_iterator upper_bound(const K& key) const;
+		
+	private:
+		// Nested class NodeAVL
+		struct NodeAVL{
+			std::atomic<NodeAVL*> parent, children[2];
+			const std::pair<const Key,T> data;
+			std::size_t height;
+			template <class... Args> NodeAVL(Args&&... args);
+			inline NodeAVL* left() const;
+			inline NodeAVL* right() const;
+			inline NodeAVL* child(bool right) const;
+			inline NodeAVL* up() const;
+		};
+		// Nested struct ReadGuard, registers a reader in the current epoch
+		struct ReadGuard{
+			ReadGuard();
+			ReadGuard(const ConcurrentTreeAVL* tree);
+			ReadGuard(const ReadGuard& other);
+			ReadGuard(ReadGuard&& other) noexcept;
+			ReadGuard& operator=(ReadGuard other) noexcept;
+			~ReadGuard();
+			const ConcurrentTreeAVL* tree;
+			std::size_t slot, parity;
+		};
+		// Reader counters for each parity of the epoch, spread over several cache lines
+		struct alignas(64) ReaderSlot{
+			std::atomic<std::size_t> count[2];
+		};
+		AllocatorNodes alloc;
+		Compare cmp;
+		std::atomic<NodeAVL*> root;
+		std::atomic<std::size_t> counter;
+		std::atomic<uint64_t> version, epoch;
+		mutable ReaderSlot readers[reader_slots];
+		mutable std::mutex writer;
+		std::vector<NodeAVL*> retired, grace;
+		std::size_t graceParity;
+		// Readers
+		template <bool Right, class Pred> std::pair<NodeAVL*, uint64_t> search(Pred pred) const;
+		template <bool Right, class Pred> inline NodeAVL* walk(Pred pred, bool& complete) const;
+		inline static NodeAVL* next_node(NodeAVL* node, bool& complete);
+		inline static NodeAVL* previous_node(NodeAVL* node, bool& complete);
+		inline static std::size_t slot_index();
+		// Writer
+		template <class K, class... Args> bool emplace(bool assign, const K& key, Args&&... args);
+		inline void begin_write();
+		inline void end_write();
+		inline void replace_child(NodeAVL* parent, NodeAVL* child, NodeAVL* replacement);
+		void rebalance(NodeAVL* node);
+		inline NodeAVL* rotation_left(NodeAVL* node);
+		inline NodeAVL* rotation_right(NodeAVL* node);
+		inline static std::size_t height_of(NodeAVL* node);
+		inline void retire(NodeAVL* node);
+		void reclaim();
+		inline void destroy(NodeAVL* node);
+};
+
+		}
+	}
+}
+
+#include "ConcurrentTreeAVL.cpp"
+
+#endif
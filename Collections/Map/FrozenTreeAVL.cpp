@@ -0,0 +1,223 @@
+#ifndef BPP_COLLECTIONS_MAP_FROZENTREEAVL_CPP
+#define BPP_COLLECTIONS_MAP_FROZENTREEAVL_CPP
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+// Empty initialization
+template <class Key, class T, class Compare> FrozenTreeAVL<Key,T,Compare>::FrozenTreeAVL() :
+	elements(0),
+	counter(0){ }
+
+// Image initialization
+template <class Key, class T, class Compare> FrozenTreeAVL<Key,T,Compare>::FrozenTreeAVL(const void* image, std::size_t bytes, const Compare& comp) :
+	cmp(comp),
+	elements(0),
+	counter(0){
+	// The header must match the one this instantiation would write for the same number of elements
+	Header head, expected;
+	if(bytes < header_size){ throw std::invalid_argument("bpp::collections::map::FrozenTreeAVL::FrozenTreeAVL"); }
+	std::memcpy(&head, image, sizeof(Header));
+	expected = header(head.count);
+	if(std::memcmp(&head, &expected, sizeof(Header)) || head.count > (bytes - header_size) / sizeof(value_type) || ((uintptr_t) image + header_size) % alignof(value_type)){
+		throw std::invalid_argument("bpp::collections::map::FrozenTreeAVL::FrozenTreeAVL");
+	}
+	this->elements = (const value_type*) ((const unsigned char*) image + header_size);
+	this->counter = head.count;
+}
+
+// Image generation
+template <class Key, class T, class Compare> constexpr std::size_t FrozenTreeAVL<Key,T,Compare>::image_size(std::size_t n) noexcept{
+	return header_size + n * sizeof(value_type);
+}
+template <class Key, class T, class Compare> template <class Buff, std::forward_iterator ForwardIt> std::size_t FrozenTreeAVL<Key,T,Compare>::freeze(Buff& buffer, ForwardIt first, ForwardIt last, const Compare& comp){
+	// The image is laid out in memory first, since the positions of the implicit tree are visited out of order by its in-order traversal
+	std::size_t n = 0;
+	for(ForwardIt it = first, prev = first; it != last; prev = it, ++it, ++n){
+		if(n && !comp(prev->first, it->first)){ throw std::invalid_argument("bpp::collections::map::FrozenTreeAVL::freeze"); }
+	}
+	std::vector<unsigned char> storage(image_size(n));
+	Header head = header(n);
+	std::memcpy(storage.data(), &head, sizeof(Header));
+	fill(storage.data() + header_size, 1, n, first);
+	buffer.write((const char*) storage.data(), storage.size());
+	return storage.size();
+}
+template <class Key, class T, class Compare> template <class Buff, std::ranges::forward_range Map> std::size_t FrozenTreeAVL<Key,T,Compare>::freeze(Buff& buffer, const Map& map, const Compare& comp){
+	return freeze(buffer, std::ranges::begin(map), std::ranges::end(map), comp);
+}
+
+// Element access
+template <class Key, class T, class Compare> template <class K> const T& FrozenTreeAVL<Key,T,Compare>::at(const K& key) const{
+	const_iterator it = this->find(key);
+	if(it == this->end()){ throw std::out_of_range("bpp::collections::map::FrozenTreeAVL::at"); }
+	return it->second;
+}
+
+// Iterators
+// Constant Iterator
+template <class Key, class T, class Compare> FrozenTreeAVL<Key,T,Compare>::const_iterator::const_iterator() :
+	elements(0),
+	counter(0),
+	position(0){ }
+template <class Key, class T, class Compare> FrozenTreeAVL<Key,T,Compare>::const_iterator::const_iterator(const value_type* elements, std::size_t counter, std::size_t position) :
+	elements(elements),
+	counter(counter),
+	position(position){ }
+template <class Key, class T, class Compare> const std::pair<const Key, T>& FrozenTreeAVL<Key,T,Compare>::const_iterator::operator*() const{
+	return this->elements[this->position-1];
+}
+template <class Key, class T, class Compare> const std::pair<const Key, T>* FrozenTreeAVL<Key,T,Compare>::const_iterator::operator->() const{
+	return &this->elements[this->position-1];
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator& FrozenTreeAVL<Key,T,Compare>::const_iterator::operator++(){
+	// The successor is the leftmost position of the right subtree, or the parent of the last left child on the way up (0 past the root)
+	if(2*this->position+1 <= this->counter){
+		this->position = 2*this->position+1;
+		while(2*this->position <= this->counter){ this->position *= 2; }
+	}else{
+		this->position >>= std::countr_one(this->position) + 1;
+	}
+	return *this;
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::const_iterator::operator++(int){
+	const_iterator pit(*this);
+	++(*this);
+	return pit;
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator& FrozenTreeAVL<Key,T,Compare>::const_iterator::operator--(){
+	// The predecessor is the rightmost position of the left subtree, or the parent of the last right child on the way up (0 past the root)
+	if(!this->position){
+		this->position = this->counter ? 1 : 0;
+		while(this->position && 2*this->position+1 <= this->counter){ this->position = 2*this->position+1; }
+	}else if(2*this->position <= this->counter){
+		this->position = 2*this->position;
+		while(2*this->position+1 <= this->counter){ this->position = 2*this->position+1; }
+	}else{
+		this->position >>= std::countr_zero(this->position) + 1;
+	}
+	return *this;
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::const_iterator::operator--(int){
+	const_iterator pit(*this);
+	--(*this);
+	return pit;
+}
+template <class Key, class T, class Compare> bool FrozenTreeAVL<Key,T,Compare>::const_iterator::operator==(const const_iterator& other) const{
+	return this->position == other.position;
+}
+template <class Key, class T, class Compare> bool FrozenTreeAVL<Key,T,Compare>::const_iterator::operator!=(const const_iterator& other) const{
+	return this->position != other.position;
+}
+template <class Key, class T, class Compare> bool FrozenTreeAVL<Key,T,Compare>::const_iterator::operator==(std::default_sentinel_t) const{
+	return !this->position;
+}
+
+// Iterator generation methods
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::begin() const noexcept{
+	return const_iterator(this->elements, this->counter, this->counter ? std::bit_floor(this->counter) : 0);
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::cbegin() const noexcept{
+	return this->begin();
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::end() const noexcept{
+	return const_iterator(this->elements, this->counter, 0);
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::cend() const noexcept{
+	return this->end();
+}
+
+// Capacity
+template <class Key, class T, class Compare> bool FrozenTreeAVL<Key,T,Compare>::empty() const noexcept{
+	return !this->counter;
+}
+template <class Key, class T, class Compare> std::size_t FrozenTreeAVL<Key,T,Compare>::size() const noexcept{
+	return this->counter;
+}
+template <class Key, class T, class Compare> std::size_t FrozenTreeAVL<Key,T,Compare>::memory() const noexcept{
+	return this->elements ? image_size(this->counter) : 0;
+}
+
+// Lookup
+// Count
+template <class Key, class T, class Compare> template <class K> std::size_t FrozenTreeAVL<Key,T,Compare>::count(const K& key) const{
+	return this->contains(key) ? 1 : 0;
+}
+// Find
+template <class Key, class T, class Compare> template <class K> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::find(const K& key) const{
+	lookup_key<K> k = key;
+	std::size_t position = this->search<false>(k);
+	return const_iterator(this->elements, this->counter, (position && !this->cmp(k, this->elements[position-1].first)) ? position : 0);
+}
+// Contains
+template <class Key, class T, class Compare> template <class K> bool FrozenTreeAVL<Key,T,Compare>::contains(const K& key) const{
+	lookup_key<K> k = key;
+	std::size_t position = this->search<false>(k);
+	return position && !this->cmp(k, this->elements[position-1].first);
+}
+// Bounds
+template <class Key, class T, class Compare> template <class K> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::lower_bound(const K& key) const{
+	lookup_key<K> k = key;
+	return const_iterator(this->elements, this->counter, this->search<false>(k));
+}
+template <class Key, class T, class Compare> template <class K> typename FrozenTreeAVL<Key,T,Compare>::const_iterator FrozenTreeAVL<Key,T,Compare>::upper_bound(const K& key) const{
+	lookup_key<K> k = key;
+	return const_iterator(this->elements, this->counter, this->search<true>(k));
+}
+template <class Key, class T, class Compare> template <class K> std::pair<typename FrozenTreeAVL<Key,T,Compare>::const_iterator,typename FrozenTreeAVL<Key,T,Compare>::const_iterator> FrozenTreeAVL<Key,T,Compare>::equal_range(const K& key) const{
+	lookup_key<K> k = key;
+	return std::pair<const_iterator,const_iterator>(this->lower_bound(k), this->upper_bound(k));
+}
+
+// Observers
+template <class Key, class T, class Compare> Compare FrozenTreeAVL<Key,T,Compare>::key_comp() const{
+	return this->cmp;
+}
+
+// Private methods
+template <class Key, class T, class Compare> template <bool Upper, class K> std::size_t FrozenTreeAVL<Key,T,Compare>::search(const K& key) const{
+	// Descends to the position past a leaf, going right while the element is before key. The bound is the parent of the last left child taken, found by dropping the trailing right steps and the left one
+	std::size_t position = 1;
+	while(position <= this->counter){
+		if((position << prefetch_levels) <= this->counter){ prefetch(this->elements + (position << prefetch_levels) - 1); }
+		if constexpr(Upper){
+			position = 2*position + !this->cmp(key, this->elements[position-1].first);
+		}else{
+			position = 2*position + this->cmp(this->elements[position-1].first, key);
+		}
+	}
+	return position >> (std::countr_one(position) + 1);
+}
+template <class Key, class T, class Compare> template <class ForwardIt> void FrozenTreeAVL<Key,T,Compare>::fill(unsigned char* storage, std::size_t position, std::size_t n, ForwardIt& it){
+	// In-order traversal of the implicit tree, so the sorted elements are consumed in order
+	if(position > n){ return; }
+	fill(storage, 2*position, n, it);
+	value_type element(*it);
+	std::memcpy(storage + (position-1) * sizeof(value_type), &element, sizeof(value_type));
+	++it;
+	fill(storage, 2*position+1, n, it);
+}
+template <class Key, class T, class Compare> typename FrozenTreeAVL<Key,T,Compare>::Header FrozenTreeAVL<Key,T,Compare>::header(std::size_t n){
+	Header head;
+	std::memcpy(head.magic, image_magic, sizeof(head.magic));
+	head.order = byte_order;
+	head.version = image_version;
+	head.count = n;
+	head.elementSize = sizeof(value_type);
+	head.elementAlign = alignof(value_type);
+	head.keySize = sizeof(Key);
+	head.mappedSize = sizeof(T);
+	return head;
+}
+template <class Key, class T, class Compare> void FrozenTreeAVL<Key,T,Compare>::prefetch(const value_type* element){
+	#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(element);
+	#endif
+}
+
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef BPP_COLLECTIONS_MAP_FROZENTREEAVL_H
+#define BPP_COLLECTIONS_MAP_FROZENTREEAVL_H
+#include <bit>				// std::bit_floor, std::countr_one, std::countr_zero
+#include <cstdint>			// uint32_t, uint64_t, uintptr_t
+#include <cstring>			// std::memcpy, std::memcmp
+#include <functional>		// std::less
+#include <iterator>			// std::bidirectional_iterator_tag, std::forward_iterator, std::default_sentinel_t
+#include <memory>			// std::construct_at
+#include <ranges>			// std::ranges::forward_range, std::ranges::begin, std::ranges::end
+#include <stdexcept>		// std::out_of_range, std::invalid_argument
+#include <type_traits>		// std::conditional_t, std::is_same_v, std::is_trivially_copyable_v
+#include <utility>			// std::pair
+#include <vector>			// std::vector<>
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+//! FrozenTreeAVL is a read-only sorted associative container that contains key-value pairs with unique keys, stored in a flat image that holds no pointers and can be used in place wherever it is loaded. Keys are sorted by using the comparison function Compare. Search operations have logarithmic complexity.
+//! The image is written once by freeze() from any sorted range of elements (e.g. a TreeAVL) and consists of a 64-byte header followed by the elements in Eytzinger order: the implicit complete binary search tree of the elements stored level by level, where the children of the element at position k (counting from 1) are at positions 2k and 2k+1. Searches descend it without branches on the result of the comparisons and prefetch the elements four levels below, so consecutive levels share cache lines near the top of the tree.
+//! The container does not own the image, which must remain valid and unmodified while the container or any of its iterators are in use. Since it is never modified, the image can be written to a file and memory-mapped read-only by any number of processes, which share its physical pages and can search it as soon as it is mapped, without deserializing or allocating anything.
+//! Key and T must be trivially copyable and must not hold pointers or references to memory outside the element, and the image can only be read on machines with the same byte ordering and layout of the elements, which is checked when it is loaded.
+template <class Key, class T, class Compare = std::less<Key>> class FrozenTreeAVL{
+	private:
+		static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>, "FrozenTreeAVL requires trivially copyable keys and mapped values");
+		struct Header;
+		// Heterogeneous lookup, keys of other types are converted once to Key unless Compare is transparent
+		static constexpr bool transparent = requires{ typename Compare::is_transparent; };
+		template <class K> using lookup_key = std::conditional_t<transparent || std::is_same_v<K, Key>, const K&, const Key>;
+		// Image layout
+		static constexpr std::size_t header_size = 64;
+		static constexpr uint32_t image_version = 1;
+		static constexpr uint32_t byte_order = 0x01020304;
+		static constexpr char image_magic[8] = {'B','P','P','F','R','Z','N','\0'};
+		// Elements are prefetched this many positions ahead of the one compared (four levels below it)
+		static constexpr std::size_t prefetch_levels = 4;
+	public:
+		// Declares member types
+		//! Type of the keys for the key-value pairs.
+		using key_type = Key;
+		//! Type of the mapped values for the key-value pairs.
+		using mapped_type = T;
+		//! Type of the values stored in the map.
+		using value_type = std::pair<const Key, T>;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences (unused).
+		using difference_type = std::ptrdiff_t;
+		//! Type of compare used in key comparison.
+		using key_compare = Compare;
+		//! Type of references to values.
+		using reference = const value_type&;
+		//! Type of constant references to values.
+		using const_reference = const value_type&;
+		
+		//! Constructs an empty container.
+		FrozenTreeAVL();
+		//! Constructs the container over the image of size bytes that begins at image, written by freeze(). The image is not copied. Can receive the comparison function object to use for all comparisons of keys, which must order the keys as the one used by freeze(). If the image is truncated, misaligned for value_type or was written for other types or byte ordering, an exception of type std::invalid_argument is thrown. Constant complexity.
+		FrozenTreeAVL(const void* image, std::size_t bytes, const Compare& comp = Compare());
+		
+		// Image generation
+		//! Returns the size in bytes of the image of a container with n elements.
+		static constexpr std::size_t image_size(std::size_t n) noexcept;
+		//! Writes the image of the n elements of the range beginning at first to a stream-like buffer which supports the write(const char*, std::streamsize) method, e.g. a std::ofstream opened in binary mode. The elements must be sorted in strictly increasing order of keys, otherwise an exception of type std::invalid_argument is thrown before anything is written. Returns the number of bytes written, image_size(n). Linear complexity.
+		template <class Buff, std::forward_iterator ForwardIt> static std::size_t freeze(Buff& buffer, ForwardIt first, ForwardIt last, const Compare& comp = Compare());
+		//! Writes the image of the elements of map, which must be sorted in strictly increasing order of keys (e.g. a TreeAVL or std::map with the same Compare), to a stream-like buffer which supports the write(const char*, std::streamsize) method. Returns the number of bytes written. Linear complexity.
+		template <class Buff, std::ranges::forward_range Map> static std::size_t freeze(Buff& buffer, const Map& map, const Compare& comp = Compare());
+		
+		// Element access
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		template <class K> const T& at(const K& key) const;
+		
+		// Iterators
+		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only. It keeps the position of its element in the image, so it remains valid as long as the image does.
+		struct const_iterator{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = const std::pair<const Key, T>*;
+			//! Type of references to values.
+			using reference = const std::pair<const Key, T>&;
+			//! Constructs an iterator equal to end().
+			const_iterator();
+			//! References the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end(). Regressing end() points at the last element.
+			const_iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end(). Regressing end() points at the last element.
+			const_iterator operator--(int);
+			//! Checks whether both iterators point at the same element.
+			bool operator==(const const_iterator& other) const;
+			//! Checks whether both iterators point at different elements.
+			bool operator!=(const const_iterator& other) const;
+			//! Checks whether the iterator is past the last element.
+			bool operator==(std::default_sentinel_t) const;
+			private:
+				friend class FrozenTreeAVL<Key,T,Compare>;
+				const value_type* elements;
+				std::size_t counter, position;
+				const_iterator(const value_type* elements, std::size_t counter, std::size_t position);
+		};
+		//! The container is read-only, so iterator is the same as const_iterator.
+		using iterator = const_iterator;
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end(). Constant complexity.
+		const_iterator begin() const noexcept;
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end(). Constant complexity.
+		const_iterator cbegin() const noexcept;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator end() const noexcept;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator cend() const noexcept;
+		
+		// Capacity
+		//! Checks if the container has no elements, i.e. whether begin() == end().
+		bool empty() const noexcept;
+		//! Returns the number of elements in the container.
+		std::size_t size() const noexcept;
+		//! Returns the size in bytes of the image used by the container.
+		std::size_t memory() const noexcept;
+		
+		// Lookup
+		// Count
+		//! Returns the number of elements with key that compares equivalent to the specified argument, which is either 1 or 0 since this container does not allow duplicates.
+		template <class K> std::size_t count(const K& key) const;
+		// Find
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> const_iterator find(const K& key) const;
+		// Contains
+		//! Checks if there is an element with key that compares equivalent to the value of key.
+		template <class K> bool contains(const K& key) const;
+		// Bounds
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> const_iterator lower_bound(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> const_iterator upper_bound(const K& key) const;
+		//! Returns a range containing all elements with the given key in the container. The range is defined by two iterators, one pointing to the first element that is not less than key and another pointing to the first element greater than key.
+		template <class K> std::pair<const_iterator,const_iterator> equal_range(const K& key) const;
+		
+		// Observers
+		//! Returns the function object that compares the keys, which is a copy of this container's constructor argument comp.
+		Compare key_comp() const;
+		
+	private:
+		// Header of the image, written in the byte ordering of the machine
+		struct Header{
+			char magic[8];
+			uint32_t order, version;
+			uint64_t count, elementSize, elementAlign, keySize, mappedSize;
+		};
+		Compare cmp;
+		const value_type* elements;
+		std::size_t counter;
+		template <bool Upper, class K> inline std::size_t search(const K& key) const;
+		template <class ForwardIt> static void fill(unsigned char* storage, std::size_t position, std::size_t n, ForwardIt& it);
+		inline static Header header(std::size_t n);
+		inline static void prefetch(const value_type* element);
+};
+
+		}
+	}
+}
+
+#include "FrozenTreeAVL.cpp"
+
+#endif
@@ -0,0 +1,460 @@
+#ifndef BPP_COLLECTIONS_MAP_PERSISTENTTREEAVL_CPP
+#define BPP_COLLECTIONS_MAP_PERSISTENTTREEAVL_CPP
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+// Empty initialization
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::PersistentTreeAVL() :
+	root(0),
+	counter(0){ }
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::PersistentTreeAVL(const Compare& comp, const Allocator& alloc) :
+	alloc(alloc),
+	cmp(comp),
+	root(0),
+	counter(0){ }
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::PersistentTreeAVL(const Allocator& alloc) :
+	alloc(alloc),
+	root(0),
+	counter(0){ }
+
+// Iterator initilization
+template <class Key, class T, class Compare, class Allocator> template <class InputIt> PersistentTreeAVL<Key,T,Compare,Allocator>::PersistentTreeAVL(InputIt first, InputIt last, const Compare& comp, const Allocator& alloc) :
+	PersistentTreeAVL(comp, alloc){
+	this->insert(first, last);
+}
+
+// Initializer list initialization
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::PersistentTreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp, const Allocator& alloc) :
+	PersistentTreeAVL(comp, alloc){
+	this->insert(ilist.begin(), ilist.end());
+}
+
+// Copy initialization
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::PersistentTreeAVL(const PersistentTreeAVL& other) :
+	alloc(other.alloc),
+	cmp(other.cmp),
+	root(other.root),
+	counter(other.counter){
+	if(this->root){ this->root->references.fetch_add(1, std::memory_order_relaxed); }
+}
+
+// Move initialization
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::PersistentTreeAVL(PersistentTreeAVL&& other) :
+	alloc(std::move(other.alloc)),
+	cmp(std::move(other.cmp)),
+	root(other.root),
+	counter(other.counter){
+	other.root = 0;
+	other.counter = 0;
+}
+
+// Destructor
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::~PersistentTreeAVL(){
+	this->release(this->root);
+}
+
+// Assignment
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>& PersistentTreeAVL<Key,T,Compare,Allocator>::operator=(const PersistentTreeAVL& other){
+	if(this != &other){
+		if(other.root){ other.root->references.fetch_add(1, std::memory_order_relaxed); }
+		this->release(this->root);
+		this->alloc = other.alloc;
+		this->cmp = other.cmp;
+		this->root = other.root;
+		this->counter = other.counter;
+	}
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>& PersistentTreeAVL<Key,T,Compare,Allocator>::operator=(PersistentTreeAVL&& other){
+	if(this != &other){
+		this->release(this->root);
+		this->alloc = std::move(other.alloc);
+		this->cmp = std::move(other.cmp);
+		this->root = other.root;
+		this->counter = other.counter;
+		other.root = 0;
+		other.counter = 0;
+	}
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>& PersistentTreeAVL<Key,T,Compare,Allocator>::operator=(std::initializer_list<std::pair<const Key, T>> ilist){
+	this->clear();
+	this->insert(ilist.begin(), ilist.end());
+	return *this;
+}
+
+// Get allocator
+template <class Key, class T, class Compare, class Allocator> Allocator PersistentTreeAVL<Key,T,Compare,Allocator>::get_allocator() const noexcept{
+	return this->alloc;
+}
+
+// Snapshots
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::snapshot() const{
+	return PersistentTreeAVL(*this);
+}
+
+// Element access
+template <class Key, class T, class Compare, class Allocator> const T& PersistentTreeAVL<Key,T,Compare,Allocator>::at(const Key& key) const{
+	NodeAVL* node = this->lookup(key);
+	if(!node){ throw std::out_of_range("bpp::collections::map::PersistentTreeAVL::at"); }
+	return node->data.second;
+}
+
+// Iterators
+template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>& PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator*() const{
+	return this->depth ? this->path[this->depth-1]->data : this->nullvalue;
+}
+template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>* PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator->() const{
+	return this->depth ? &this->path[this->depth-1]->data : 0;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator& PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator++(){
+	// Either the leftmost node of the right subtree, or the first ancestor reached from its left subtree
+	if(!this->depth){ return *this; }
+	NodeAVL* node = this->path[this->depth-1];
+	if(node->rightChild){
+		this->descend(node->rightChild, false);
+	}else{
+		while(--this->depth && this->path[this->depth-1]->rightChild == this->path[this->depth]){ }
+	}
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator++(int){
+	const_iterator pit(*this);
+	++(*this);
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator& PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator--(){
+	if(!this->depth){
+		if(this->root){ this->descend(this->root, true); }
+		return *this;
+	}
+	NodeAVL* node = this->path[this->depth-1];
+	if(node->leftChild){
+		this->descend(node->leftChild, true);
+	}else{
+		while(--this->depth && this->path[this->depth-1]->leftChild == this->path[this->depth]){ }
+	}
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator--(int){
+	const_iterator pit(*this);
+	--(*this);
+	return pit;
+}
+template <class Key, class T, class Compare, class Allocator> bool PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator==(const const_iterator& other) const{
+	return (this->depth ? this->path[this->depth-1] : 0) == (other.depth ? other.path[other.depth-1] : 0);
+}
+template <class Key, class T, class Compare, class Allocator> bool PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::operator!=(const const_iterator& other) const{
+	return !(*this == other);
+}
+template <class Key, class T, class Compare, class Allocator> PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::const_iterator(NodeAVL* root) :
+	root(root),
+	depth(0){ }
+template <class Key, class T, class Compare, class Allocator> void PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::descend(NodeAVL* node, bool right){
+	while(node){
+		this->path[this->depth++] = node;
+		node = right ? node->rightChild : node->leftChild;
+	}
+}
+
+template <class Key, class T, class Compare, class Allocator> std::pair<const Key, T> PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator::nullvalue;
+
+// Iterator generation methods
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::begin() const{
+	const_iterator it(this->root);
+	it.descend(this->root, false);
+	return it;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::cbegin() const{
+	return this->begin();
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::end() const{
+	return const_iterator(this->root);
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::cend() const{
+	return const_iterator(this->root);
+}
+
+// Capacity
+template <class Key, class T, class Compare, class Allocator> bool PersistentTreeAVL<Key,T,Compare,Allocator>::empty() const noexcept{
+	return this->counter == 0;
+}
+template <class Key, class T, class Compare, class Allocator> std::size_t PersistentTreeAVL<Key,T,Compare,Allocator>::size() const noexcept{
+	return this->counter;
+}
+template <class Key, class T, class Compare, class Allocator> std::size_t PersistentTreeAVL<Key,T,Compare,Allocator>::memory() const noexcept{
+	return sizeof(PersistentTreeAVL) + this->counter*sizeof(NodeAVL);
+}
+
+// Modifiers
+template <class Key, class T, class Compare, class Allocator> void PersistentTreeAVL<Key,T,Compare,Allocator>::clear(){
+	this->release(this->root);
+	this->root = 0;
+	this->counter = 0;
+}
+template <class Key, class T, class Compare, class Allocator> std::pair<typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator, bool> PersistentTreeAVL<Key,T,Compare,Allocator>::insert(const std::pair<const Key, T>& value){
+	NodeAVL* created;
+	if(this->lookup(value.first)){ return std::pair<const_iterator, bool>(this->find(value.first), false); }
+	this->root = this->insert_node(this->root, created, value.first, value);
+	++this->counter;
+	return std::pair<const_iterator, bool>(this->find(created->data.first), true);
+}
+template <class Key, class T, class Compare, class Allocator> std::pair<typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator, bool> PersistentTreeAVL<Key,T,Compare,Allocator>::insert(std::pair<const Key, T>&& value){
+	NodeAVL* created;
+	if(this->lookup(value.first)){ return std::pair<const_iterator, bool>(this->find(value.first), false); }
+	this->root = this->insert_node(this->root, created, value.first, std::move(value));
+	++this->counter;
+	return std::pair<const_iterator, bool>(this->find(created->data.first), true);
+}
+template <class Key, class T, class Compare, class Allocator> template <class InputIt> void PersistentTreeAVL<Key,T,Compare,Allocator>::insert(InputIt first, InputIt last){
+	NodeAVL* created;
+	for(auto it = first; it != last; ++it){
+		if(!this->lookup(it->first)){
+			this->root = this->insert_node(this->root, created, it->first, *it);
+			++this->counter;
+		}
+	}
+}
+template <class Key, class T, class Compare, class Allocator> template <class M> std::pair<typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator, bool> PersistentTreeAVL<Key,T,Compare,Allocator>::insert_or_assign(const Key& k, M&& obj){
+	NodeAVL* created;
+	if(this->lookup(k)){
+		this->root = this->assign_node(this->root, k, std::forward<M>(obj));
+		return std::pair<const_iterator, bool>(this->find(k), false);
+	}
+	this->root = this->insert_node(this->root, created, k, k, std::forward<M>(obj));
+	++this->counter;
+	return std::pair<const_iterator, bool>(this->find(k), true);
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> std::size_t PersistentTreeAVL<Key,T,Compare,Allocator>::erase(const K& key){
+	if(!this->lookup(key)){ return 0; }
+	this->root = this->erase_node(this->root, key);
+	--this->counter;
+	return 1;
+}
+
+// Lookup
+template <class Key, class T, class Compare, class Allocator> template <class K> std::size_t PersistentTreeAVL<Key,T,Compare,Allocator>::count(const K& key) const{
+	return this->lookup(key) ? 1 : 0;
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> bool PersistentTreeAVL<Key,T,Compare,Allocator>::contains(const K& key) const{
+	return this->lookup(key);
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::find(const K& key) const{
+	const_iterator it = this->search([&](NodeAVL* node){ return !this->cmp(node->data.first, key); });
+	if(it.depth && this->cmp(key, it.path[it.depth-1]->data.first)){ it.depth = 0; }
+	return it;
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::lower_bound(const K& key) const{
+	return this->search([&](NodeAVL* node){ return !this->cmp(node->data.first, key); });
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::upper_bound(const K& key) const{
+	return this->search([&](NodeAVL* node){ return this->cmp(key, node->data.first); });
+}
+
+// Observers
+template <class Key, class T, class Compare, class Allocator> Compare PersistentTreeAVL<Key,T,Compare,Allocator>::key_comp() const{
+	return this->cmp;
+}
+
+// Operators
+template <class A, class B, class C, class D> bool operator==(const PersistentTreeAVL<A,B,C,D>& lhs, const PersistentTreeAVL<A,B,C,D>& rhs){
+	bool result;
+	if(lhs.root == rhs.root){ return true; }
+	if(result = (lhs.size() == rhs.size())){
+		auto it = lhs.begin(), ito = rhs.begin(), ite = lhs.end();
+		while(it != ite){
+			if((*it) != (*ito)){ return false; }
+			++it;
+			++ito;
+		}
+	}
+	return result;
+}
+
+// Private members
+// Nested class NodeAVL
+template <class Key, class T, class Compare, class Allocator> template <class... Args> PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL::NodeAVL(Args&&... args) :
+	leftChild(0),
+	rightChild(0),
+	data(std::forward<Args>(args)...),
+	height(1),
+	references(1){ }
+template <class Key, class T, class Compare, class Allocator> void PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL::recalculate_height(){
+	std::size_t lh = height_of(this->leftChild), rh = height_of(this->rightChild);
+	this->height = (lh > rh ? lh : rh) + 1;
+}
+
+// Path copying
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::own(NodeAVL* node){
+	// Nodes referenced only by this container are modified in place, shared ones are replaced by a private copy
+	if(node->references.load(std::memory_order_acquire) == 1){ return node; }
+	NodeAVL* copy = this->create(node->data);
+	copy->leftChild = node->leftChild;
+	copy->rightChild = node->rightChild;
+	copy->height = node->height;
+	if(copy->leftChild){ copy->leftChild->references.fetch_add(1, std::memory_order_relaxed); }
+	if(copy->rightChild){ copy->rightChild->references.fetch_add(1, std::memory_order_relaxed); }
+	this->release(node);
+	return copy;
+}
+template <class Key, class T, class Compare, class Allocator> void PersistentTreeAVL<Key,T,Compare,Allocator>::release(NodeAVL* node){
+	if(node && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1){
+		this->release(node->leftChild);
+		this->release(node->rightChild);
+		this->deallocate(node);
+	}
+}
+template <class Key, class T, class Compare, class Allocator> template <class... Args> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::create(Args&&... args){
+	NodeAVL* node = this->alloc.allocate(1);
+	std::construct_at(node, std::forward<Args>(args)...);
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator> void PersistentTreeAVL<Key,T,Compare,Allocator>::deallocate(NodeAVL* node){
+	std::destroy_at(node);
+	this->alloc.deallocate(node, 1);
+}
+template <class Key, class T, class Compare, class Allocator> template <class K, class... Args> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::insert_node(NodeAVL* node, NodeAVL*& created, const K& key, Args&&... args){
+	// The key is known to be missing, every node on the path is owned before relinking it
+	if(!node){ return created = this->create(std::forward<Args>(args)...); }
+	node = this->own(node);
+	if(this->cmp(key, node->data.first)){
+		node->leftChild = this->insert_node(node->leftChild, created, key, std::forward<Args>(args)...);
+	}else{
+		node->rightChild = this->insert_node(node->rightChild, created, key, std::forward<Args>(args)...);
+	}
+	return this->balance(node);
+}
+template <class Key, class T, class Compare, class Allocator> template <class K, class M> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::assign_node(NodeAVL* node, const K& key, M&& obj){
+	// The key is known to be present, the shape of the tree does not change
+	node = this->own(node);
+	if(this->cmp(key, node->data.first)){
+		node->leftChild = this->assign_node(node->leftChild, key, std::forward<M>(obj));
+	}else if(this->cmp(node->data.first, key)){
+		node->rightChild = this->assign_node(node->rightChild, key, std::forward<M>(obj));
+	}else{
+		node->data.second = std::forward<M>(obj);
+	}
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator> template <class K> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::erase_node(NodeAVL* node, const K& key){
+	// The key is known to be present, the erased node is not copied even if shared
+	NodeAVL *replacement, *minimum, *right;
+	bool shared;
+	if(this->cmp(key, node->data.first)){
+		node = this->own(node);
+		node->leftChild = this->erase_node(node->leftChild, key);
+		return this->balance(node);
+	}
+	if(this->cmp(node->data.first, key)){
+		node = this->own(node);
+		node->rightChild = this->erase_node(node->rightChild, key);
+		return this->balance(node);
+	}
+	shared = node->references.load(std::memory_order_acquire) != 1;
+	if(shared){
+		if(node->leftChild){ node->leftChild->references.fetch_add(1, std::memory_order_relaxed); }
+		if(node->rightChild){ node->rightChild->references.fetch_add(1, std::memory_order_relaxed); }
+	}
+	if(!node->leftChild || !node->rightChild){
+		replacement = node->leftChild ? node->leftChild : node->rightChild;
+	}else{
+		right = this->remove_minimum(node->rightChild, minimum);
+		minimum->leftChild = node->leftChild;
+		minimum->rightChild = right;
+		replacement = this->balance(minimum);
+	}
+	// A shared node keeps its children for the other owners, which were referenced again above
+	if(shared){
+		this->release(node);
+	}else{
+		this->deallocate(node);
+	}
+	return replacement;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::remove_minimum(NodeAVL* node, NodeAVL*& minimum){
+	NodeAVL* right;
+	node = this->own(node);
+	if(!node->leftChild){
+		minimum = node;
+		right = node->rightChild;
+		node->rightChild = 0;
+		return right;
+	}
+	node->leftChild = this->remove_minimum(node->leftChild, minimum);
+	return this->balance(node);
+}
+
+// Balance
+template <class Key, class T, class Compare, class Allocator> std::size_t PersistentTreeAVL<Key,T,Compare,Allocator>::height_of(NodeAVL* node){
+	return node ? node->height : 0;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::balance(NodeAVL* node){
+	std::size_t lh = height_of(node->leftChild), rh = height_of(node->rightChild);
+	if(lh > rh + 1){
+		if(height_of(node->leftChild->rightChild) > height_of(node->leftChild->leftChild)){ node->leftChild = this->rotation_left(this->own(node->leftChild)); }
+		return this->rotation_right(node);
+	}
+	if(rh > lh + 1){
+		if(height_of(node->rightChild->leftChild) > height_of(node->rightChild->rightChild)){ node->rightChild = this->rotation_right(this->own(node->rightChild)); }
+		return this->rotation_left(node);
+	}
+	node->height = (lh > rh ? lh : rh) + 1;
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::rotation_left(NodeAVL* node){
+	NodeAVL* result = this->own(node->rightChild);
+	node->rightChild = result->leftChild;
+	result->leftChild = node;
+	node->recalculate_height();
+	result->recalculate_height();
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::rotation_right(NodeAVL* node){
+	NodeAVL* result = this->own(node->leftChild);
+	node->leftChild = result->rightChild;
+	result->rightChild = node;
+	node->recalculate_height();
+	result->recalculate_height();
+	return result;
+}
+
+// Search
+template <class Key, class T, class Compare, class Allocator> template <class K> typename PersistentTreeAVL<Key,T,Compare,Allocator>::NodeAVL* PersistentTreeAVL<Key,T,Compare,Allocator>::lookup(const K& key) const{
+	NodeAVL* node = this->root;
+	while(node && (this->cmp(key, node->data.first) || this->cmp(node->data.first, key))){ node = this->cmp(key, node->data.first) ? node->leftChild : node->rightChild; }
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator> template <class Pred> typename PersistentTreeAVL<Key,T,Compare,Allocator>::const_iterator PersistentTreeAVL<Key,T,Compare,Allocator>::search(Pred pred) const{
+	// Records the whole descent and cuts it at the last node satisfying pred
+	const_iterator it(this->root);
+	NodeAVL* node = this->root;
+	std::size_t found = 0;
+	while(node){
+		it.path[it.depth++] = node;
+		if(pred(node)){
+			found = it.depth;
+			node = node->leftChild;
+		}else{
+			node = node->rightChild;
+		}
+	}
+	it.depth = found;
+	return it;
+}
+
+		}
+	}
+}
+
+// Non-member
+// Other
+template <class A, class B, class C, class D> void std::swap(bpp::collections::map::PersistentTreeAVL<A,B,C,D>& lhs, bpp::collections::map::PersistentTreeAVL<A,B,C,D>& rhs){
+	std::swap(lhs.alloc, rhs.alloc);
+	std::swap(lhs.cmp, rhs.cmp);
+	std::swap(lhs.root, rhs.root);
+	std::swap(lhs.counter, rhs.counter);
+}
+
+#endif
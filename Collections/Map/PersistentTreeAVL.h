@@ -0,0 +1,215 @@
+#ifndef BPP_COLLECTIONS_MAP_PERSISTENTTREEAVL_H
+#define BPP_COLLECTIONS_MAP_PERSISTENTTREEAVL_H
+#include <atomic>			// std::atomic<>
+#include <functional>		// std::less
+#include <initializer_list>	// std::initializer_list<>
+#include <iterator>			// std::bidirectional_iterator_tag
+#include <memory>			// std::allocator<>, std::allocator_traits<>, std::construct_at, std::destroy_at
+#include <stdexcept>		// std::out_of_range
+#include <utility>			// std::pair, std::swap, std::move, std::forward
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+//! PersistentTreeAVL is a sorted associative container that contains key-value pairs with unique keys, which can be copied in constant time. Keys are sorted by using the comparison function Compare. Search, removal, and insertion operations have logarithmic complexity. This is an implementation of an Adelson-Velsky and Landis Tree.
+//! Copies share their nodes, which are reference counted. Modifications copy only the nodes on the path from the root to the modified one that are shared with another container (path copying), so any copy remains a consistent snapshot of the contents it was taken from. Nodes that are not shared are modified in place, so a container without copies performs like TreeAVL.
+//! Different containers sharing nodes can be used (and destroyed) from different threads, as long as the allocator is thread-safe. A single container is not thread-safe.
+template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>> class PersistentTreeAVL{
+	private:
+		struct NodeAVL;
+		// Rebind Allocator
+		using AllocatorNodes = typename std::allocator_traits<Allocator>::rebind_alloc<NodeAVL>;
+		// Maximum height of a tree that fits in memory, bounds the path kept by iterators
+		static constexpr std::size_t max_height = 64;
+	public:
+		// Declares member types
+		//! Type of the keys for the key-value pairs.
+		using key_type = Key;
+		//! Type of the mapped values for the key-value pairs.
+		using mapped_type = T;
+		//! Type of the values stored in the map.
+		using value_type = std::pair<const Key, T>;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences (unused).
+		using difference_type = std::ptrdiff_t;
+		//! Type of compare used in key comparison.
+		using key_compare = Compare;
+		//! Type of allocator used.
+		using allocator_type = Allocator;
+		//! Type of references to values.
+		using reference = value_type&;
+		//! Type of constant references to values.
+		using const_reference = const value_type&;
+		
+		//! Constructs an empty container.
+		PersistentTreeAVL();
+		//! Constructs an empty container. Receives the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		explicit PersistentTreeAVL(const Compare& comp, const Allocator& alloc = Allocator());
+		//! Constructs an empty container. Receives the allocator to use for all memory allocations.
+		explicit PersistentTreeAVL(const Allocator& alloc);
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		template <class InputIt> PersistentTreeAVL(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! Constructs the container with the contents of the initializer list init. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		PersistentTreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+		//! Copy constructor. Constructs the container with the contents of other in constant time, sharing its nodes and its allocator.
+		PersistentTreeAVL(const PersistentTreeAVL& other);
+		//! Move constructor. Constructs the container with the contents of other using move semantics. After the move, other is guaranteed to be empty().
+		PersistentTreeAVL(PersistentTreeAVL&& other);
+		//! Destructs the map. The nodes that are not shared with other containers are destroyed and their storage is deallocated.
+		~PersistentTreeAVL();
+		
+		// Assignment
+		//! Copy assignment operator. Replaces the contents with the contents of other in constant time, sharing its nodes and its allocator.
+		PersistentTreeAVL& operator=(const PersistentTreeAVL& other);
+		//! Move assignment operator. Replaces the contents with those of other using move semantics. After the move, other is guaranteed to be empty().
+		PersistentTreeAVL& operator=(PersistentTreeAVL&& other);
+		//! Replaces the contents with those identified by initializer list ilist.
+		PersistentTreeAVL& operator=(std::initializer_list<std::pair<const Key, T>> ilist);
+		
+		// Get allocator
+		//! Returns the allocator associated with the container.
+		Allocator get_allocator() const noexcept;
+		
+		// Snapshots
+		//! Returns a container with the current contents in constant time. Later modifications of either container are not visible in the other.
+		PersistentTreeAVL snapshot() const;
+		
+		// Element access
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		const T& at(const Key& key) const;
+		
+		// Iterators
+		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only. The iterator keeps the path from the root to its element, since nodes shared between containers can not point at their parent. Beware that any changes in the tree may invalidate the iterators and produce undefined behaviour, while the iterators of a copy are not affected by them.
+		struct const_iterator{
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = const std::pair<const Key, T>;
+			//! Type of differences between iterators.
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = const std::pair<const Key, T>*;
+			//! Type of references to values.
+			using reference = const std::pair<const Key, T>&;
+			//! References the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			const std::pair<const Key, T>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator operator--(int);
+			//! Checks whether both iterators point at the same node.
+			bool operator==(const const_iterator& other) const;
+			//! Checks whether both iterators point at different nodes.
+			bool operator!=(const const_iterator& other) const;
+			private:
+				friend class PersistentTreeAVL<Key,T,Compare,Allocator>;
+				NodeAVL* root;
+				NodeAVL* path[max_height];
+				std::size_t depth;
+				static std::pair<const Key, T> nullvalue;
+				const_iterator(NodeAVL* root);
+				inline void descend(NodeAVL* node, bool right);
+		};
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator begin() const;
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator cbegin() const;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator end() const;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator cend() const;
+		
+		// Capacity
+		//! Checks if the container has no elements.
+		bool empty() const noexcept;
+		//! Returns the number of elements in the container.
+		std::size_t size() const noexcept;
+		//! Returns the total space in memory, counting the nodes shared with other containers.
+		std::size_t memory() const noexcept;
+		
+		// Modifiers
+		//! Erases all elements from the container. After this call, size() returns zero.
+		void clear();
+		//! Inserts value into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
+		std::pair<const_iterator, bool> insert(const std::pair<const Key, T>& value);
+		//! Inserts value into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
+		std::pair<const_iterator, bool> insert(std::pair<const Key, T>&& value);
+		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		template <class InputIt> void insert(InputIt first, InputIt last);
+		//! If a key equivalent to k already exists in the container, assigns std::forward<M>(obj) to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert. Returns a pair consisting of an iterator to the element and a bool denoting whether the insertion took place.
+		template <class M> std::pair<const_iterator, bool> insert_or_assign(const Key& k, M&& obj);
+		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
+		template <class K> std::size_t erase(const K& key);
+		
+		// Lookup
+		//! Returns the number of elements with key that compares equivalent to the specified argument, which is either 1 or 0 since this container does not allow duplicates.
+		template <class K> std::size_t count(const K& key) const;
+		//! Checks if there is an element with key that compares equivalent to the value of key.
+		template <class K> bool contains(const K& key) const;
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> const_iterator find(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> const_iterator lower_bound(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares greater to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> const_iterator upper_bound(const K& key) const;
+		
+		// Observers
+		//! Returns the function object that compares the keys, which is a copy of this container's constructor argument comp.
+		Compare key_comp() const;
+		
+		// Operators
+		//! Checks if the contents of lhs and rhs are equal, that is, they have the same number of elements and each element in lhs compares equal with the element in rhs at the same position. Containers sharing their root are equal without comparing the elements.
+		template <class A, class B, class C, class D> friend bool operator==(const PersistentTreeAVL<A,B,C,D>& lhs, const PersistentTreeAVL<A,B,C,D>& rhs);
+		
+		// Non-member
+		//! Specialized swapping function.
+		template <class A, class B, class C, class D> friend void std::swap(PersistentTreeAVL<A,B,C,D>& lhs, PersistentTreeAVL<A,B,C,D>& rhs);
+		
+	private:
+		// Nested class NodeAVL
+		struct NodeAVL{
+			NodeAVL *leftChild, *rightChild;
+			std::pair<const Key,T> data;
+			std::size_t height;
+			std::atomic<std::size_t> references;
+			template <class... Args> NodeAVL(Args&&... args);
+			inline void recalculate_height();
+		};
+		AllocatorNodes alloc;
+		Compare cmp;
+		NodeAVL* root;
+		std::size_t counter;
+		// Path copying
+		inline NodeAVL* own(NodeAVL* node);
+		inline void release(NodeAVL* node);
+		template <class... Args> inline NodeAVL* create(Args&&... args);
+		inline void deallocate(NodeAVL* node);
+		template <class K, class... Args> NodeAVL* insert_node(NodeAVL* node, NodeAVL*& created, const K& key, Args&&... args);
+		template <class K, class M> NodeAVL* assign_node(NodeAVL* node, const K& key, M&& obj);
+		template <class K> NodeAVL* erase_node(NodeAVL* node, const K& key);
+		NodeAVL* remove_minimum(NodeAVL* node, NodeAVL*& minimum);
+		// Balance
+		inline static std::size_t height_of(NodeAVL* node);
+		inline NodeAVL* balance(NodeAVL* node);
+		inline NodeAVL* rotation_left(NodeAVL* node);
+		inline NodeAVL* rotation_right(NodeAVL* node);
+		// Search
+		template <class K> NodeAVL* lookup(const K& key) const;
+		template <class Pred> const_iterator search(Pred pred) const;
+};
+
+		}
+	}
+}
+
+#include "PersistentTreeAVL.cpp"
+
+#endif
@@ -0,0 +1,785 @@
+#ifndef BPP_COLLECTIONS_MAP_RADIXTRIE_CPP
+#define BPP_COLLECTIONS_MAP_RADIXTRIE_CPP
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+// Constructors
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::RadixTrie() :
+	counter(0),
+	nCounter(0),
+	storage(0){ }
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::RadixTrie(const Allocator& alloc) :
+	alloc(alloc),
+	counter(0),
+	nCounter(0),
+	storage(0){ }
+template <class Key, class T, class Container, class Allocator> template<class InputIt> RadixTrie<Key,T,Container,Allocator>::RadixTrie(InputIt first, InputIt last, const Allocator& alloc) :
+	alloc(alloc),
+	counter(0),
+	nCounter(0),
+	storage(0){
+	this->insert(first, last);
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::RadixTrie(const RadixTrie& other, const Allocator& alloc) :
+	alloc(alloc),
+	counter(0),
+	nCounter(0),
+	storage(0){
+	this->copy(&other.root);
+	this->counter = other.counter;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::RadixTrie(RadixTrie&& other) :
+	alloc(other.alloc),
+	counter(0),
+	nCounter(0),
+	storage(0){
+	this->adopt(other);
+}
+template <class Key, class T, class Container, class Allocator> template <class Vector> RadixTrie<Key,T,Container,Allocator>::RadixTrie(std::initializer_list<std::pair<const Vector, T>> ilist, const Allocator& alloc) :
+	alloc(alloc),
+	counter(0),
+	nCounter(0),
+	storage(0){
+	for(auto it : ilist){
+		this->get_forward(it.first, len_array(it.first))->value = it.second;
+	}
+}
+
+// Destructor
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::~RadixTrie(){
+	this->clear();
+}
+
+// Assignment
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>& RadixTrie<Key,T,Container,Allocator>::operator=(const RadixTrie& other){
+	if(this != &other){
+		this->clear();
+		this->copy(&other.root);
+		this->counter = other.counter;
+	}
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>& RadixTrie<Key,T,Container,Allocator>::operator=(RadixTrie&& other){
+	if(this != &other){
+		this->clear();
+		this->alloc = other.alloc;
+		this->adopt(other);
+	}
+	return *this;
+}
+
+// Get allocator
+template <class Key, class T, class Container, class Allocator> Allocator RadixTrie<Key,T,Container,Allocator>::get_allocator() const noexcept{
+	return Allocator(this->alloc);
+}
+
+// Element access
+template <class Key, class T, class Container, class Allocator> template<class Vector> const T& RadixTrie<Key,T,Container,Allocator>::at(const Vector& key) const{
+	NodeRadix* tmp = this->find_node(key, len_array(key));
+	if(!tmp || !tmp->valid){ throw std::out_of_range("bpp::collections::map::RadixTrie::at"); }
+	return tmp->value;
+}
+template <class Key, class T, class Container, class Allocator> template<class Vector> T& RadixTrie<Key,T,Container,Allocator>::operator[](const Vector& key){
+	return this->get_forward(key, len_array(key))->value;
+}
+
+// Iterators
+// Iterator
+template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>& RadixTrie<Key,T,Container,Allocator>::iterator::operator*(){
+	return this->data;
+}
+template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>* RadixTrie<Key,T,Container,Allocator>::iterator::operator->(){
+	return &this->data;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator& RadixTrie<Key,T,Container,Allocator>::iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::iterator::operator++(int){
+	iterator pit(*this);
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator& RadixTrie<Key,T,Container,Allocator>::iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::iterator::operator--(int){
+	iterator pit(*this);
+	this->previous_element();
+	return pit;
+}
+// Constant Iterator
+template <class Key, class T, class Container, class Allocator> const std::pair<const std::vector<Key>&, const T&>& RadixTrie<Key,T,Container,Allocator>::const_iterator::operator*() const{
+	return (const std::pair<const std::vector<Key>&, const T&>&) this->data;
+}
+template <class Key, class T, class Container, class Allocator> const std::pair<const std::vector<Key>&, const T&>* RadixTrie<Key,T,Container,Allocator>::const_iterator::operator->() const{
+	return (const std::pair<const std::vector<Key>&, const T&>*) &this->data;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::const_iterator& RadixTrie<Key,T,Container,Allocator>::const_iterator::operator++(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::const_iterator RadixTrie<Key,T,Container,Allocator>::const_iterator::operator++(int){
+	const_iterator pit(*this);
+	this->next_element();
+	return pit;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::const_iterator& RadixTrie<Key,T,Container,Allocator>::const_iterator::operator--(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::const_iterator RadixTrie<Key,T,Container,Allocator>::const_iterator::operator--(int){
+	const_iterator pit(*this);
+	this->previous_element();
+	return pit;
+}
+// Reverse Iterator
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::reverse_iterator::base() const{
+	return iterator(this->current);
+}
+template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>& RadixTrie<Key,T,Container,Allocator>::reverse_iterator::operator*(){
+	return this->data;
+}
+template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>* RadixTrie<Key,T,Container,Allocator>::reverse_iterator::operator->(){
+	return &this->data;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::reverse_iterator& RadixTrie<Key,T,Container,Allocator>::reverse_iterator::operator++(){
+	this->previous_element();
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::reverse_iterator RadixTrie<Key,T,Container,Allocator>::reverse_iterator::operator++(int){
+	reverse_iterator pit(*this);
+	this->previous_element();
+	return pit;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::reverse_iterator& RadixTrie<Key,T,Container,Allocator>::reverse_iterator::operator--(){
+	this->next_element();
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::reverse_iterator RadixTrie<Key,T,Container,Allocator>::reverse_iterator::operator--(int){
+	reverse_iterator pit(*this);
+	this->next_element();
+	return pit;
+}
+
+// Iterator generation methods
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::begin() const{
+	return iterator(first_valid(const_cast<NodeRadix*>(&this->root)));
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::const_iterator RadixTrie<Key,T,Container,Allocator>::cbegin() const{
+	return const_iterator(first_valid(const_cast<NodeRadix*>(&this->root)));
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::end() const noexcept{
+	return iterator();
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::const_iterator RadixTrie<Key,T,Container,Allocator>::cend() const noexcept{
+	return const_iterator();
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::reverse_iterator RadixTrie<Key,T,Container,Allocator>::rbegin() const{
+	// The last element is the rightmost leaf, or the root if it is the only element
+	NodeRadix* tmp = 0;
+	if(this->counter){
+		tmp = const_cast<NodeRadix*>(&this->root);
+		while(tmp->children.size()){
+			tmp = (NodeRadix*) tmp->children.rbegin()->second;
+		}
+	}
+	return reverse_iterator(tmp);
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::reverse_iterator RadixTrie<Key,T,Container,Allocator>::rend() const noexcept{
+	return reverse_iterator();
+}
+
+// Capacity
+template <class Key, class T, class Container, class Allocator> bool RadixTrie<Key,T,Container,Allocator>::empty() const noexcept{
+	return this->counter == 0;
+}
+template <class Key, class T, class Container, class Allocator> std::size_t RadixTrie<Key,T,Container,Allocator>::size() const noexcept{
+	return this->counter;
+}
+template <class Key, class T, class Container, class Allocator> std::size_t RadixTrie<Key,T,Container,Allocator>::nodes() const noexcept{
+	return this->nCounter;
+}
+template <class Key, class T, class Container, class Allocator> std::size_t RadixTrie<Key,T,Container,Allocator>::memory() const noexcept{
+	return this->storage + this->nCounter * sizeof(typename Container::node_type) + sizeof(RadixTrie);
+}
+
+// Modifiers
+// Clear
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::clear() noexcept{
+	for(auto it = this->root.children.begin(); it != this->root.children.end(); ++it){
+		this->destroy((NodeRadix*) it->second);
+	}
+	this->root.children.clear();
+	this->root.valid = false;
+	this->counter = 0;
+}
+// Inserts
+template <class Key, class T, class Container, class Allocator> template <class Vector> std::pair<typename RadixTrie<Key,T,Container,Allocator>::iterator, bool> RadixTrie<Key,T,Container,Allocator>::insert(const std::pair<Vector, T>& value){
+	std::size_t pcounter = this->counter;
+	NodeRadix* tmp = this->get_forward(value.first, len_array(value.first));
+	if(pcounter != this->counter){ tmp->value = value.second; }
+	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+}
+template <class Key, class T, class Container, class Allocator> template <class Vector> std::pair<typename RadixTrie<Key,T,Container,Allocator>::iterator, bool> RadixTrie<Key,T,Container,Allocator>::insert(std::pair<Vector, T>&& value){
+	std::size_t pcounter = this->counter;
+	NodeRadix* tmp = this->get_forward(value.first, len_array(value.first));
+	if(pcounter != this->counter){ tmp->value = std::move(value.second); }
+	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+}
+template <class Key, class T, class Container, class Allocator> template <class InputIt> void RadixTrie<Key,T,Container,Allocator>::insert(InputIt first, InputIt last){
+	for(auto it = first; it != last; ++it){
+		std::size_t pcounter = this->counter;
+		NodeRadix* tmp = this->get_forward(it->first, len_array(it->first));
+		if(pcounter != this->counter){ tmp->value = it->second; }
+	}
+}
+// Insert or Assign
+template <class Key, class T, class Container, class Allocator> template <class Vector, class M> std::pair<typename RadixTrie<Key,T,Container,Allocator>::iterator, bool> RadixTrie<Key,T,Container,Allocator>::insert_or_assign(const Vector& k, M&& obj){
+	std::size_t pcounter = this->counter;
+	NodeRadix* tmp = this->get_forward(k, len_array(k));
+	tmp->value = std::forward<M>(obj);
+	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+}
+// Erase
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::erase(iterator pos){
+	// Removing the element may merge its successor into another node, so the successor is searched again by key
+	std::vector<Key> key = std::move(pos.key);
+	this->remove_node(pos.current);
+	return iterator(this->bound_node(key, key.size(), true));
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::erase(iterator first, iterator last){
+	if(last == this->end()){
+		while(first != last){
+			first = this->erase(first);
+		}
+		return first;
+	}
+	std::vector<Key> stop = last.key;
+	while(first.current && first.key != stop){
+		first = this->erase(first);
+	}
+	return first;
+}
+template <class Key, class T, class Container, class Allocator> template <class Vector> std::size_t RadixTrie<Key,T,Container,Allocator>::erase(const Vector& key){
+	NodeRadix* tmp = this->find_node(key, len_array(key));
+	std::size_t result = (tmp && tmp->valid);
+	this->remove_node(tmp);
+	return result;
+}
+
+// Lookup
+// Count
+template <class Key, class T, class Container, class Allocator> template <class K> std::size_t RadixTrie<Key,T,Container,Allocator>::count(const K& key) const{
+	NodeRadix* tmp = this->find_node(key, len_array(key));
+	return tmp && tmp->valid;
+}
+// Find
+template <class Key, class T, class Container, class Allocator> template <class K> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::find(const K& key) const{
+	NodeRadix* tmp = this->find_node(key, len_array(key));
+	return (tmp && tmp->valid) ? iterator(tmp) : this->end();
+}
+// Contains
+template <class Key, class T, class Container, class Allocator> template <class K> bool RadixTrie<Key,T,Container,Allocator>::contains(const K& key) const{
+	NodeRadix* tmp = this->find_node(key, len_array(key));
+	return tmp && tmp->valid;
+}
+// Bounds
+template <class Key, class T, class Container, class Allocator> template <class K> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::lower_bound(const K& key) const{
+	return iterator(this->bound_node(key, len_array(key), false));
+}
+template <class Key, class T, class Container, class Allocator> template <class K> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::upper_bound(const K& key) const{
+	return iterator(this->bound_node(key, len_array(key), true));
+}
+template <class Key, class T, class Container, class Allocator> template <class K> std::pair<typename RadixTrie<Key,T,Container,Allocator>::iterator, typename RadixTrie<Key,T,Container,Allocator>::iterator> RadixTrie<Key,T,Container,Allocator>::equal_range(const K& key) const{
+	return std::pair<iterator,iterator>(this->lower_bound(key), this->upper_bound(key));
+}
+// Prefixes
+template <class Key, class T, class Container, class Allocator> template <class K> RadixTrie<Key,T,Container,Allocator>::iterator RadixTrie<Key,T,Container,Allocator>::longest_prefix_match(const K& key) const{
+	NodeRadix* tmp = 0;
+	this->prefix_nodes(key, len_array(key), [&tmp](NodeRadix* ptr){ tmp = ptr; });
+	return iterator(tmp);
+}
+template <class Key, class T, class Container, class Allocator> template <class K> std::vector<typename RadixTrie<Key,T,Container,Allocator>::iterator> RadixTrie<Key,T,Container,Allocator>::all_prefixes_of(const K& key) const{
+	std::vector<iterator> result;
+	this->prefix_nodes(key, len_array(key), [&result](NodeRadix* ptr){
+		result.push_back(iterator(ptr));
+	});
+	return result;
+}
+template <class Key, class T, class Container, class Allocator> template <class K> std::pair<typename RadixTrie<Key,T,Container,Allocator>::iterator, typename RadixTrie<Key,T,Container,Allocator>::iterator> RadixTrie<Key,T,Container,Allocator>::prefix_range(const K& prefix) const{
+	NodeRadix* ptr = this->prefix_node(prefix, len_array(prefix));
+	if(!ptr){ return std::pair<iterator,iterator>(this->end(), this->end()); }
+	return std::pair<iterator,iterator>(iterator(first_valid(ptr)), iterator(next_subtree(ptr)));
+}
+template <class Key, class T, class Container, class Allocator> template <class K> std::size_t RadixTrie<Key,T,Container,Allocator>::count_prefix(const K& prefix) const{
+	NodeRadix* ptr = this->prefix_node(prefix, len_array(prefix));
+	std::size_t result = 0;
+	std::vector<NodeRadix*> pending;
+	if(ptr){ pending.push_back(ptr); }
+	while(pending.size()){
+		NodeRadix* tmp = pending.back();
+		pending.pop_back();
+		result += tmp->valid;
+		for(auto it = tmp->children.begin(); it != tmp->children.end(); ++it){
+			pending.push_back((NodeRadix*) it->second);
+		}
+	}
+	return result;
+}
+
+// Non-member functions
+// Operators
+template<class A,class B,class C,class D> bool operator==(const RadixTrie<A,B,C,D>& lhs, const RadixTrie<A,B,C,D>& rhs){
+	if(lhs.counter != rhs.counter){ return false; }
+	for(auto lit = lhs.cbegin(), rit = rhs.cbegin(); lit != lhs.cend(); ++lit, ++rit){
+		if(lit->first != rit->first || lit->second != rit->second){ return false; }
+	}
+	return true;
+}
+template<class A,class B,class C,class D> std::strong_ordering operator<=>(const RadixTrie<A,B,C,D>& lhs, const RadixTrie<A,B,C,D>& rhs){
+	// Elements are compared in order, by key with the comparison of Container and then by mapped value
+	typename C::key_compare cmp;
+	auto lit = lhs.cbegin(), rit = rhs.cbegin();
+	for(; lit != lhs.cend() && rit != rhs.cend(); ++lit, ++rit){
+		const std::vector<A> &lkey = lit->first, &rkey = rit->first;
+		std::size_t size = std::min(lkey.size(), rkey.size()), i = 0;
+		while(i < size && lkey[i] == rkey[i]){ ++i; }
+		if(i < size){
+			return cmp(lkey[i], rkey[i]) ? std::strong_ordering::less : std::strong_ordering::greater;
+		}else if(lkey.size() != rkey.size()){
+			return lkey.size() < rkey.size() ? std::strong_ordering::less : std::strong_ordering::greater;
+		}else if(lit->second != rit->second){
+			return (lit->second < rit->second) ? std::strong_ordering::less : std::strong_ordering::greater;
+		}
+	}
+	if(lit != lhs.cend() || rit != rhs.cend()){
+		return lit != lhs.cend() ? std::strong_ordering::greater : std::strong_ordering::less;
+	}
+	return std::strong_ordering::equal;
+}
+
+// Nested class NodeRadix
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::NodeRadix::NodeRadix(NodeRadix* parent, uint32_t blocks) :
+	parent(parent),
+	value(),
+	length(0),
+	blocks(blocks),
+	valid(false){ }
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::NodeRadix::~NodeRadix(){}
+template <class Key, class T, class Container, class Allocator> Key* RadixTrie<Key,T,Container,Allocator>::NodeRadix::label(){
+	return (Key*) ((unsigned char*) this + offset());
+}
+template <class Key, class T, class Container, class Allocator> const Key* RadixTrie<Key,T,Container,Allocator>::NodeRadix::label() const{
+	return (const Key*) ((const unsigned char*) this + offset());
+}
+template <class Key, class T, class Container, class Allocator> std::size_t RadixTrie<Key,T,Container,Allocator>::NodeRadix::capacity() const{
+	return this->blocks ? (this->blocks * sizeof(Block) - offset()) / sizeof(Key) : 0;
+}
+template <class Key, class T, class Container, class Allocator> std::size_t RadixTrie<Key,T,Container,Allocator>::NodeRadix::offset(){
+	return (sizeof(NodeRadix) + alignof(Key) - 1) / alignof(Key) * alignof(Key);
+}
+template <class Key, class T, class Container, class Allocator> std::size_t RadixTrie<Key,T,Container,Allocator>::NodeRadix::blocks_for(std::size_t length){
+	return (offset() + length * sizeof(Key) + sizeof(Block) - 1) / sizeof(Block);
+}
+
+// Private members
+template <class Key, class T, class Container, class Allocator> template <class Vector> RadixTrie<Key,T,Container,Allocator>::NodeRadix* RadixTrie<Key,T,Container,Allocator>::create(const Vector& key, std::size_t first, std::size_t length, NodeRadix* parent){
+	// The node and its label of symbols key[first, first+length) share one allocation
+	std::size_t blocks = NodeRadix::blocks_for(length);
+	NodeRadix* ptr = std::construct_at((NodeRadix*) this->alloc.allocate(blocks), parent, (uint32_t) blocks);
+	Key* label = ptr->label();
+	for(std::size_t i=0; i<length; ++i){
+		std::construct_at(label + i, key[first + i]);
+	}
+	ptr->length = (uint32_t) length;
+	++this->nCounter;
+	this->storage += blocks * sizeof(Block);
+	return ptr;
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::destroy_node(NodeRadix* ptr){
+	// Releases a single node, without its children
+	std::size_t blocks = ptr->blocks;
+	Key* label = ptr->label();
+	for(std::size_t i=0; i<ptr->length; ++i){
+		std::destroy_at(label + i);
+	}
+	std::destroy_at(ptr);
+	this->alloc.deallocate((Block*) ptr, blocks);
+	--this->nCounter;
+	this->storage -= blocks * sizeof(Block);
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::destroy(NodeRadix* ptr){
+	std::vector<NodeRadix*> pending(1, ptr);
+	while(pending.size()){
+		NodeRadix* tmp = pending.back();
+		pending.pop_back();
+		for(auto it = tmp->children.begin(); it != tmp->children.end(); ++it){
+			pending.push_back((NodeRadix*) it->second);
+		}
+		this->destroy_node(tmp);
+	}
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::copy(const NodeRadix* src){
+	// Clones the nodes below src under the root, which must have no children
+	std::vector<std::pair<const NodeRadix*, NodeRadix*>> pending(1, std::pair<const NodeRadix*, NodeRadix*>(src, &this->root));
+	this->root.valid = src->valid;
+	this->root.value = src->value;
+	while(pending.size()){
+		std::pair<const NodeRadix*, NodeRadix*> tmp = pending.back();
+		pending.pop_back();
+		for(auto it = tmp.first->children.begin(); it != tmp.first->children.end(); ++it){
+			const NodeRadix* child = (const NodeRadix*) it->second;
+			NodeRadix* ptr = this->create(child->label(), 0, child->length, tmp.second);
+			ptr->value = child->value;
+			ptr->valid = child->valid;
+			tmp.second->children[it->first] = ptr;
+			pending.push_back(std::pair<const NodeRadix*, NodeRadix*>(child, ptr));
+		}
+	}
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::adopt(RadixTrie& other){
+	// Takes the nodes of other, which now hang from this root
+	this->root.children = std::move(other.root.children);
+	this->root.value = std::move(other.root.value);
+	this->root.valid = other.root.valid;
+	for(auto it = this->root.children.begin(); it != this->root.children.end(); ++it){
+		((NodeRadix*) it->second)->parent = &this->root;
+	}
+	this->counter = other.counter;
+	this->nCounter = other.nCounter;
+	this->storage = other.storage;
+	other.root.children.clear();
+	other.root.valid = false;
+	other.counter = 0;
+	other.nCounter = 0;
+	other.storage = 0;
+}
+template <class Key, class T, class Container, class Allocator> template<class Vector> RadixTrie<Key,T,Container,Allocator>::NodeRadix* RadixTrie<Key,T,Container,Allocator>::get_forward(const Vector& key, std::size_t size){
+	NodeRadix *ptr = &this->root;
+	std::size_t i = 0;
+	while(i < size){
+		NodeRadix** tmp = (NodeRadix**)&(ptr->children[key[i]]);
+		if(!(*tmp)){
+			// The rest of the key becomes the label of a new leaf
+			*tmp = this->create(key, i, size - i, ptr);
+			ptr = *tmp;
+			break;
+		}
+		const Key* label = (*tmp)->label();
+		std::size_t length = 1, limit = std::min<std::size_t>((*tmp)->length, size - i);
+		while(length < limit && label[length] == key[i+length]){ ++length; }
+		if(length < (*tmp)->length){
+			this->split(*tmp, length);
+		}
+		ptr = *tmp;
+		i += length;
+	}
+	if(!ptr->valid){
+		ptr->valid = true;
+		++this->counter;
+	}
+	return ptr;
+}
+template <class Key, class T, class Container, class Allocator> template<class Vector> RadixTrie<Key,T,Container,Allocator>::NodeRadix* RadixTrie<Key,T,Container,Allocator>::find_node(const Vector& key, std::size_t size) const{
+	NodeRadix* ptr = const_cast<NodeRadix*>(&this->root);
+	std::size_t i = 0;
+	while(i < size){
+		auto it = ptr->children.find(key[i]);
+		if(it == ptr->children.end()){ return 0; }
+		ptr = (NodeRadix*) it->second;
+		if(ptr->length > size - i){ return 0; }
+		const Key* label = ptr->label();
+		for(std::size_t j=1; j<ptr->length; ++j){
+			if(!(label[j] == key[i+j])){ return 0; }
+		}
+		i += ptr->length;
+	}
+	return ptr;
+}
+template <class Key, class T, class Container, class Allocator> template<class Vector> RadixTrie<Key,T,Container,Allocator>::NodeRadix* RadixTrie<Key,T,Container,Allocator>::bound_node(const Vector& key, std::size_t size, bool upper) const{
+	// Descends while the labels match the key, the bound is in the subtree where they first differ or right after it
+	typename Container::key_compare cmp;
+	NodeRadix* ptr = const_cast<NodeRadix*>(&this->root);
+	std::size_t i = 0;
+	while(i < size){
+		auto it = ptr->children.lower_bound(key[i]);
+		if(it == ptr->children.end()){ return next_subtree(ptr); }
+		NodeRadix* child = (NodeRadix*) it->second;
+		if(it->first != key[i]){ return first_valid(child); }
+		const Key* label = child->label();
+		std::size_t length = 1, limit = std::min<std::size_t>(child->length, size - i);
+		while(length < limit && label[length] == key[i+length]){ ++length; }
+		if(length < limit){
+			return cmp(label[length], key[i+length]) ? next_subtree(child) : first_valid(child);
+		}
+		if(length < child->length){ return first_valid(child); }
+		ptr = child;
+		i += length;
+	}
+	if(!upper){ return first_valid(ptr); }
+	return ptr->children.size() ? first_valid((NodeRadix*) ptr->children.begin()->second) : next_subtree(ptr);
+}
+template <class Key, class T, class Container, class Allocator> template<class Vector, class Function> void RadixTrie<Key,T,Container,Allocator>::prefix_nodes(const Vector& key, std::size_t size, Function visit) const{
+	// Descends as find_node() does, calling visit with every valid node on the path
+	NodeRadix* ptr = const_cast<NodeRadix*>(&this->root);
+	std::size_t i = 0;
+	while(true){
+		if(ptr->valid){ visit(ptr); }
+		if(i == size){ return; }
+		auto it = ptr->children.find(key[i]);
+		if(it == ptr->children.end()){ return; }
+		ptr = (NodeRadix*) it->second;
+		if(ptr->length > size - i){ return; }
+		const Key* label = ptr->label();
+		for(std::size_t j=1; j<ptr->length; ++j){
+			if(!(label[j] == key[i+j])){ return; }
+		}
+		i += ptr->length;
+	}
+}
+template <class Key, class T, class Container, class Allocator> template<class Vector> RadixTrie<Key,T,Container,Allocator>::NodeRadix* RadixTrie<Key,T,Container,Allocator>::prefix_node(const Vector& key, std::size_t size) const{
+	// Node whose subtree holds the keys beginning with key, which may end inside its label
+	NodeRadix* ptr = const_cast<NodeRadix*>(&this->root);
+	std::size_t i = 0;
+	while(i < size){
+		auto it = ptr->children.find(key[i]);
+		if(it == ptr->children.end()){ return 0; }
+		ptr = (NodeRadix*) it->second;
+		const Key* label = ptr->label();
+		std::size_t limit = std::min<std::size_t>(ptr->length, size - i);
+		for(std::size_t j=1; j<limit; ++j){
+			if(!(label[j] == key[i+j])){ return 0; }
+		}
+		i += limit;
+	}
+	return ptr;
+}
+template <class Key, class T, class Container, class Allocator> template<class Vector> std::size_t RadixTrie<Key,T,Container,Allocator>::len_array(const Vector& vec) const{ return vec.size(); }
+template <class Key, class T, class Container, class Allocator> std::size_t RadixTrie<Key,T,Container,Allocator>::len_array(const Key* array) const{
+	std::size_t count = 0;
+	while(array[count]){ ++count; }
+	return count;
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::split(NodeRadix* ptr, std::size_t length){
+	// A new node with the first length symbols of the label takes the place of ptr, which keeps the rest of its label below it
+	NodeRadix* head = this->create(ptr->label(), 0, length, ptr->parent);
+	Key* label = ptr->label();
+	ptr->parent->children[label[0]] = head;
+	for(std::size_t i=length; i<ptr->length; ++i){
+		label[i-length] = std::move(label[i]);
+	}
+	for(std::size_t i=ptr->length-length; i<ptr->length; ++i){
+		std::destroy_at(label + i);
+	}
+	ptr->length -= (uint32_t) length;
+	ptr->parent = head;
+	head->children[label[0]] = ptr;
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::merge(NodeRadix* ptr){
+	// ptr holds no element and has a single child, whose label is appended to the one of ptr in place if it fits, or in a new node otherwise
+	NodeRadix* child = (NodeRadix*) ptr->children.begin()->second;
+	NodeRadix* node = ptr;
+	if(ptr->length + child->length > ptr->capacity()){
+		std::vector<Key> label(ptr->label(), ptr->label() + ptr->length);
+		label.insert(label.end(), child->label(), child->label() + child->length);
+		node = this->create(label, 0, label.size(), ptr->parent);
+		ptr->parent->children[label[0]] = node;
+	}else{
+		for(std::size_t i=0; i<child->length; ++i){
+			std::construct_at(ptr->label() + ptr->length + i, std::move(child->label()[i]));
+		}
+		ptr->length += child->length;
+	}
+	node->children = std::move(child->children);
+	node->value = std::move(child->value);
+	node->valid = child->valid;
+	for(auto it = node->children.begin(); it != node->children.end(); ++it){
+		((NodeRadix*) it->second)->parent = node;
+	}
+	this->destroy_node(child);
+	if(node != ptr){ this->destroy_node(ptr); }
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::remove_node(NodeRadix* ptr){
+	// A node without element is only kept while it has two or more children, the root is never removed
+	if(!ptr || !ptr->valid){ return; }
+	ptr->valid = false;
+	--this->counter;
+	if(ptr == &this->root){ return; }
+	if(!ptr->children.size()){
+		NodeRadix* parent = ptr->parent;
+		parent->children.erase(ptr->label()[0]);
+		this->destroy_node(ptr);
+		ptr = parent;
+		if(ptr == &this->root || ptr->valid){ return; }
+	}
+	if(ptr->children.size() == 1){
+		this->merge(ptr);
+	}
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::NodeRadix* RadixTrie<Key,T,Container,Allocator>::first_valid(NodeRadix* ptr){
+	// Only the root may hold no element and have no children
+	while(!ptr->valid){
+		if(!ptr->children.size()){ return 0; }
+		ptr = (NodeRadix*) ptr->children.begin()->second;
+	}
+	return ptr;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::NodeRadix* RadixTrie<Key,T,Container,Allocator>::next_subtree(NodeRadix* ptr){
+	// First element after every element in the subtree of ptr
+	while(ptr->parent){
+		auto it = ptr->parent->children.upper_bound(ptr->label()[0]);
+		if(it != ptr->parent->children.end()){ return first_valid((NodeRadix*) it->second); }
+		ptr = ptr->parent;
+	}
+	return 0;
+}
+
+// Iterator actions
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator_actions::iterator_actions() :
+	current(0),
+	data(key, nullvalue_value){ }
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator_actions::iterator_actions(const RadixTrie<Key,T,Container,Allocator>::iterator_actions& other) :
+	current(other.current),
+	key(other.key),
+	data(key, other.data.second){ }
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator_actions::iterator_actions(RadixTrie<Key,T,Container,Allocator>::iterator_actions&& other) :
+	current(other.current),
+	key(std::move(other.key)),
+	data(key, other.data.second){ }
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator_actions::iterator_actions(NodeRadix* ptr) :
+	current(0),
+	data(key, nullvalue_value){
+	// The key is the concatenation of the labels from the root
+	std::vector<const NodeRadix*> path;
+	for(const NodeRadix* tmp = ptr; tmp && tmp->parent; tmp = tmp->parent){
+		path.push_back(tmp);
+	}
+	for(auto it = path.rbegin(); it != path.rend(); ++it){
+		this->key.insert(this->key.end(), (*it)->label(), (*it)->label() + (*it)->length);
+	}
+	this->update(ptr);
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator_actions& RadixTrie<Key,T,Container,Allocator>::iterator_actions::operator=(const RadixTrie<Key,T,Container,Allocator>::iterator_actions& other){
+	this->key = other.key;
+	this->update(other.current);
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> RadixTrie<Key,T,Container,Allocator>::iterator_actions& RadixTrie<Key,T,Container,Allocator>::iterator_actions::operator=(RadixTrie<Key,T,Container,Allocator>::iterator_actions&& other){
+	this->key = std::move(other.key);
+	this->update(other.current);
+	return *this;
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::iterator_actions::update(NodeRadix* ptr){
+	this->current = ptr;
+	std::construct_at(&this->data, this->key, ptr ? ptr->value : nullvalue_value);
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::iterator_actions::next_element(){
+	NodeRadix* ptr = this->current;
+	if(ptr){
+		do{
+			if(ptr->children.size()){
+				ptr = (NodeRadix*) ptr->children.begin()->second;
+				this->key.insert(this->key.end(), ptr->label(), ptr->label() + ptr->length);
+			}else{
+				while(ptr->parent){
+					auto it = ptr->parent->children.upper_bound(ptr->label()[0]);
+					this->key.erase(this->key.end() - ptr->length, this->key.end());
+					if(it != ptr->parent->children.end()){
+						ptr = (NodeRadix*) it->second;
+						this->key.insert(this->key.end(), ptr->label(), ptr->label() + ptr->length);
+						break;
+					}
+					ptr = ptr->parent;
+				}
+				ptr = ptr->parent ? ptr : 0;
+			}
+		}while(ptr && !ptr->valid);
+		this->update(ptr);
+	}
+}
+template <class Key, class T, class Container, class Allocator> void RadixTrie<Key,T,Container,Allocator>::iterator_actions::previous_element(){
+	NodeRadix* ptr = this->current;
+	if(ptr){
+		do{
+			if(ptr->parent){
+				do{
+					auto it = ptr->parent->children.find(ptr->label()[0]);
+					this->key.erase(this->key.end() - ptr->length, this->key.end());
+					if(it != ptr->parent->children.begin()){
+						ptr = (NodeRadix*) (--it)->second;
+						this->key.insert(this->key.end(), ptr->label(), ptr->label() + ptr->length);
+						while(ptr->children.size()){
+							ptr = (NodeRadix*) ptr->children.rbegin()->second;
+							this->key.insert(this->key.end(), ptr->label(), ptr->label() + ptr->length);
+						}
+						break;
+					}
+					ptr = ptr->parent;
+					if(ptr->valid){ break; }
+				}while(ptr->parent);
+			}else{
+				ptr = 0;
+			}
+		}while(ptr && !ptr->valid);
+		this->update(ptr);
+	}
+}
+template <class Key, class T, class Container, class Allocator> bool RadixTrie<Key,T,Container,Allocator>::iterator_actions::operator==(const RadixTrie<Key,T,Container,Allocator>::iterator_actions& other) const{
+	return this->current == other.current;
+}
+template <class Key, class T, class Container, class Allocator> bool RadixTrie<Key,T,Container,Allocator>::iterator_actions::operator!=(const RadixTrie<Key,T,Container,Allocator>::iterator_actions& other) const{
+	return this->current != other.current;
+}
+
+template <class Key, class T, class Container, class Allocator> T RadixTrie<Key,T,Container,Allocator>::iterator_actions::nullvalue_value;
+
+		}
+		namespace serialize{
+
+template<typename Buff, typename... Types> std::size_t Serialize<Buff,bpp::collections::map::RadixTrie<Types...>>::operator()(Buff& buffer, const bpp::collections::map::RadixTrie<Types...>& obj) const{
+	std::size_t res = serialize(buffer, obj.size());
+	for(auto it = obj.cbegin(); it != obj.cend(); ++it){
+		res += serialize(buffer, it->first);
+		res += serialize(buffer, it->second);
+	}
+	return res;
+}
+template<typename Buff, typename... Types> std::size_t Deserialize<Buff,bpp::collections::map::RadixTrie<Types...>>::operator()(Buff& buffer, bpp::collections::map::RadixTrie<Types...>& obj) const{
+	typename bpp::collections::map::RadixTrie<Types...>::key_type key;
+	std::size_t objs, res = deserialize(buffer, objs);
+	obj.clear();
+	for(std::size_t i=0; i<objs; ++i){
+		res += deserialize(buffer, key);
+		res += deserialize(buffer, obj[key]);
+	}
+	return res;
+}
+
+		}
+	}
+}
+
+// Non-member
+// Other
+template<class A,class B,class C,class D, class Pred> std::size_t std::erase_if(bpp::collections::map::RadixTrie<A,B,C,D>& trie, Pred pred){
+	auto original = trie.size();
+	for (auto i = trie.begin(), last = trie.end(); i != last; ){
+		if(pred(*i)){
+			i = trie.erase(i);
+		}else{
+			++i;
+		}
+	}
+	return original - trie.size();
+}
+template<class A,class B,class C,class D> void std::swap(bpp::collections::map::RadixTrie<A,B,C,D>& lhs, bpp::collections::map::RadixTrie<A,B,C,D>& rhs){
+	bpp::collections::map::RadixTrie<A,B,C,D> tmp(std::move(lhs));
+	lhs = std::move(rhs);
+	rhs = std::move(tmp);
+}
+
+#endif
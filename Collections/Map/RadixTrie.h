@@ -0,0 +1,332 @@
+#ifndef BPP_COLLECTIONS_MAP_RADIXTRIE_H
+#define BPP_COLLECTIONS_MAP_RADIXTRIE_H
+#include <algorithm>		// std::min
+#include <compare>		// std::strong_ordering
+#include <cstdint>		// uint32_t
+#include <initializer_list>	// std::initializer_list<>
+#include <iterator>		// std::bidirectional_iterator_tag
+#include <map>			// std::map
+#include <memory>		// std::allocator<>, std::allocator_traits<>, std::construct_at, std::destroy_at
+#include <stdexcept>	// std::out_of_range
+#include <utility>		// std::move, std::pair
+#include <vector>		// std::vector
+#include "../Serialize.h"
+
+namespace bpp{
+	namespace collections{
+		namespace map{
+
+//! RadixTrie is a sorted associative container that contains key-value pairs with unique keys. Any indexed collection can be used as key for the RadixTrie, but the base type should be specified. The Container support class can be specified but by default std::map is used. Keys are sorted by using the comparison function within Container. Search, removal, and insertion operations have complexity linear in the length of the key. This is an implementation of a path-compressed trie (radix tree or Patricia trie).
+//! Unlike Trie, every chain of nodes with a single child and no element is collapsed into one node, which holds the whole sequence of symbols of the chain as its label, stored inline after the node in the same allocation. Insertions split a node when a key diverges in the middle of its label, and removals merge a node with its only child when the node no longer holds an element, so the number of nodes never exceeds twice the number of elements and searches take one hop per branching point instead of one per symbol.
+template <class Key, class T, class Container = std::map<Key, void*>, class Allocator = std::allocator<std::pair<const Key, T>>> class RadixTrie{
+	private:
+		struct NodeRadix;
+		struct Block;
+		struct iterator_actions;
+		// Rebind Allocator, nodes are allocated in blocks that also hold their labels
+		using AllocatorBlocks = typename std::allocator_traits<Allocator>::rebind_alloc<Block>;
+	public:
+		// Declares member types
+		//! Type of the keys for the key-value pairs.
+		using key_type = std::vector<Key>;
+		//! Type of the mapped values for the key-value pairs.
+		using mapped_type = T;
+		//! Type of the values stored in the map.
+		using value_type = std::pair<const std::vector<Key>, T>;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences (unused).
+		using difference_type = std::ptrdiff_t;
+		//! Type of allocator used.
+		using allocator_type = Allocator;
+		//! Type of references to values.
+		using reference = value_type&;
+		//! Type of constant references to values;
+		using const_reference = const value_type&;
+		//! Type of container node.
+		using node_type = NodeRadix;
+		//! Type of container.
+		using container_type = Container;
+		
+		//! Constructs an empty container.
+		RadixTrie();
+		//! Constructs an empty container. Receives the allocator to use for all memory allocations.
+		explicit RadixTrie(const Allocator& alloc);
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Receives the allocator to use for all memory allocations.
+		template <class InputIt> RadixTrie(InputIt first, InputIt last, const Allocator& alloc = Allocator());
+		//! Copy constructor. Constructs the container with the copy of the contents of other. Can receive the allocator to use for all memory allocations.
+		RadixTrie(const RadixTrie& other, const Allocator& alloc = Allocator());
+		//! Move constructor. Constructs the container with the contents of other using move semantics. After the move, other is guaranteed to be empty().
+		RadixTrie(RadixTrie&& other);
+		//! Constructs the container with the contents of the initializer list init. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the allocator to use for all memory allocations.
+		template <class Vector> RadixTrie(std::initializer_list<std::pair<const Vector, T>> ilist, const Allocator& alloc = Allocator());
+		
+		//! Destructs the map. The destructors of the elements are called and the used storage is deallocated. Note, that if the elements are pointers, the pointed-to objects are not destroyed.
+		~RadixTrie();
+		
+		// Assignment
+		//! Copy assignment operator. Replaces the contents with a copy of the contents of other.
+		RadixTrie& operator=(const RadixTrie& other);
+		//! Move assignment operator. Replaces the contents with those of other using move semantics (i.e. the data in other is moved from other into this container). After the move, other is guaranteed to be empty().
+		RadixTrie& operator=(RadixTrie&& other);
+		
+		// Get allocator
+		//! Returns the allocator associated with the container.
+		Allocator get_allocator() const noexcept;
+		
+		// Element access
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
+		template <class Vector> const T& at(const Vector& key) const;
+		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
+		template <class Vector> T& operator[](const Vector& key);
+		
+		// Iterators
+		//! iterator is an object that allows iteration of the container in the order of the sorted keys. Beware that any changes in the trie may invalidate the iterators and produce undefined behaviour.
+		struct iterator : public iterator_actions{
+			using iterator_actions::iterator_actions;
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const std::vector<Key>&, T&>;
+			//! Type of differences between iterators.
+			using difference_type = std::size_t;
+			//! Type of objects pointed to by the iterator.
+			using pointer = NodeRadix*;
+			//! Type of references to values.
+			using reference = std::pair<const std::vector<Key>&, T&>&;
+			//! References the key-value pair pointed at by the iterator.
+			std::pair<const std::vector<Key>&, T&>& operator*();
+			//! Dereferences the key-value pair pointed at by the iterator.
+			std::pair<const std::vector<Key>&, T&>* operator->();
+			//! Advances the iterator to the next key-value in the map.
+			iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			iterator operator--(int);
+		};
+		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only. Beware that any changes in the trie may invalidate the iterators and produce undefined behaviour.
+		struct const_iterator : public iterator_actions{
+			using iterator_actions::iterator_actions;
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = const std::pair<const std::vector<Key>&, const T&>;
+			//! Type of differences between iterators.
+			using difference_type = std::size_t;
+			//! Type of objects pointed to by the iterator.
+			using pointer = NodeRadix*;
+			//! Type of references to values.
+			using reference = const std::pair<const std::vector<Key>&, const T&>&;
+			//! References the key-value pair pointed at by the iterator.
+			const std::pair<const std::vector<Key>&, const T&>& operator*() const;
+			//! Dereferences the key-value pair pointed at by the iterator.
+			const std::pair<const std::vector<Key>&, const T&>* operator->() const;
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator& operator++();
+			//! Advances the iterator to the next key-value in the map.
+			const_iterator operator++(int);
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator& operator--();
+			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			const_iterator operator--(int);
+		};
+		//! reverse_iterator is an object that allows iteration of the container in the inverse order of the sorted keys. Beware that any changes in the trie may invalidate the iterators and produce undefined behaviour.
+		struct reverse_iterator : public iterator_actions{
+			using iterator_actions::iterator_actions;
+			//! Category of the iterator.
+			using iterator_category = std::bidirectional_iterator_tag;
+			//! Type of values accessed by the iterator.
+			using value_type = std::pair<const std::vector<Key>&, T&>;
+			//! Type of differences between iterators.
+			using difference_type = std::size_t;
+			//! Type of objects pointed to by the iterator.
+			using pointer = NodeRadix*;
+			//! Type of references to values.
+			using reference = std::pair<const std::vector<Key>&, T&>&;
+			//! Returns the underlying base iterator.
+			inline iterator base() const;
+			//! References the key-value pair pointed at by the iterator.
+			std::pair<const std::vector<Key>&, T&>& operator*();
+			//! Dereferences the key-value pair pointed at by the iterator.
+			std::pair<const std::vector<Key>&, T&>* operator->();
+			//! Advances the iterator to the previous key-value in the map.
+			reverse_iterator& operator++();
+			//! Advances the iterator to the previous key-value in the map.
+			reverse_iterator operator++(int);
+			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			reverse_iterator& operator--();
+			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			reverse_iterator operator--(int);
+		};
+		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		iterator begin() const;
+		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
+		const_iterator cbegin() const;
+		//! Returns an iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		iterator end() const noexcept;
+		//! Returns a constant iterator to the element following the last element of the map. This element acts as a placeholder; attempting to access it results in undefined behavior.
+		const_iterator cend() const noexcept;
+		//! Returns a reverse iterator to the first element of the reversed map. It corresponds to the last element of the non-reversed map. If the map is empty, the returned iterator is equal to rend().
+		reverse_iterator rbegin() const;
+		//! Returns a reverse iterator to the element following the last element of the reversed map. It corresponds to the element preceding the first element of the non-reversed map. This element acts as a placeholder, attempting to access it results in undefined behavior.
+		reverse_iterator rend() const noexcept;
+		
+		// Capacity
+		//! Checks if the container has no elements, i.e. whether begin() == end().
+		bool empty() const noexcept;
+		//! Returns the number of elements in the container.
+		std::size_t size() const noexcept;
+		//! Returns the number of nodes in the container, excluding the root.
+		std::size_t nodes() const noexcept;
+		//! Returns the total space in memory.
+		std::size_t memory() const noexcept;
+		
+		// Modifiers
+		// Clear
+		//! Erases all elements from the container. After this call, size() returns zero. Invalidates any references, pointers, or iterators referring to contained elements. Any past-the-end iterator remains valid.
+		void clear() noexcept;
+		// Insert
+		//! Inserts element(s) into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
+		template <class Vector> std::pair<iterator, bool> insert(const std::pair<Vector, T>& value);
+		//! Inserts element(s) into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
+		template <class Vector> std::pair<iterator, bool> insert(std::pair<Vector, T>&& value);
+		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		template <class InputIt> void insert(InputIt first, InputIt last);
+		// Insert or Assign
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		template <class Vector, class M> std::pair<iterator, bool> insert_or_assign(const Vector& k, M&& obj);
+		// Erase
+		//! Removes element at pos from the container. Returns iterator following the last removed element.
+		iterator erase(iterator pos);
+		//! Removes the elements in the range [first; last), which must be a valid range in *this.
+		iterator erase(iterator first, iterator last);
+		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
+		template <class Vector> std::size_t erase(const Vector& key);
+		
+		// Lookup
+		// Count
+		//! Returns the number of elements with key that compares equivalent to the specified key, which is either 1 or 0 since this container does not allow duplicates.
+		template <class K> std::size_t count(const K& key) const;
+		// Find
+		//! Finds an element with key equivalent to key and returns an iterator to the element. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator find(const K& key) const;
+		// Contains
+		//! Checks if there is an element with key that compares equivalent to the value x.
+		template <class K> bool contains(const K& key) const;
+		// Bounds
+		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value x. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator lower_bound(const K& key) const;
+		//! Returns an iterator pointing to the first element that compares greater to the value x. If no such element is found, past-the-end (see end()) iterator is returned.
+		template <class K> iterator upper_bound(const K& key) const;
+		//! Returns a range containing all elements with the given key in the container. The range is defined by two iterators, one pointing to the first element that is not less than key and another pointing to the first element greater than key. Alternatively, the first iterator may be obtained with lower_bound(), and the second with upper_bound().
+		template <class K> std::pair<iterator,iterator> equal_range(const K& key) const;
+		// Prefixes
+		//! Returns an iterator pointing to the element whose key is the longest prefix of key, which may be key itself. If no such element is found, past-the-end (see end()) iterator is returned. Only the path of key is walked, so the complexity is that of a single find().
+		template <class K> iterator longest_prefix_match(const K& key) const;
+		//! Returns iterators pointing to every element whose key is a prefix of key, which may be key itself, sorted by increasing length of the key. Only the path of key is walked, so the complexity is that of a single find() plus the construction of the iterators.
+		template <class K> std::vector<iterator> all_prefixes_of(const K& key) const;
+		//! Returns a range containing all elements whose key begins with prefix, in the order of the sorted keys. The range is defined by two iterators, one pointing to the first element that begins with prefix and another pointing to the first element after them. If no key begins with prefix, both iterators are equal to end(). Only the path of prefix is walked to find the range.
+		template <class K> std::pair<iterator,iterator> prefix_range(const K& prefix) const;
+		//! Returns the number of elements whose key begins with prefix. Linear complexity on the number of nodes below prefix.
+		template <class K> std::size_t count_prefix(const K& prefix) const;
+		// Non-member
+		// Operators
+		//! Checks if the contents of lhs and rhs are equal, that is, they have the same number of elements and each element in lhs compares equal with the element in rhs at the same position.
+		template<class A,class B,class C,class D> friend bool operator==(const RadixTrie<A,B,C,D>& lhs, const RadixTrie<A,B,C,D>& rhs);
+		//! Compares the contents of lhs and rhs lexicographically.
+		template<class A,class B,class C,class D> friend std::strong_ordering operator<=>(const RadixTrie<A,B,C,D>& lhs, const RadixTrie<A,B,C,D>& rhs);
+		// Other
+		//! Erases all elements that satisfy the predicate pred from the container.
+		template<class A,class B,class C,class D, class Pred> friend std::size_t std::erase_if(RadixTrie<A,B,C,D>& trie, Pred pred);
+		//! Specialized swapping function.
+		template<class A,class B,class C,class D> friend void std::swap(RadixTrie<A,B,C,D> &lhs, RadixTrie<A,B,C,D>& rhs);
+		// Friendship
+		//! Specialization of the Serialize template to support RadixTrie objects.
+		template<typename Buff, typename... Types> friend struct bpp::collections::serialize::Serialize;
+		//! Specialization of the Deserialize template to support RadixTrie objects.
+		template<typename Buff, typename... Types> friend struct bpp::collections::serialize::Deserialize;
+		
+	private:
+		// Nested class NodeRadix, its label follows it in the blocks allocated for it
+		struct NodeRadix{
+			NodeRadix *parent;
+			Container children;
+			T value;
+			uint32_t length, blocks;
+			bool valid;
+			NodeRadix(NodeRadix* parent=0, uint32_t blocks=0);
+			~NodeRadix();
+			inline Key* label();
+			inline const Key* label() const;
+			inline std::size_t capacity() const;
+			inline static std::size_t offset();
+			inline static std::size_t blocks_for(std::size_t length);
+		};
+		// Unit of allocation of the nodes and their labels
+		struct Block{
+			alignas(NodeRadix) alignas(Key) unsigned char bytes[1];
+		};
+		AllocatorBlocks alloc;
+		NodeRadix root;
+		std::size_t counter, nCounter, storage;
+		template <class Vector> inline NodeRadix* create(const Vector& key, std::size_t first, std::size_t length, NodeRadix* parent);
+		inline void destroy_node(NodeRadix* ptr);
+		inline void destroy(NodeRadix* ptr);
+		inline void copy(const NodeRadix* src);
+		inline void adopt(RadixTrie& other);
+		template <class Vector> inline NodeRadix* get_forward(const Vector& key, std::size_t size);
+		template <class Vector> inline NodeRadix* find_node(const Vector& key, std::size_t size) const;
+		template <class Vector> inline NodeRadix* bound_node(const Vector& key, std::size_t size, bool upper) const;
+		template <class Vector, class Function> inline void prefix_nodes(const Vector& key, std::size_t size, Function visit) const;
+		template <class Vector> inline NodeRadix* prefix_node(const Vector& key, std::size_t size) const;
+		template <class Vector> inline std::size_t len_array(const Vector& vec) const;
+		inline std::size_t len_array(const Key* array) const;
+		inline void split(NodeRadix* ptr, std::size_t length);
+		inline void merge(NodeRadix* ptr);
+		inline void remove_node(NodeRadix* ptr);
+		inline static NodeRadix* first_valid(NodeRadix* ptr);
+		inline static NodeRadix* next_subtree(NodeRadix* ptr);
+		// Iterator base structure
+		struct iterator_actions{
+			friend class RadixTrie<Key,T,Container,Allocator>;
+			iterator_actions();
+			iterator_actions(const iterator_actions& other);
+			iterator_actions(iterator_actions&& other);
+			iterator_actions(NodeRadix* ptr);
+			iterator_actions& operator=(const iterator_actions& other);
+			iterator_actions& operator=(iterator_actions&& other);
+			bool operator==(const iterator_actions& other) const;
+			bool operator!=(const iterator_actions& other) const;
+			protected:
+				NodeRadix* current;
+				std::vector<Key> key;
+				std::pair<const std::vector<Key>&, T&> data;
+				static T nullvalue_value;
+				inline void update(NodeRadix* ptr);
+				inline void next_element();
+				inline void previous_element();
+		};
+};
+
+		}
+		namespace serialize{
+
+//! Specialization of the Serialize template to support RadixTrie objects.
+template<typename Buff, typename... Types> struct Serialize<Buff,bpp::collections::map::RadixTrie<Types...>>{
+	std::size_t operator()(Buff& buffer, const bpp::collections::map::RadixTrie<Types...>& obj) const;
+};
+//! Specialization of the Deserialize template to support RadixTrie objects.
+template<typename Buff, typename... Types> struct Deserialize<Buff,bpp::collections::map::RadixTrie<Types...>>{
+	std::size_t operator()(Buff& buffer, bpp::collections::map::RadixTrie<Types...>& obj) const;
+};
+
+		}
+	}
+}
+
+#include "RadixTrie.cpp"
+
+#endif
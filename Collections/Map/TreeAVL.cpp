@@ -5,65 +5,108 @@ namespace bpp{
 	namespace collections{
 		namespace map{
 
+// Monoids
+template <class V> V SumMonoid<V>::identity(){
+	return V();
+}
+template <class V> V SumMonoid<V>::combine(const V& lhs, const V& rhs){
+	return lhs + rhs;
+}
+template <class V> template <class Element> V SumMonoid<V>::lift(const Element& element){
+	return element.second;
+}
+template <class V> V MinMonoid<V>::identity(){
+	return std::numeric_limits<V>::max();
+}
+template <class V> V MinMonoid<V>::combine(const V& lhs, const V& rhs){
+	return rhs < lhs ? rhs : lhs;
+}
+template <class V> template <class Element> V MinMonoid<V>::lift(const Element& element){
+	return element.second;
+}
+template <class V> V MaxMonoid<V>::identity(){
+	return std::numeric_limits<V>::lowest();
+}
+template <class V> V MaxMonoid<V>::combine(const V& lhs, const V& rhs){
+	return lhs < rhs ? rhs : lhs;
+}
+template <class V> template <class Element> V MaxMonoid<V>::lift(const Element& element){
+	return element.second;
+}
+
 // Empty initialization
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL() :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL() :
 	root(0),
+	rightmost(0),
 	counter(0){ }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(const Compare& comp, const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(const Compare& comp, const Allocator& alloc) :
 	alloc(alloc),
 	cmp(comp),
 	root(0),
+	rightmost(0),
 	counter(0){ }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(const Allocator& alloc) :
 	alloc(alloc),
 	root(0),
+	rightmost(0),
 	counter(0){ }
 
 // Iterator initilization
-template <class Key, class T, class Compare, class Allocator> template <class InputIt> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(InputIt first, InputIt last, const Compare& comp, const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class InputIt> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(InputIt first, InputIt last, const Compare& comp, const Allocator& alloc) :
 	alloc(alloc),
 	cmp(comp),
 	root(0),
+	rightmost(0),
 	counter(0){
+	if(this->build_sorted(first, last)){ return; }
 	for(auto it = first; it != last; ++it){
-		this->get_forward(it->first)->data.second = it->second;
+		this->assign_mapped(this->get_forward(it->first), it->second);
 	}
 }
-template <class Key, class T, class Compare, class Allocator> template <class InputIt> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(InputIt first, InputIt last, const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class InputIt> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(InputIt first, InputIt last, const Allocator& alloc) :
 	alloc(alloc),
 	root(0),
+	rightmost(0),
 	counter(0){
+	if(this->build_sorted(first, last)){ return; }
 	for(auto it = first; it != last; ++it){
-		this->get_forward(it->first)->data.second = it->second;
+		this->assign_mapped(this->get_forward(it->first), it->second);
 	}
 }
 
 // Copy constructor
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(const TreeAVL& other) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(const TreeAVL& other) :
 	alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator())),
 	root(other.root ? NodeAVL::copy(this->alloc, other.root) : 0),
+	rightmost(0),
 	counter(other.counter){ }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(const TreeAVL& other, const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(const TreeAVL& other, const Allocator& alloc) :
 	alloc(alloc),
 	root(other.root ? NodeAVL::copy(this->alloc, other.root) : 0),
+	rightmost(0),
 	counter(other.counter){ }
 
 // Move constructor
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(TreeAVL&& other) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(TreeAVL&& other) :
 	alloc(std::move(other.alloc)),
 	cmp(std::move(other.cmp)),
 	root(other.root),
+	rightmost(other.rightmost),
 	counter(other.counter){
 	other.root = 0;
+	other.rightmost = 0;
 	other.counter = 0;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(TreeAVL&& other, const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(TreeAVL&& other, const Allocator& alloc) :
 	alloc(alloc),
 	cmp(std::move(other.cmp)),
+	rightmost(0),
 	counter(other.counter){
 	if(this->alloc == other.alloc){
 		this->root = other.root;
+		this->rightmost = other.rightmost;
 		other.root = 0;
+		other.rightmost = 0;
 		other.counter = 0;
 	}else{
 		this->root = other.root ? NodeAVL::copy(this->alloc, other.root) : 0;
@@ -72,426 +115,677 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 }
 
 // Initializer list initialization
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp, const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Compare& comp, const Allocator& alloc) :
 	alloc(alloc),
 	cmp(comp),
 	root(0),
+	rightmost(0),
 	counter(0){
+	if(this->build_sorted(ilist.begin(), ilist.end())){ return; }
 	for(auto it : ilist){
-		this->get_forward(it.first)->data.second = it.second;
+		this->assign_mapped(this->get_forward(it.first), it.second);
 	}
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::TreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Allocator& alloc) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::TreeAVL(std::initializer_list<std::pair<const Key, T>> ilist, const Allocator& alloc) :
 	alloc(alloc),
 	root(0),
+	rightmost(0),
 	counter(0){
+	if(this->build_sorted(ilist.begin(), ilist.end())){ return; }
 	for(auto it : ilist){
-		this->get_forward(it.first)->data.second = it.second;
+		this->assign_mapped(this->get_forward(it.first), it.second);
 	}
 }
 
 // Destructor
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::~TreeAVL(){
-	if(this->root){ NodeAVL::destroy(this->alloc,this->root); }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::~TreeAVL(){
+	if(this->root){ this->destroy_nodes(); }
 }
 
 // Assignment
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>& TreeAVL<Key,T,Compare,Allocator>::operator=(const TreeAVL<Key,T,Compare,Allocator>& other){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::operator=(const TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& other){
 	this->sp_copy(other, typename std::allocator_traits<Allocator>::propagate_on_container_copy_assignment());
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>& TreeAVL<Key,T,Compare,Allocator>::operator=(TreeAVL<Key,T,Compare,Allocator>&& other){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::operator=(TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>&& other){
 	this->sp_move(std::move(other), typename std::allocator_traits<Allocator>::propagate_on_container_move_assignment());
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>& TreeAVL<Key,T,Compare,Allocator>::operator=(std::initializer_list<std::pair<const Key, T>> ilist){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::operator=(std::initializer_list<std::pair<const Key, T>> ilist){
 	this->clear();
+	if(this->build_sorted(ilist.begin(), ilist.end())){ return *this; }
 	for(auto it : ilist){
-		this->get_forward(it.first)->data.second = it.second;
+		this->assign_mapped(this->get_forward(it.first), it.second);
 	}
 	return *this;
 }
 
 // Get allocator
-template <class Key, class T, class Compare, class Allocator> Allocator TreeAVL<Key,T,Compare,Allocator>::get_allocator() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> Allocator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::get_allocator() const noexcept{
 	return this->alloc;
 }
 
 // Element access
-template <class Key, class T, class Compare, class Allocator> const T& TreeAVL<Key,T,Compare,Allocator>::at(const Key& key) const{
-	NodeAVL* tmp = this->root;
-	while(tmp && tmp->data.first!=key){
-		tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild;
-	}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> const T& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::at(const Key& key) const{
+	NodeAVL* tmp = this->find_node(key);
 	if(!tmp){ throw std::out_of_range("bpp::collections::map::TreeAVL::at"); }
 	return tmp->data.second;
 }
-template <class Key, class T, class Compare, class Allocator> T& TreeAVL<Key,T,Compare,Allocator>::operator[](const Key& key){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> const T& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::at(const K& key) const requires transparent{
+	NodeAVL* tmp = this->find_node(key);
+	if(!tmp){ throw std::out_of_range("bpp::collections::map::TreeAVL::at"); }
+	return tmp->data.second;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> T& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::operator[](const Key& key){
 	return this->get_forward(key)->data.second;
 }
-template <class Key, class T, class Compare, class Allocator> T& TreeAVL<Key,T,Compare,Allocator>::operator[](Key&& key){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> T& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::operator[](Key&& key){
 	return this->get_forward(key)->data.second;
 }
 
 // Iterators
 // Iterator
-template <class Key, class T, class Compare, class Allocator> std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator>::iterator::operator*() const{
-	return this->current ? this->current->data : this->nullvalue;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator::iterator(NodeAVL* init, const TreeAVL* tree) : 
+	iterator_actions(init, tree){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator::operator*() const{
+	return this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator>::iterator::operator->() const{
-	return this->current ? &this->current->data : 0;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator::operator->() const{
+	return &this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator& TreeAVL<Key,T,Compare,Allocator>::iterator::operator++(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator::operator++(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::iterator::operator++(int){
-	iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator::operator++(int){
+	iterator pit(*this);
 	this->next_element();
 	return pit;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator& TreeAVL<Key,T,Compare,Allocator>::iterator::operator--(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator::operator--(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::iterator::operator--(int){
-	iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator::operator--(int){
+	iterator pit(*this);
 	this->previous_element();
 	return pit;
 }
 // Constant Iterator
-template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator>::const_iterator::operator*() const{
-	return this->current ? this->current->data : this->nullvalue;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::const_iterator(NodeAVL* init, const TreeAVL* tree) : 
+	iterator_actions(init, tree){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::const_iterator(const iterator& other) : 
+	iterator_actions(other.current, other.tree){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> const std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::operator*() const{
+	return this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator>::const_iterator::operator->() const{
-	return this->current ? &this->current->data : 0;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> const std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::operator->() const{
+	return &this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator& TreeAVL<Key,T,Compare,Allocator>::const_iterator::operator++(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::operator++(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::const_iterator::operator++(int){
-	const_iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::operator++(int){
+	const_iterator pit(*this);
 	this->next_element();
 	return pit;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator& TreeAVL<Key,T,Compare,Allocator>::const_iterator::operator--(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::operator--(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::const_iterator::operator--(int){
-	const_iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator::operator--(int){
+	const_iterator pit(*this);
 	this->previous_element();
 	return pit;
 }
 // Reverse Iterator
-template <class Key, class T, class Compare, class Allocator> constexpr TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::reverse_iterator::base() const{ return iterator(this->current); }
-template <class Key, class T, class Compare, class Allocator> std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator>::reverse_iterator::operator*() const{
-	return this->current ? this->current->data : this->nullvalue;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::reverse_iterator(NodeAVL* init, const TreeAVL* tree) : 
+	iterator_actions(init, tree){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> constexpr TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::base() const{ return iterator(this->current, this->tree); }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::operator*() const{
+	return this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator>::reverse_iterator::operator->() const{
-	return this->current ? &this->current->data : 0;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::operator->() const{
+	return &this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::reverse_iterator& TreeAVL<Key,T,Compare,Allocator>::reverse_iterator::operator++(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::operator++(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::reverse_iterator TreeAVL<Key,T,Compare,Allocator>::reverse_iterator::operator++(int){
-	reverse_iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::operator++(int){
+	reverse_iterator pit(*this);
 	this->previous_element();
 	return pit;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::reverse_iterator& TreeAVL<Key,T,Compare,Allocator>::reverse_iterator::operator--(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::operator--(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::reverse_iterator TreeAVL<Key,T,Compare,Allocator>::reverse_iterator::operator--(int){
-	reverse_iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator::operator--(int){
+	reverse_iterator pit(*this);
 	this->next_element();
 	return pit;
 }
 // Constant Reverse Iterator
-template <class Key, class T, class Compare, class Allocator> constexpr TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator::base() const{ return const_iterator(this->current); }
-template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator::operator*() const{
-	return this->current ? this->current->data : this->nullvalue;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::const_reverse_iterator(NodeAVL* init, const TreeAVL* tree) : 
+	iterator_actions(init, tree){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> constexpr TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::base() const{ return const_iterator(this->current, this->tree); }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> const std::pair<const Key, T>& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::operator*() const{
+	return this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> const std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator::operator->() const{
-	return this->current ? &this->current->data : 0;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> const std::pair<const Key, T>* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::operator->() const{
+	return &this->current->data;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator& TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator::operator++(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::operator++(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator::operator++(int){
-	const_reverse_iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::operator++(int){
+	const_reverse_iterator pit(*this);
 	this->previous_element();
 	return pit;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator& TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator::operator--(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::operator--(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator::operator--(int){
-	const_reverse_iterator pit(this->current);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator::operator--(int){
+	const_reverse_iterator pit(*this);
 	this->next_element();
 	return pit;
 }
 
 // Iterator generation methods
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::begin() noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::begin() noexcept{
 	NodeAVL* tmp = this->root;
 	while(tmp && tmp->leftChild){ tmp = tmp->leftChild; }
-	return iterator(tmp);
+	return iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::begin() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::begin() const noexcept{
 	NodeAVL* tmp = this->root;
 	while(tmp && tmp->leftChild){ tmp = tmp->leftChild; }
-	return const_iterator(tmp);
+	return const_iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::cbegin() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::cbegin() const noexcept{
 	NodeAVL* tmp = this->root;
 	while(tmp && tmp->leftChild){ tmp = tmp->leftChild; }
-	return const_iterator(tmp);
+	return const_iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::end() noexcept{
-	return iterator();
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::end() noexcept{
+	return iterator(0, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::end() const noexcept{
-	return const_iterator();
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::end() const noexcept{
+	return const_iterator(0, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::cend() const noexcept{
-	return const_iterator();
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::cend() const noexcept{
+	return const_iterator(0, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::reverse_iterator TreeAVL<Key,T,Compare,Allocator>::rbegin() noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rbegin() noexcept{
 	NodeAVL* tmp = this->root;
 	while(tmp && tmp->rightChild){ tmp = tmp->rightChild; }
-	return reverse_iterator(tmp);
+	return reverse_iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator>::rbegin() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rbegin() const noexcept{
 	NodeAVL* tmp = this->root;
 	while(tmp && tmp->rightChild){ tmp = tmp->rightChild; }
-	return const_reverse_iterator(tmp);
+	return const_reverse_iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator>::crbegin() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::crbegin() const noexcept{
 	NodeAVL* tmp = this->root;
 	while(tmp && tmp->rightChild){ tmp = tmp->rightChild; }
-	return const_reverse_iterator(tmp);
+	return const_reverse_iterator(tmp, this);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rend() noexcept{
+	return reverse_iterator(0, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::reverse_iterator TreeAVL<Key,T,Compare,Allocator>::rend() noexcept{
-	return reverse_iterator();
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rend() const noexcept{
+	return const_reverse_iterator(0, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator>::rend() const noexcept{
-	return const_reverse_iterator();
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::crend() const noexcept{
+	return const_reverse_iterator(0, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::const_reverse_iterator TreeAVL<Key,T,Compare,Allocator>::crend() const noexcept{
-	return const_reverse_iterator();
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::view_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::view() noexcept{
+	return view_type(this->begin(), std::default_sentinel, this->counter);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_view_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::view() const noexcept{
+	return const_view_type(this->begin(), std::default_sentinel, this->counter);
 }
 
 // Capacity
-template <class Key, class T, class Compare, class Allocator> bool TreeAVL<Key,T,Compare,Allocator>::empty() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> bool TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::empty() const noexcept{
 	return this->counter == 0;
 }
-template <class Key, class T, class Compare, class Allocator> std::size_t TreeAVL<Key,T,Compare,Allocator>::size() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::size() const noexcept{
 	return this->counter;
 }
-template <class Key, class T, class Compare, class Allocator> std::size_t TreeAVL<Key,T,Compare,Allocator>::memory() const noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::memory() const noexcept{
 	return sizeof(TreeAVL) + this->counter*sizeof(NodeAVL);
 }
 
 // Modifiers
 // Clear
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::clear() noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::clear() noexcept{
 	if(this->root){
-		NodeAVL::destroy(this->alloc,this->root);
+		this->destroy_nodes();
 		this->root = 0;
+		this->rightmost = 0;
 		this->counter = 0;
 	}
 }
 // Insert
-template <class Key, class T, class Compare, class Allocator> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::iterator, bool> TreeAVL<Key,T,Compare,Allocator>::insert(const std::pair<const Key, T>& value){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator, bool> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(const std::pair<const Key, T>& value){
 	std::size_t pcounter = this->counter;
 	NodeAVL* tmp = this->get_forward(value.first);
-	if(pcounter != this->counter){ tmp->data.second = value.second; }
-	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+	if(pcounter != this->counter){ this->assign_mapped(tmp, value.second); }
+	return std::pair<iterator, bool>(iterator(tmp, this), pcounter != this->counter);
 }
-template <class Key, class T, class Compare, class Allocator> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::iterator, bool> TreeAVL<Key,T,Compare,Allocator>::insert(std::pair<const Key, T>&& value){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator, bool> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(std::pair<const Key, T>&& value){
 	std::size_t pcounter = this->counter;
 	NodeAVL* tmp = this->get_forward(value.first);
-	if(pcounter != this->counter){ tmp->data.second = value.second; }
-	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+	if(pcounter != this->counter){ this->assign_mapped(tmp, value.second); }
+	return std::pair<iterator, bool>(iterator(tmp, this), pcounter != this->counter);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::insert(TreeAVL<Key,T,Compare,Allocator>::iterator hint, const std::pair<const Key, T>& value){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator hint, const std::pair<const Key, T>& value){
 	std::size_t pcounter = this->counter;
 	NodeAVL* tmp = this->get_forward(value.first, hint.current);
-	if(pcounter != this->counter){ tmp->data.second = value.second; }
-	return iterator(tmp);
+	if(pcounter != this->counter){ this->assign_mapped(tmp, value.second); }
+	return iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::insert(TreeAVL<Key,T,Compare,Allocator>::iterator hint, std::pair<const Key, T>&& value){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator hint, std::pair<const Key, T>&& value){
 	std::size_t pcounter = this->counter;
 	NodeAVL* tmp = this->get_forward(value.first, hint.current);
-	if(pcounter != this->counter){ tmp->data.second = value.second; }
-	return iterator(tmp);
+	if(pcounter != this->counter){ this->assign_mapped(tmp, value.second); }
+	return iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> template <class InputIt> void TreeAVL<Key,T,Compare,Allocator>::insert(InputIt first, InputIt last){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class InputIt> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(InputIt first, InputIt last){
+	if(!this->counter && this->build_sorted(first, last)){ return; }
 	for(auto it = first; it != last; ++it){
 		std::size_t pcounter = this->counter;
 		NodeAVL* tmp = this->get_forward(it->first);
-		if(pcounter != this->counter){ tmp->data.second = it->second; }
+		if(pcounter != this->counter){ this->assign_mapped(tmp, it->second); }
 	}
 }
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::insert(std::initializer_list<std::pair<const Key, T>> ilist){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(std::initializer_list<std::pair<const Key, T>> ilist){
+	if(!this->counter && this->build_sorted(ilist.begin(), ilist.end())){ return; }
 	for(auto it : ilist){
 		std::size_t pcounter = this->counter;
 		NodeAVL* tmp = this->get_forward(it.first);
-		if(pcounter != this->counter){ tmp->data.second = it.second; }
+		if(pcounter != this->counter){ this->assign_mapped(tmp, it.second); }
 	}
 }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert_return_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(node_type&& nh){
+	NodeAVL *parent, **link;
+	if(!nh.node){ return insert_return_type{this->end(), false, node_type()}; }
+	if(!(link = this->search_link(nh.node->data.first, parent))){ return insert_return_type{iterator(parent, this), false, std::move(nh)}; }
+	NodeAVL* tmp = this->take_node(nh.node, nh.alloc);
+	nh.node = 0;
+	this->link_node(tmp, parent, link);
+	return insert_return_type{iterator(tmp, this), true, node_type()};
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert(const_iterator hint, node_type&& nh){
+	// nh is only emptied once its node has been linked, so it keeps its element if the key already exists
+	NodeAVL *parent, **link;
+	if(!nh.node){ return this->end(); }
+	if(!(link = this->hint_link(nh.node->data.first, hint.current, parent))){ return iterator(parent, this); }
+	NodeAVL* tmp = this->take_node(nh.node, nh.alloc);
+	nh.node = 0;
+	this->link_node(tmp, parent, link);
+	return iterator(tmp, this);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class InputIt> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::assign_sorted(InputIt first, InputIt last) requires std::forward_iterator<InputIt>{
+	this->clear();
+	this->counter = std::distance(first, last);
+	this->root = this->build_subtree(first, this->counter, 0);
+}
 // Insert or Assign
-template <class Key, class T, class Compare, class Allocator> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::iterator, bool> TreeAVL<Key,T,Compare,Allocator>::insert_or_assign(const Key& k, M&& obj){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator, bool> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert_or_assign(const Key& k, M&& obj){
 	std::size_t pcounter = this->counter;
 	NodeAVL* tmp = this->get_forward(k);
-	tmp->data.second = obj;
-	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+	this->assign_mapped(tmp, std::forward<M>(obj));
+	return std::pair<iterator, bool>(iterator(tmp, this), pcounter != this->counter);
 }
-template <class Key, class T, class Compare, class Allocator> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::iterator, bool> TreeAVL<Key,T,Compare,Allocator>::insert_or_assign(Key&& k, M&& obj){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator, bool> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert_or_assign(Key&& k, M&& obj){
 	std::size_t pcounter = this->counter;
 	NodeAVL* tmp = this->get_forward(k);
-	tmp->data.second = obj;
-	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+	this->assign_mapped(tmp, std::forward<M>(obj));
+	return std::pair<iterator, bool>(iterator(tmp, this), pcounter != this->counter);
 }
-template <class Key, class T, class Compare, class Allocator> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::iterator, bool> TreeAVL<Key,T,Compare,Allocator>::insert_or_assign(TreeAVL<Key,T,Compare,Allocator>::iterator hint, const Key& k, M&& obj){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator, bool> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert_or_assign(TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator hint, const Key& k, M&& obj){
 	std::size_t pcounter = this->counter;
 	NodeAVL* tmp = this->get_forward(k, hint.current);
-	tmp->data.second = obj;
-	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+	this->assign_mapped(tmp, std::forward<M>(obj));
+	return std::pair<iterator, bool>(iterator(tmp, this), pcounter != this->counter);
 }
-template <class Key, class T, class Compare, class Allocator> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::iterator, bool> TreeAVL<Key,T,Compare,Allocator>::insert_or_assign(TreeAVL<Key,T,Compare,Allocator>::iterator hint, Key&& k, M&& obj){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class M> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator, bool> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::insert_or_assign(TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator hint, Key&& k, M&& obj){
 	std::size_t pcounter = this->counter;
-	NodeAVL* tmp = this->get_forward(k, hint.current);
-	tmp->data.second = obj;
-	return std::pair<iterator, bool>(iterator(tmp), pcounter != this->counter);
+	NodeAVL* tmp = this->get_forward(std::move(k), hint.current);
+	this->assign_mapped(tmp, std::forward<M>(obj));
+	return std::pair<iterator, bool>(iterator(tmp, this), pcounter != this->counter);
 }
 // Erase
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::erase(iterator pos){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase(iterator pos){
 	NodeAVL *tmp = pos.current;
 	const Key k = pos.current->data.first;
 	tmp = this->remove_node(tmp);
-	iterator it(tmp);
+	iterator it(tmp, this);
 	if(tmp && this->cmp(tmp->data.first, k)){ ++it; }
 	return it;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::erase(const_iterator pos){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase(const_iterator pos){
 	NodeAVL *tmp = pos.current;
 	const Key k = pos.current->data.first;
 	tmp = this->remove_node(tmp);
-	iterator it(tmp);
+	iterator it(tmp, this);
 	if(tmp && this->cmp(tmp->data.first, k)){ ++it; }
 	return it;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::erase(iterator first, iterator last){
-	while(first != last){
-		first = erase(first);
-	}
-	return first;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase(iterator first, iterator last){
+	return iterator(this->erase_nodes(first.current, last.current), this);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::erase(const_iterator first, const_iterator last){
-	iterator it;
-	it.current = first.current;
-	while(it != last){
-		it = erase(it);
-	}
-	return it;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase(const_iterator first, const_iterator last){
+	return iterator(this->erase_nodes(first.current, last.current), this);
 }
-template <class Key, class T, class Compare, class Allocator> std::size_t TreeAVL<Key,T,Compare,Allocator>::erase(const Key& key){
-	NodeAVL *tmp = this->root;
-	while(tmp && tmp->data.first!=key){ tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild; }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase(const Key& key){
+	NodeAVL *tmp = this->find_node(key);
 	this->remove_node(tmp);
 	return tmp ? 1 : 0;
 }
-template <class Key, class T, class Compare, class Allocator> template <class K> std::size_t TreeAVL<Key,T,Compare,Allocator>::erase(K&& key){
-	NodeAVL *tmp = this->root;
-	while(tmp && tmp->data.first!=key){ tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild; }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase(K&& key){
+	lookup_key<std::remove_cvref_t<K>> k = key;
+	NodeAVL *tmp = this->find_node(k);
 	this->remove_node(tmp);
 	return tmp ? 1 : 0;
 }
+// Extract and merge
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::extract(iterator pos){
+	this->unlink_node(pos.current);
+	return node_type(pos.current, this->alloc);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::extract(const_iterator pos){
+	this->unlink_node(pos.current);
+	return node_type(pos.current, this->alloc);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::extract(const K& key){
+	lookup_key<K> k = key;
+	NodeAVL* tmp = this->find_node(k);
+	if(!tmp){ return node_type(); }
+	this->unlink_node(tmp);
+	return node_type(tmp, this->alloc);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::merge(TreeAVL& source){
+	// The successor is taken before unlinking, unlink_node() relinks nodes instead of moving elements so it stays valid
+	NodeAVL *node = source.root, *next, *parent, **link;
+	if(this == &source || !node){ return; }
+	while(node->leftChild){ node = node->leftChild; }
+	while(node){
+		iterator it(node);
+		next = (++it).current;
+		if((link = this->search_link(node->data.first, parent))){
+			source.unlink_node(node);
+			this->link_node(this->take_node(node, source.alloc), parent, link);
+		}
+		node = next;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::merge(TreeAVL&& source){
+	this->merge(source);
+}
+// Join and split
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::join(TreeAVL&& other){
+	NodeAVL *last = this->root, *first = other.root;
+	if(this->alloc != other.alloc){
+		for(auto it = other.begin(); it != other.end(); ++it){ this->insert(*it); }
+		other.clear();
+		return;
+	}
+	if(last && first){
+		while(last->rightChild){ last = last->rightChild; }
+		while(first->leftChild){ first = first->leftChild; }
+		this->root = this->cmp(last->data.first, first->data.first) ? join_nodes(this->root, other.root) : join_nodes(other.root, this->root);
+	}else{
+		this->root = last ? last : first;
+	}
+	this->rightmost = 0;
+	this->counter += other.counter;
+	other.root = 0;
+	other.rightmost = 0;
+	other.counter = 0;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::join(const std::pair<const Key, T>& value, TreeAVL&& other){
+	NodeAVL* node;
+	if(this->alloc != other.alloc){
+		this->insert(value);
+		for(auto it = other.begin(); it != other.end(); ++it){ this->insert(*it); }
+		other.clear();
+		return;
+	}
+	node = this->alloc.allocate(1);
+	std::construct_at(node, value.first);
+	node->data.second = value.second;
+	this->root = join_nodes(this->root, node, other.root);
+	this->rightmost = 0;
+	this->counter += other.counter + 1;
+	other.root = 0;
+	other.rightmost = 0;
+	other.counter = 0;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::split(const K& key){
+	TreeAVL result(this->cmp);
+	lookup_key<K> k = key;
+	NodeAVL *left, *right, *found = this->split_nodes(this->root, k, left, right);
+	if(found){ right = join_nodes(0, found, right); }
+	result.alloc = this->alloc;
+	result.counter = this->counter;
+	this->counter = this->recount(left, right, this->counter);
+	result.counter -= this->counter;
+	this->root = left;
+	this->rightmost = 0;
+	result.root = right;
+	return result;
+}
+// Set operations
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::set_union(TreeAVL&& other){
+	std::size_t repeated = 0;
+	if(this->alloc != other.alloc){
+		for(auto it = other.begin(); it != other.end(); ++it){ this->insert(*it); }
+		other.clear();
+		return;
+	}
+	this->root = this->union_nodes(this->root, other.root, repeated);
+	this->rightmost = 0;
+	this->counter += other.counter - repeated;
+	other.root = 0;
+	other.rightmost = 0;
+	other.counter = 0;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::set_intersection(const TreeAVL& other){
+	std::size_t kept = 0;
+	this->root = this->intersection_nodes(this->root, other.root, kept);
+	this->rightmost = 0;
+	this->counter = kept;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::set_difference(const TreeAVL& other){
+	std::size_t removed = 0;
+	this->root = this->difference_nodes(this->root, other.root, removed);
+	this->rightmost = 0;
+	this->counter -= removed;
+}
 
 // Lookup
 // Count
-template <class Key, class T, class Compare, class Allocator> template <class K> std::size_t TreeAVL<Key,T,Compare,Allocator>::count(const K& key) const{
-	NodeAVL* tmp = this->root;
-	while(tmp && tmp->data.first!=key){ tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild; }
-	return tmp ? 1 : 0;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::count(const K& key) const{
+	lookup_key<K> k = key;
+	return this->find_node(k) ? 1 : 0;
 }
 // Find
-template <class Key, class T, class Compare, class Allocator> template <class K> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::find(const K& key){
-	NodeAVL* tmp = this->root;
-	while(tmp && tmp->data.first!=key){ tmp = (this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild); }
-	return iterator(tmp);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::find(const K& key){
+	lookup_key<K> k = key;
+	return iterator(this->find_node(k), this);
 }
-template <class Key, class T, class Compare, class Allocator> template <class K> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::find(const K& key) const{
-	NodeAVL* tmp = this->root;
-	while(tmp && tmp->data.first!=key){ tmp = (this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild); }
-	return const_iterator(tmp);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::find(const K& key) const{
+	lookup_key<K> k = key;
+	return const_iterator(this->find_node(k), this);
 }
 
 // Contains
-template <class Key, class T, class Compare, class Allocator> template <class K> bool TreeAVL<Key,T,Compare,Allocator>::contains(const K& key) const{
-	NodeAVL* tmp = this->root;
-	while(tmp && tmp->data.first!=key){ tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild; }
-	return tmp;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> bool TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::contains(const K& key) const{
+	lookup_key<K> k = key;
+	return this->find_node(k);
+}
+
+// Batched lookup
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class ForwardIt, class OutputIt> OutputIt TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::find_many(ForwardIt first, ForwardIt last, OutputIt d_first){
+	this->lookup_many(first, last, [&](NodeAVL* node){ *d_first++ = iterator(node, this); });
+	return d_first;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class ForwardIt, class OutputIt> OutputIt TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::find_many(ForwardIt first, ForwardIt last, OutputIt d_first) const{
+	this->lookup_many(first, last, [&](NodeAVL* node){ *d_first++ = const_iterator(node, this); });
+	return d_first;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class ForwardIt, class OutputIt> OutputIt TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::contains_many(ForwardIt first, ForwardIt last, OutputIt d_first) const{
+	this->lookup_many(first, last, [&](NodeAVL* node){ *d_first++ = node != 0; });
+	return d_first;
 }
 
 // Bounds
-template <class Key, class T, class Compare, class Allocator> template <class K> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::lower_bound(const K& key){
-	NodeAVL *tmp = this->root, *prev = 0;
-	while(tmp && tmp->data.first!=key){
-		prev = tmp;
-		tmp = (this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild);
-	}
-	iterator it(tmp ? tmp : prev);
-	if(it.current && this->cmp(it.current->data.first, key)){ ++it; }
-	return it;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::lower_bound(const K& key){
+	lookup_key<K> k = key;
+	return iterator(this->lower_node(k), this);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::lower_bound(const K& key) const{
+	lookup_key<K> k = key;
+	return const_iterator(this->lower_node(k), this);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::upper_bound(const K& key){
+	lookup_key<K> k = key;
+	return iterator(this->upper_node(k), this);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::upper_bound(const K& key) const{
+	lookup_key<K> k = key;
+	return const_iterator(this->upper_node(k), this);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator, typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::equal_range(const K& key){
+	return std::pair<iterator,iterator>(this->lower_bound(key), this->upper_bound(key));
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> std::pair<typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator,typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::equal_range(const K& key) const{
+    return std::pair<const_iterator,const_iterator>(this->lower_bound(key), this->upper_bound(key));
+}
+
+// Order statistics
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::select(std::size_t k) requires Ranked{
+	NodeAVL* tmp = k < this->counter ? this->root : 0;
+	while(tmp && k != count_of(tmp->leftChild)){
+		if(k < count_of(tmp->leftChild)){
+			tmp = tmp->leftChild;
+		}else{
+			k -= count_of(tmp->leftChild) + 1;
+			tmp = tmp->rightChild;
+		}
+	}
+	return iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> template <class K> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::lower_bound(const K& key) const{
-    NodeAVL *tmp = this->root, *prev = 0;
-	while(tmp && tmp->data.first!=key){
-		prev = tmp;
-		tmp = (this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::const_iterator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::select(std::size_t k) const requires Ranked{
+	NodeAVL* tmp = k < this->counter ? this->root : 0;
+	while(tmp && k != count_of(tmp->leftChild)){
+		if(k < count_of(tmp->leftChild)){
+			tmp = tmp->leftChild;
+		}else{
+			k -= count_of(tmp->leftChild) + 1;
+			tmp = tmp->rightChild;
+		}
 	}
-	const_iterator it(tmp ? tmp : prev);
-	if(it.current && this->cmp(it.current->data.first, key)){ ++it; }
-	return it;
+	return const_iterator(tmp, this);
 }
-template <class Key, class T, class Compare, class Allocator> template <class K> TreeAVL<Key,T,Compare,Allocator>::iterator TreeAVL<Key,T,Compare,Allocator>::upper_bound(const K& key){
-	NodeAVL *tmp = this->root, *prev = 0;
-	while(tmp && tmp->data.first!=key){
-		prev = tmp;
-		tmp = (this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rank(const K& key) const requires Ranked{
+	lookup_key<K> k = key;
+	NodeAVL* tmp = this->root;
+	std::size_t result = 0;
+	while(tmp){
+		if(this->cmp(tmp->data.first, k)){
+			result += count_of(tmp->leftChild) + 1;
+			tmp = tmp->rightChild;
+		}else{
+			tmp = tmp->leftChild;
+		}
 	}
-	iterator it(tmp ? tmp : prev);
-	if(it.current && (it.current->data.first==key || this->cmp(it.current->data.first, key))){ ++it; }
-	return it;
+	return result;
 }
-template <class Key, class T, class Compare, class Allocator> template <class K> TreeAVL<Key,T,Compare,Allocator>::const_iterator TreeAVL<Key,T,Compare,Allocator>::upper_bound(const K& key) const{
-    NodeAVL *tmp = this->root, *prev = 0;
-	while(tmp && tmp->data.first!=key){
-		prev = tmp;
-		tmp = (this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild);
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::ptrdiff_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::distance(const_iterator first, const_iterator last) const requires Ranked{
+	return (std::ptrdiff_t) this->index_of(last.current) - (std::ptrdiff_t) this->index_of(first.current);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::ptrdiff_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::distance(iterator first, iterator last) const requires Ranked{
+	return (std::ptrdiff_t) this->index_of(last.current) - (std::ptrdiff_t) this->index_of(first.current);
+}
+
+// Aggregates
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::aggregate_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::aggregate() const requires augmented{
+	return aggregate_of(this->root);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::aggregate_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::range_query(const K& first, const K& last) const requires augmented{
+	// Descends to the highest node inside the range, then gathers the part of its left subtree not less than first and the part of its right subtree less than last
+	lookup_key<K> a = first, b = last;
+	const NodeAVL *node = this->root, *ptr;
+	aggregate_type left = Monoid::identity(), right = Monoid::identity();
+	while(node && (this->cmp(node->data.first, a) || !this->cmp(node->data.first, b))){
+		node = this->cmp(node->data.first, a) ? node->rightChild : node->leftChild;
 	}
-	const_iterator it(tmp ? tmp : prev);
-	if(it.current && (it.current->data.first==key || this->cmp(it.current->data.first, key))){ ++it; }
-	return it;
+	if(!node){ return left; }
+	for(ptr = node->leftChild; ptr;){
+		if(this->cmp(ptr->data.first, a)){
+			ptr = ptr->rightChild;
+		}else{
+			left = Monoid::combine(Monoid::combine(Monoid::lift(ptr->data), aggregate_of(ptr->rightChild)), left);
+			ptr = ptr->leftChild;
+		}
+	}
+	for(ptr = node->rightChild; ptr;){
+		if(this->cmp(ptr->data.first, b)){
+			right = Monoid::combine(right, Monoid::combine(aggregate_of(ptr->leftChild), Monoid::lift(ptr->data)));
+			ptr = ptr->rightChild;
+		}else{
+			ptr = ptr->leftChild;
+		}
+	}
+	return Monoid::combine(Monoid::combine(left, Monoid::lift(node->data)), right);
 }
-template <class Key, class T, class Compare, class Allocator> template <class K> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::iterator, typename TreeAVL<Key,T,Compare,Allocator>::iterator> TreeAVL<Key,T,Compare,Allocator>::equal_range(const K& key){
-	return std::pair<iterator,iterator>(this->lower_bound(key), this->upper_bound(key));
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K, class Pred, class Function> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::for_each_where(const K& last, Pred pred, Function f) const requires augmented{
+	lookup_key<K> k = last;
+	this->visit_where(this->root, k, pred, f);
 }
-template <class Key, class T, class Compare, class Allocator> template <class K> std::pair<typename TreeAVL<Key,T,Compare,Allocator>::const_iterator,typename TreeAVL<Key,T,Compare,Allocator>::const_iterator> TreeAVL<Key,T,Compare,Allocator>::equal_range(const K& key) const{
-    return std::pair<const_iterator,const_iterator>(this->lower_bound(key), this->upper_bound(key));
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::refresh(iterator pos) requires augmented{
+	recalculate_path(pos.current);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::refresh(const_iterator pos) requires augmented{
+	recalculate_path(pos.current);
+}
+
+// Parallel operations
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class Function> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::parallel_for_each(Function f, std::size_t threads){
+	for_each_nodes(this->root, threads, f);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class Function> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::parallel_for_each(Function f, std::size_t threads) const{
+	auto visit = [&f](const std::pair<const Key, T>& value){ f(value); };
+	for_each_nodes(this->root, threads, visit);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class R, class Reduce, class Transform> R TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::parallel_reduce(R init, Reduce reduce, Transform transform, std::size_t threads) const{
+	if(!this->root){ return init; }
+	return reduce(std::move(init), reduce_nodes<R>(this->root, threads, reduce, transform));
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class InputIt> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::assign_parallel(InputIt first, InputIt last, std::size_t threads){
+	// Stateful allocators are not assumed to be safe to use from several threads, so their nodes are allocated by this one
+	std::vector<std::pair<Key, T>> buffer(first, last);
+	this->sort_parallel(buffer.begin(), buffer.end(), threads);
+	buffer.erase(std::unique(buffer.begin(), buffer.end(), [this](const std::pair<Key, T>& lhs, const std::pair<Key, T>& rhs){ return !this->cmp(lhs.first, rhs.first); }), buffer.end());
+	this->clear();
+	this->root = this->build_parallel(buffer.begin(), buffer.size(), 0, std::allocator_traits<AllocatorNodes>::is_always_equal::value ? threads : 1);
+	this->counter = buffer.size();
 }
 
 // Non-member functions
 // Operators
-template <class A, class B, class C, class D> bool operator==(const TreeAVL<A,B,C,D>& lhs, const TreeAVL<A,B,C,D>& rhs){
+template <class A, class B, class C, class D, bool E, class F, bool G> bool operator==(const TreeAVL<A,B,C,D,E,F,G>& lhs, const TreeAVL<A,B,C,D,E,F,G>& rhs){
 	bool result;
 	if(result = (lhs.size() == rhs.size())){
 		auto it = lhs.begin(), ito = rhs.begin(), ite = lhs.end();
@@ -503,7 +797,7 @@ template <class A, class B, class C, class D> bool operator==(const TreeAVL<A,B,
 	}
 	return result;
 }
-template <class A, class B, class C, class D> std::strong_ordering operator<=>(const TreeAVL<A,B,C,D>& lhs, const TreeAVL<A,B,C,D>& rhs){
+template <class A, class B, class C, class D, bool E, class F, bool G> std::strong_ordering operator<=>(const TreeAVL<A,B,C,D,E,F,G>& lhs, const TreeAVL<A,B,C,D,E,F,G>& rhs){
 	auto it = lhs.begin(), ito = rhs.begin(), ite = lhs.end(), itoe = rhs.end();
 	while(it != ite && ito != itoe){
 		if((*it) != (*ito)){ break; }
@@ -516,35 +810,103 @@ template <class A, class B, class C, class D> std::strong_ordering operator<=>(c
 	return std::strong_ordering::less;
 }
 
+// Node handle
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::node_type() noexcept :
+	node(0){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::node_type(NodeAVL* node, const AllocatorNodes& alloc) :
+	node(node),
+	alloc(alloc){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::node_type(node_type&& other) noexcept :
+	node(other.node),
+	alloc(std::move(other.alloc)){
+	other.node = 0;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::operator=(node_type&& other){
+	if(this != &other){
+		if(this->node){ NodeAVL::destroy(this->alloc, this->node); }
+		this->node = other.node;
+		this->alloc = std::move(other.alloc);
+		other.node = 0;
+	}
+	return *this;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::~node_type(){
+	if(this->node){ NodeAVL::destroy(this->alloc, this->node); }
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> bool TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::empty() const noexcept{
+	return !this->node;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::operator bool() const noexcept{
+	return this->node;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> Allocator TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::get_allocator() const{
+	return Allocator(this->alloc);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> Key& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::key() const{
+	return *((Key*) &this->node->data.first);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> T& TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::mapped() const{
+	return this->node->data.second;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::node_type::swap(node_type& other) noexcept{
+	std::swap(this->node, other.node);
+	std::swap(this->alloc, other.alloc);
+}
+
 // Nested class NodeAVL
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL::NodeAVL(NodeAVL* parent) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::NodeAVL(NodeAVL* parent) :
 	parent(parent),
 	leftChild(0),
 	rightChild(0),
-	height(0){ }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL::NodeAVL(const Key& key, NodeAVL* parent) :
+	height(1){
+	if constexpr(Ranked){ this->count = 1; }
+	if constexpr(augmented){ this->aggregate = Monoid::lift(this->data); }
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::NodeAVL(const Key& key, NodeAVL* parent) :
 	parent(parent),
 	leftChild(0),
 	rightChild(0),
-	height(0){
+	height(1){
+	if constexpr(Ranked){ this->count = 1; }
 	*((Key*) &this->data.first) = key;
+	if constexpr(augmented){ this->aggregate = Monoid::lift(this->data); }
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL::NodeAVL(Key&& key, NodeAVL* parent) :
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::NodeAVL(Key&& key, NodeAVL* parent) :
 	parent(parent),
 	leftChild(0),
 	rightChild(0),
-	height(0){
+	height(1){
+	if constexpr(Ranked){ this->count = 1; }
 	*((Key*) &this->data.first) = std::move(key);
+	if constexpr(augmented){ this->aggregate = Monoid::lift(this->data); }
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL::~NodeAVL(){}
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::NodeAVL::recalculate_height(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::~NodeAVL(){}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::recalculate_height(){
 	std::size_t lz = (this->leftChild ? this->leftChild->height : 0), rz = (this->rightChild ? this->rightChild->height : 0);
 	this->height = (lz>rz ? lz : rz) + 1;
 }
-template <class Key, class T, class Compare, class Allocator> int TreeAVL<Key,T,Compare,Allocator>::NodeAVL::left_heavy(){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::recalculate_rank(){
+	// The shape flags written by Serialize are still kept in height, 0x4 and 0x8 tell whether the left and right children are two ranks below
+	std::size_t shape = this->height;
+	if(this->leftChild){
+		this->height = this->leftChild->height + ((shape & 0x4) ? 2 : 1);
+	}else if(this->rightChild){
+		this->height = this->rightChild->height + ((shape & 0x8) ? 2 : 1);
+	}else{
+		this->height = 1;
+	}
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::recalculate_summary(){
+	if constexpr(Ranked){ this->count = count_of(this->leftChild) + count_of(this->rightChild) + 1; }
+	if constexpr(augmented){ this->aggregate = Monoid::combine(Monoid::combine(aggregate_of(this->leftChild), Monoid::lift(this->data)), aggregate_of(this->rightChild)); }
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> int TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::left_heavy(){
 	return (this->leftChild ? this->leftChild->height : 0) > (this->rightChild ? this->rightChild->height : 0);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::NodeAVL::copy(AllocatorNodes& alloc, NodeAVL* src, NodeAVL* dst){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> int TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::right_heavy(){
+	return (this->rightChild ? this->rightChild->height : 0) > (this->leftChild ? this->leftChild->height : 0);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::copy(AllocatorNodes& alloc, NodeAVL* src, NodeAVL* dst){
 	NodeAVL* result = dst, *ptr;
 	if(!result){
 		result = alloc.allocate(1);
@@ -553,6 +915,8 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 	ptr = result;
 	*((std::pair<Key,T>*)&ptr->data) = src->data;
 	ptr->height = src->height;
+	ptr->count = src->count;
+	ptr->aggregate = src->aggregate;
 	goto nodeavl_copy_get_leftmost_child_loop;
 	while(ptr){
 		if(!src->leftChild && ptr->leftChild){ ptr->leftChild = NodeAVL::destroy(alloc, ptr->leftChild); }
@@ -565,6 +929,8 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 			ptr = ptr->rightChild;
 			*((std::pair<Key,T>*)&ptr->data) = src->data;
 			ptr->height = src->height;
+			ptr->count = src->count;
+			ptr->aggregate = src->aggregate;
 			nodeavl_copy_get_leftmost_child_loop:
 			while(src->leftChild){
 				if(!ptr->leftChild){
@@ -575,6 +941,8 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 				ptr = ptr->leftChild;
 				*((std::pair<Key,T>*)&ptr->data) = src->data;
 				ptr->height = src->height;
+				ptr->count = src->count;
+				ptr->aggregate = src->aggregate;
 			};
 		}else{
 			if(ptr->rightChild){ ptr->rightChild = NodeAVL::destroy(alloc, ptr->rightChild); }
@@ -588,7 +956,7 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 	}
 	return result;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::NodeAVL::destroy(AllocatorNodes& alloc, NodeAVL* node){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL::destroy(AllocatorNodes& alloc, NodeAVL* node){
 	NodeAVL* ptr = node;
 	ptr->parent = 0;
 	while(ptr->leftChild){ ptr = ptr->leftChild; }
@@ -615,54 +983,83 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 }
 
 // Private members
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::get_forward(const Key& key){
-	NodeAVL *tmp = this->root, *parent;
-	if(tmp){
-		while(tmp && tmp->data.first!=key){
-			parent = tmp;
-			tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild;
-		}
-		if(!tmp){
-			tmp = this->alloc.allocate(1);
-			std::construct_at(tmp, key, parent);
-			*(this->cmp(key, parent->data.first) ? &(parent->leftChild) : &(parent->rightChild)) = tmp;
-			this->rebalance(parent);
-			this->counter++;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::find_node(const K& key) const{
+	// Single comparison per level, the equivalence is only checked on the last candidate
+	NodeAVL* tmp = this->lower_node(key);
+	return tmp && !this->cmp(key, tmp->data.first) ? tmp : 0;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::lower_node(const K& key) const{
+	NodeAVL *tmp = this->root, *result = 0;
+	while(tmp){
+		if(this->cmp(tmp->data.first, key)){
+			tmp = tmp->rightChild;
+		}else{
+			result = tmp;
+			tmp = tmp->leftChild;
 		}
-	}else{
-		tmp = this->alloc.allocate(1);
-		std::construct_at(tmp, key);
-		this->root = tmp;
-		this->counter++;
 	}
-	return tmp;
+	return result;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::get_forward(Key&& key){
-	NodeAVL *tmp = this->root, *parent;
-	if(tmp){
-		while(tmp && tmp->data.first!=key){
-			parent = tmp;
-			tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::upper_node(const K& key) const{
+	NodeAVL *tmp = this->root, *result = 0;
+	while(tmp){
+		if(this->cmp(key, tmp->data.first)){
+			result = tmp;
+			tmp = tmp->leftChild;
+		}else{
+			tmp = tmp->rightChild;
 		}
-		if(!tmp){
-			tmp = this->alloc.allocate(1);
-			std::construct_at(tmp, key, parent);
-			*(this->cmp(key, parent->data.first) ? &(parent->leftChild) : &(parent->rightChild)) = tmp;
-			this->rebalance(parent);
-			this->counter++;
+	}
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class ForwardIt, class Visit> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::lookup_many(ForwardIt first, ForwardIt last, Visit visit) const{
+	// Advances a group of descents one level at a time, prefetching the next node of each one while the others are compared
+	using K = typename std::iterator_traits<ForwardIt>::value_type;
+	const K* keys[lookup_group];
+	NodeAVL *nodes[lookup_group], *found[lookup_group], *tmp;
+	std::size_t n, active, i;
+	if constexpr(!std::is_reference_v<lookup_key<K>>){
+		// Keys converted to Key are looked up one at a time, the conversion outweighs the cache misses
+		for(; first != last; ++first){
+			lookup_key<K> key = *first;
+			visit(this->find_node(key));
 		}
 	}else{
-		tmp = this->alloc.allocate(1);
-		std::construct_at(tmp, key);
-		this->root = tmp;
-		this->counter++;
+		while(first != last){
+			for(n = 0; n < lookup_group && first != last; ++n, ++first){
+				keys[n] = &*first;
+				nodes[n] = this->root;
+				found[n] = 0;
+			}
+			do{
+				active = 0;
+				for(i = 0; i < n; ++i){
+					if((tmp = nodes[i])){
+						if(this->cmp(tmp->data.first, *keys[i])){
+							tmp = tmp->rightChild;
+						}else{
+							found[i] = tmp;
+							tmp = tmp->leftChild;
+						}
+						if((nodes[i] = tmp)){
+							prefetch(tmp);
+							++active;
+						}
+					}
+				}
+			}while(active);
+			for(i = 0; i < n; ++i){ visit(found[i] && !this->cmp(*keys[i], found[i]->data.first) ? found[i] : 0); }
+		}
 	}
-	return tmp;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::get_forward(const Key& key, NodeAVL* hint){
-	NodeAVL *tmp = hint ? hint : this->root, *parent;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::prefetch(const NodeAVL* node){
+	#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(node);
+	#endif
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::get_forward(const Key& key){
+	NodeAVL *tmp = this->root, *parent;
 	if(tmp){
-		while(tmp->parent && ((tmp->parent->leftChild==tmp) ^ this->cmp(key, tmp->parent->data.first))){ tmp = tmp->parent; }
 		while(tmp && tmp->data.first!=key){
 			parent = tmp;
 			tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild;
@@ -671,21 +1068,21 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 			tmp = this->alloc.allocate(1);
 			std::construct_at(tmp, key, parent);
 			*(this->cmp(key, parent->data.first) ? &(parent->leftChild) : &(parent->rightChild)) = tmp;
+			if(parent == this->rightmost && parent->rightChild == tmp){ this->rightmost = tmp; }
 			this->rebalance(parent);
 			this->counter++;
 		}
 	}else{
 		tmp = this->alloc.allocate(1);
 		std::construct_at(tmp, key);
-		this->root = tmp;
+		this->root = this->rightmost = tmp;
 		this->counter++;
 	}
 	return tmp;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::get_forward(Key&& key, NodeAVL* hint){
-	NodeAVL *tmp = hint ? hint : this->root, *parent;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::get_forward(Key&& key){
+	NodeAVL *tmp = this->root, *parent;
 	if(tmp){
-		while(tmp->parent && ((tmp->parent->leftChild==tmp) ^ this->cmp(key, tmp->parent->key))){ tmp = tmp->parent; }
 		while(tmp && tmp->data.first!=key){
 			parent = tmp;
 			tmp = this->cmp(key, tmp->data.first) ? tmp->leftChild : tmp->rightChild;
@@ -694,18 +1091,35 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 			tmp = this->alloc.allocate(1);
 			std::construct_at(tmp, key, parent);
 			*(this->cmp(key, parent->data.first) ? &(parent->leftChild) : &(parent->rightChild)) = tmp;
+			if(parent == this->rightmost && parent->rightChild == tmp){ this->rightmost = tmp; }
 			this->rebalance(parent);
 			this->counter++;
 		}
 	}else{
 		tmp = this->alloc.allocate(1);
 		std::construct_at(tmp, key);
-		this->root = tmp;
+		this->root = this->rightmost = tmp;
 		this->counter++;
 	}
 	return tmp;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::remove_node(TreeAVL<Key,T,Compare,Allocator>::NodeAVL* src){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::get_forward(const Key& key, NodeAVL* hint){
+	NodeAVL *parent, **link = this->hint_link(key, hint, parent);
+	if(!link){ return parent; }
+	NodeAVL* tmp = this->alloc.allocate(1);
+	std::construct_at(tmp, key);
+	this->link_node(tmp, parent, link);
+	return tmp;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::get_forward(Key&& key, NodeAVL* hint){
+	NodeAVL *parent, **link = this->hint_link(key, hint, parent);
+	if(!link){ return parent; }
+	NodeAVL* tmp = this->alloc.allocate(1);
+	std::construct_at(tmp, std::move(key));
+	this->link_node(tmp, parent, link);
+	return tmp;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::remove_node(TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* src){
 	NodeAVL *tmp = src, *result = src;
 	bool leftChild;
 	if(src){
@@ -731,60 +1145,644 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 				this->root = 0;
 			}
 		}
-		if(tmp->parent){ this->rebalance(tmp->parent); }
+		// The last node can only be destroyed if it was src itself (its predecessor is then its parent) or the successor of src, whose element src takes
+		if(tmp == this->rightmost){ this->rightmost = (tmp == src) ? tmp->parent : src; }
+		if(tmp->parent){ this->rebalance_erase(tmp->parent); }
 		NodeAVL::destroy(this->alloc,tmp);
 	}
 	return result;
 }
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::rebalance(NodeAVL *source){
-	do{
-		std::size_t lz = (source->leftChild ? source->leftChild->height : 0), rz = (source->rightChild ? source->rightChild->height : 0);
-		std::size_t diff = lz>rz ? lz-rz : rz-lz;
-		if(diff < 2){
-			source->height = (lz>rz ? lz : rz) + 1;
-			source = source->parent;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL** TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::search_link(const K& key, NodeAVL*& parent){
+	// Returns the empty link where key belongs and its parent, or null and the node with an equivalent key
+	NodeAVL** link = &this->root;
+	parent = 0;
+	while(*link){
+		if(this->cmp(key, (*link)->data.first)){
+			parent = *link;
+			link = &parent->leftChild;
+		}else if(this->cmp((*link)->data.first, key)){
+			parent = *link;
+			link = &parent->rightChild;
+		}else{
+			parent = *link;
+			return 0;
+		}
+	}
+	return link;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL** TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::hint_link(const K& key, NodeAVL* hint, NodeAVL*& parent){
+	// Only the neighbours of the gap right before hint (after the last element if hint is end()) or right after it are compared, otherwise key is searched from the root
+	NodeAVL* neighbour;
+	if(!hint){
+		if(!(parent = this->root)){ return &this->root; }
+		if(!this->rightmost){
+			for(this->rightmost = this->root; this->rightmost->rightChild; this->rightmost = this->rightmost->rightChild);
+		}
+		parent = this->rightmost;
+		if(this->cmp(parent->data.first, key)){ return &parent->rightChild; }
+	}else if(this->cmp(key, hint->data.first)){
+		if(!(neighbour = hint->leftChild)){
+			for(neighbour = hint; neighbour->parent && neighbour->parent->leftChild == neighbour; neighbour = neighbour->parent);
+			neighbour = neighbour->parent;
+			if(!neighbour || this->cmp(neighbour->data.first, key)){
+				parent = hint;
+				return &hint->leftChild;
+			}
+		}else{
+			while(neighbour->rightChild){ neighbour = neighbour->rightChild; }
+			if(this->cmp(neighbour->data.first, key)){
+				parent = neighbour;
+				return &neighbour->rightChild;
+			}
+		}
+	}else if(this->cmp(hint->data.first, key)){
+		if(!(neighbour = hint->rightChild)){
+			for(neighbour = hint; neighbour->parent && neighbour->parent->rightChild == neighbour; neighbour = neighbour->parent);
+			neighbour = neighbour->parent;
+			if(!neighbour || this->cmp(key, neighbour->data.first)){
+				parent = hint;
+				return &hint->rightChild;
+			}
 		}else{
-			bool isLeftChild = source->parent && (source == source->parent->leftChild);
-			NodeAVL* result = (lz>rz) ? (source->leftChild->left_heavy() ? rotation_LL(source) : rotation_LR(source)) : ((source->rightChild->left_heavy()) ? rotation_RL(source) : rotation_RR(source));
-			if(result->parent){
-				*(isLeftChild ? &(result->parent->leftChild) : &(result->parent->rightChild)) = result;
+			while(neighbour->leftChild){ neighbour = neighbour->leftChild; }
+			if(this->cmp(key, neighbour->data.first)){
+				parent = neighbour;
+				return &neighbour->leftChild;
+			}
+		}
+	}else{
+		parent = hint;
+		return 0;
+	}
+	return this->search_link(key, parent);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::link_node(NodeAVL* node, NodeAVL* parent, NodeAVL** link){
+	// The mapped value of a node handle may have changed since it was extracted
+	if constexpr(augmented){ node->recalculate_summary(); }
+	node->parent = parent;
+	*link = node;
+	if(!parent || (parent == this->rightmost && link == &parent->rightChild)){ this->rightmost = node; }
+	if(parent){ this->rebalance(parent); }
+	this->counter++;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::unlink_node(NodeAVL* src){
+	// Unlike remove_node() the successor node takes the place of src, so no element is moved and no other node changes its element
+	NodeAVL *replacement, *from;
+	// The last node has no right child, so its predecessor is its left child (which is a leaf) or its parent
+	if(src == this->rightmost){ this->rightmost = src->leftChild ? src->leftChild : src->parent; }
+	if(src->leftChild && src->rightChild){
+		replacement = src->rightChild;
+		while(replacement->leftChild){ replacement = replacement->leftChild; }
+		from = replacement;
+		if(replacement != src->rightChild){
+			from = replacement->parent;
+			from->leftChild = replacement->rightChild;
+			if(replacement->rightChild){ replacement->rightChild->parent = from; }
+			replacement->rightChild = src->rightChild;
+			src->rightChild->parent = replacement;
+		}
+		replacement->leftChild = src->leftChild;
+		src->leftChild->parent = replacement;
+		replacement->height = src->height;
+	}else{
+		replacement = src->leftChild ? src->leftChild : src->rightChild;
+		from = src->parent;
+	}
+	if(replacement){ replacement->parent = src->parent; }
+	if(src->parent){
+		*((src->parent->leftChild == src) ? &(src->parent->leftChild) : &(src->parent->rightChild)) = replacement;
+	}else{
+		this->root = replacement;
+	}
+	if(from){ this->rebalance_erase(from); }
+	this->counter--;
+	src->parent = src->leftChild = src->rightChild = 0;
+	src->height = 1;
+	src->recalculate_summary();
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::take_node(NodeAVL* node, AllocatorNodes& owner){
+	// Nodes of an allocator that compares unequal are reallocated, moving their element
+	if(this->alloc == owner){ return node; }
+	NodeAVL* tmp = this->alloc.allocate(1);
+	std::construct_at(tmp, std::move(*((Key*) &node->data.first)));
+	tmp->data.second = std::move(node->data.second);
+	NodeAVL::destroy(owner, node);
+	return tmp;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase_nodes(NodeAVL* first, NodeAVL* last){
+	// Short ranges are unlinked one node at a time, longer ones are cut out with two splits and the remaining parts are joined again
+	NodeAVL *left, *middle, *right;
+	iterator_actions it(first);
+	std::size_t n = 0;
+	while(it.current != last && n < erase_run){
+		it.next_element();
+		++n;
+	}
+	if(it.current == last){
+		while(first != last){
+			it.current = first;
+			it.next_element();
+			this->unlink_node(first);
+			NodeAVL::destroy(this->alloc, first);
+			first = it.current;
+		}
+		return last;
+	}
+	while(it.current != last){
+		it.next_element();
+		++n;
+	}
+	this->split_nodes(this->root, first->data.first, left, middle);
+	right = 0;
+	if(last){ this->split_nodes(middle, last->data.first, middle, right); }
+	this->root = last ? join_nodes(left, last, right) : left;
+	this->rightmost = 0;
+	this->counter -= n;
+	NodeAVL::destroy(this->alloc, first);
+	if(middle){ NodeAVL::destroy(this->alloc, middle); }
+	return last;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class Pred> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::erase_nodes_if(Pred& pred){
+	// Matches are unlinked one by one while they are rare, once they reach an eighth of the visited elements the rest of the tree is filtered and rebuilt in a single pass
+	iterator_actions it(this->root);
+	NodeAVL* node = this->root;
+	std::size_t original = this->counter, visited = 0, removed = 0;
+	if(node){
+		while(node->leftChild){ node = node->leftChild; }
+	}
+	while(node){
+		it.current = node;
+		it.next_element();
+		++visited;
+		if(pred(node->data)){
+			this->unlink_node(node);
+			NodeAVL::destroy(this->alloc, node);
+			if(++removed >= erase_run && removed*8 >= visited && it.current){
+				this->filter_nodes(it.current, pred);
+				break;
+			}
+		}
+		node = it.current;
+	}
+	return original - this->counter;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class Pred> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::filter_nodes(NodeAVL* first, Pred& pred){
+	// The elements from first on are split off, filtered while flattening them and rebuilt balanced; if pred throws, the elements not visited yet are kept
+	NodeAVL *left, *right, *node, *head, **tail = &head;
+	std::size_t kept = 0;
+	node = this->split_nodes(this->root, first->data.first, left, right);
+	node = join_nodes(0, node, right);
+	try{
+		this->flatten_nodes(node, tail, kept, pred);
+	}catch(...){
+		auto keep = [](const std::pair<const Key, T>&){ return false; };
+		this->flatten_nodes(node, tail, kept, keep);
+		*tail = 0;
+		this->root = join_nodes(left, relink_subtree(head, kept, 0));
+		this->rightmost = 0;
+		throw;
+	}
+	*tail = 0;
+	this->root = join_nodes(left, relink_subtree(head, kept, 0));
+	this->rightmost = 0;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class Pred> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::flatten_nodes(NodeAVL*& node, NodeAVL**& tail, std::size_t& kept, Pred& pred){
+	// Right rotations turn the tree into a list sorted by key, each node is taken once it has no left child
+	NodeAVL *left, *next;
+	while(node){
+		if((left = node->leftChild)){
+			node->leftChild = left->rightChild;
+			left->rightChild = node;
+			node = left;
+		}else if(pred(node->data)){
+			next = node->rightChild;
+			node->rightChild = 0;
+			NodeAVL::destroy(this->alloc, node);
+			node = next;
+			this->counter--;
+		}else{
+			*tail = node;
+			tail = &node->rightChild;
+			node = node->rightChild;
+			++kept;
+		}
+	}
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::relink_subtree(NodeAVL*& head, std::size_t n, NodeAVL* parent){
+	// Like build_subtree() but relinks the nodes of a list linked through their right children
+	if(!n){ return 0; }
+	NodeAVL *left = relink_subtree(head, n>>1, 0), *node = head;
+	head = head->rightChild;
+	node->parent = parent;
+	node->leftChild = left;
+	if(left){ left->parent = node; }
+	node->rightChild = relink_subtree(head, n - (n>>1) - 1, node);
+	node->recalculate_height();
+	node->recalculate_summary();
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::destroy_nodes(){
+	// Arena allocators release all their chunks at once if this tree owns every node allocated on them
+	if constexpr(requires(AllocatorNodes& a, std::size_t n){ { a.release(n) } -> std::same_as<bool>; }){
+		if(std::is_trivially_destructible_v<std::pair<const Key,T>> && this->alloc.release(this->counter)){ return; }
+	}
+	NodeAVL::destroy(this->alloc,this->root);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class InputIt> bool TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::build_sorted(InputIt first, InputIt last){
+	if constexpr(std::forward_iterator<InputIt>){
+		InputIt it = first, prev = first;
+		std::size_t n = 0;
+		if(it != last){
+			for(++it, n = 1; it != last; prev = it, ++it, ++n){
+				if(!this->cmp(prev->first, it->first)){ return false; }
+			}
+		}
+		this->root = this->build_subtree(first, n, 0);
+		this->counter = n;
+		return true;
+	}
+	return false;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class InputIt> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::build_subtree(InputIt& it, std::size_t n, NodeAVL* parent){
+	// Builds the left half first so the elements are consumed in order, the node is constructed once its key is reached
+	if(!n){ return 0; }
+	NodeAVL* node = this->alloc.allocate(1);
+	NodeAVL* left = this->build_subtree(it, n>>1, node);
+	std::construct_at(node, it->first, parent);
+	node->data.second = it->second;
+	++it;
+	node->leftChild = left;
+	node->rightChild = this->build_subtree(it, n - (n>>1) - 1, node);
+	node->recalculate_height();
+	node->recalculate_summary();
+	return node;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::index_of(NodeAVL* node) const requires Ranked{
+	if(!node){ return this->counter; }
+	std::size_t result = count_of(node->leftChild);
+	while(node->parent){
+		if(node == node->parent->rightChild){ result += count_of(node->parent->leftChild) + 1; }
+		node = node->parent;
+	}
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::count_of(NodeAVL* node){
+	if constexpr(Ranked){ return node ? node->count : 0; }
+	return 0;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> typename TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::aggregate_type TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::aggregate_of(const NodeAVL* node) requires augmented{
+	return node ? node->aggregate : Monoid::identity();
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class V> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::assign_mapped(NodeAVL* node, V&& value){
+	node->data.second = std::forward<V>(value);
+	if constexpr(augmented){ recalculate_path(node); }
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::recalculate_path(NodeAVL* node){
+	for(; node; node = node->parent){ node->recalculate_summary(); }
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K, class Pred, class Function> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::visit_where(const NodeAVL* node, const K& last, Pred& pred, Function& f) const{
+	// The elements of the right subtree are not less than the key of the node, so it is skipped along with it
+	if(!node || !pred(node->aggregate)){ return; }
+	this->visit_where(node->leftChild, last, pred, f);
+	if(!this->cmp(node->data.first, last)){ return; }
+	if(pred(Monoid::lift(node->data))){ f(node->data); }
+	this->visit_where(node->rightChild, last, pred, f);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rebalance(NodeAVL *source){
+	// A single node was linked or unlinked below source, so the ancestors of the first subtree that keeps its height only need their counts and aggregates updated
+	NodeAVL* top;
+	std::size_t height;
+	do{
+		height = source->height;
+		top = rebalance_node(source);
+		source = top->parent;
+	}while(source && top->height != height);
+	if(!source){ this->root = top; }
+	if constexpr(Ranked || augmented){ recalculate_path(source); }
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rebalance_erase(NodeAVL *source){
+	// A single node was unlinked below source. In a relaxed tree only a child three ranks below its parent (or a leaf of rank 2) is fixed: the parent is demoted along with its sibling if needed and the walk goes on, or a rotation restores the rank of the subtree and ends it
+	if constexpr(!Relaxed){
+		this->rebalance(source);
+	}else{
+		NodeAVL *sibling, *outer, *top;
+		std::size_t rank, lz, rz;
+		bool isLeftChild;
+		for(; source; source = source->parent){
+			source->recalculate_summary();
+			rank = source->height;
+			if(!source->leftChild && !source->rightChild){
+				if(rank == 1){ break; }
+				source->height = 1;
+				continue;
+			}
+			lz = height_of(source->leftChild);
+			rz = height_of(source->rightChild);
+			if(rank - (lz<rz ? lz : rz) < 3){ break; }
+			sibling = lz<rz ? source->rightChild : source->leftChild;
+			if(rank - sibling->height == 2){
+				source->height--;
+				continue;
+			}
+			if(sibling->height - height_of(sibling->leftChild) == 2 && sibling->height - height_of(sibling->rightChild) == 2){
+				source->height--;
+				sibling->height--;
+				continue;
+			}
+			isLeftChild = source->parent && (source == source->parent->leftChild);
+			outer = lz<rz ? sibling->rightChild : sibling->leftChild;
+			if(sibling->height - height_of(outer) == 1){
+				top = lz<rz ? rotation_RR(source) : rotation_LL(source);
+				source->height = (source->leftChild || source->rightChild) ? rank-1 : 1;
 			}else{
-				this->root = result;
+				top = lz<rz ? rotation_RL(source) : rotation_LR(source);
+				source->height = sibling->height = rank-2;
 			}
-			source = result->parent;
+			top->height = rank;
+			if(top->parent){
+				*(isLeftChild ? &(top->parent->leftChild) : &(top->parent->rightChild)) = top;
+			}else{
+				this->root = top;
+			}
+			source = top;
+			break;
 		}
+		if constexpr(Ranked || augmented){ if(source){ recalculate_path(source->parent); } }
+	}
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rebalance_subtree(NodeAVL *source){
+	NodeAVL* top;
+	do{
+		top = rebalance_node(source);
+		source = top->parent;
 	}while(source);
+	return top;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rebalance_node(NodeAVL *source){
+	std::size_t lz = (source->leftChild ? source->leftChild->height : 0), rz = (source->rightChild ? source->rightChild->height : 0);
+	std::size_t diff = lz>rz ? lz-rz : rz-lz;
+	if(diff < 2){
+		source->height = (lz>rz ? lz : rz) + 1;
+		source->recalculate_summary();
+		return source;
+	}
+	bool isLeftChild = source->parent && (source == source->parent->leftChild);
+	NodeAVL* result = (lz>rz) ? (source->leftChild->right_heavy() ? rotation_LR(source) : rotation_LL(source)) : ((source->rightChild->left_heavy()) ? rotation_RL(source) : rotation_RR(source));
+	if(result->parent){
+		*(isLeftChild ? &(result->parent->leftChild) : &(result->parent->rightChild)) = result;
+	}
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::height_of(NodeAVL* node){
+	return node ? node->height : 0;
+}
+// Join and split
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::join_nodes(NodeAVL* left, NodeAVL* node, NodeAVL* right){
+	// The taller tree is descended along its inner spine until a subtree of similar height is found, node replaces it and the path is rebalanced
+	std::size_t hl = height_of(left), hr = height_of(right);
+	NodeAVL *ptr, *parent = 0;
+	if(hl > hr+1){
+		ptr = left;
+		while(ptr && ptr->height > hr+1){
+			parent = ptr;
+			ptr = ptr->rightChild;
+		}
+		left = ptr;
+		parent->rightChild = node;
+	}else if(hr > hl+1){
+		ptr = right;
+		while(ptr && ptr->height > hl+1){
+			parent = ptr;
+			ptr = ptr->leftChild;
+		}
+		right = ptr;
+		parent->leftChild = node;
+	}
+	node->parent = parent;
+	node->leftChild = left;
+	node->rightChild = right;
+	if(left){ left->parent = node; }
+	if(right){ right->parent = node; }
+	node->recalculate_height();
+	node->recalculate_summary();
+	return parent ? rebalance_subtree(parent) : node;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::join_nodes(NodeAVL* left, NodeAVL* right){
+	NodeAVL* node = right;
+	if(!left || !right){ return left ? left : right; }
+	while(node->leftChild){ node = node->leftChild; }
+	if(node->parent){
+		node->parent->leftChild = node->rightChild;
+		if(node->rightChild){ node->rightChild->parent = node->parent; }
+		right = rebalance_subtree(node->parent);
+	}else{
+		right = node->rightChild;
+		if(right){ right->parent = 0; }
+	}
+	node->rightChild = 0;
+	return join_nodes(left, node, right);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class K> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::split_nodes(NodeAVL* node, const K& key, NodeAVL*& left, NodeAVL*& right) const{
+	NodeAVL *lChild, *rChild, *found;
+	if(!node){
+		left = right = 0;
+		return 0;
+	}
+	lChild = node->leftChild;
+	rChild = node->rightChild;
+	if(lChild){ lChild->parent = 0; }
+	if(rChild){ rChild->parent = 0; }
+	node->parent = node->leftChild = node->rightChild = 0;
+	if(this->cmp(key, node->data.first)){
+		found = this->split_nodes(lChild, key, left, right);
+		right = join_nodes(right, node, rChild);
+	}else if(this->cmp(node->data.first, key)){
+		found = this->split_nodes(rChild, key, left, right);
+		left = join_nodes(lChild, node, left);
+	}else{
+		left = lChild;
+		right = rChild;
+		found = node;
+		found->recalculate_height();
+		found->recalculate_summary();
+	}
+	return found;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::union_nodes(NodeAVL* lhs, NodeAVL* rhs, std::size_t& repeated){
+	NodeAVL *lChild, *rChild, *left, *right, *found;
+	if(!lhs || !rhs){ return lhs ? lhs : rhs; }
+	lChild = lhs->leftChild;
+	rChild = lhs->rightChild;
+	if(lChild){ lChild->parent = 0; }
+	if(rChild){ rChild->parent = 0; }
+	lhs->leftChild = lhs->rightChild = 0;
+	if((found = this->split_nodes(rhs, lhs->data.first, left, right))){
+		NodeAVL::destroy(this->alloc, found);
+		++repeated;
+	}
+	left = this->union_nodes(lChild, left, repeated);
+	right = this->union_nodes(rChild, right, repeated);
+	return join_nodes(left, lhs, right);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::intersection_nodes(NodeAVL* lhs, const NodeAVL* rhs, std::size_t& kept){
+	NodeAVL *left, *right, *found;
+	if(!lhs){ return 0; }
+	if(!rhs){
+		NodeAVL::destroy(this->alloc, lhs);
+		return 0;
+	}
+	found = this->split_nodes(lhs, rhs->data.first, left, right);
+	left = this->intersection_nodes(left, rhs->leftChild, kept);
+	right = this->intersection_nodes(right, rhs->rightChild, kept);
+	if(found){
+		++kept;
+		return join_nodes(left, found, right);
+	}
+	return join_nodes(left, right);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::difference_nodes(NodeAVL* lhs, const NodeAVL* rhs, std::size_t& removed){
+	NodeAVL *left, *right, *found;
+	if(!lhs || !rhs){ return lhs; }
+	if((found = this->split_nodes(lhs, rhs->data.first, left, right))){
+		NodeAVL::destroy(this->alloc, found);
+		++removed;
+	}
+	left = this->difference_nodes(left, rhs->leftChild, removed);
+	right = this->difference_nodes(right, rhs->rightChild, removed);
+	return join_nodes(left, right);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::recount(NodeAVL* left, NodeAVL* right, std::size_t total) const{
+	// Both parts are walked at the same time until the smaller one is exhausted
+	if constexpr(Ranked){ return count_of(left); }
+	iterator_actions lit(left), rit(right);
+	std::size_t steps = 0;
+	while(lit.current && lit.current->leftChild){ lit.current = lit.current->leftChild; }
+	while(rit.current && rit.current->leftChild){ rit.current = rit.current->leftChild; }
+	while(lit.current && rit.current){
+		lit.next_element();
+		rit.next_element();
+		++steps;
+	}
+	return lit.current ? total - steps : steps;
+}
+// Parallel helpers
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class Left, class Right> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::fork_join(Left left, Right right){
+	// Runs right in a new thread and left in the current one, an exception thrown by either is rethrown once both have finished
+	std::exception_ptr error;
+	std::thread worker([&right, &error](){
+		try{
+			right();
+		}catch(...){
+			error = std::current_exception();
+		}
+	});
+	try{
+		left();
+	}catch(...){
+		worker.join();
+		throw;
+	}
+	worker.join();
+	if(error){ std::rethrow_exception(error); }
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class Function> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::for_each_nodes(NodeAVL* node, std::size_t threads, Function& f){
+	// The right subtree is handed to another thread while the subtree is tall enough, the rest stays in the current one
+	if(!node){ return; }
+	if(threads < 2 || node->height <= parallel_height){
+		for_each_nodes(node->leftChild, 1, f);
+		f(node->data);
+		for_each_nodes(node->rightChild, 1, f);
+		return;
+	}
+	fork_join([&](){
+		for_each_nodes(node->leftChild, threads - threads/2, f);
+		f(node->data);
+	}, [&](){
+		for_each_nodes(node->rightChild, threads/2, f);
+	});
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class R, class Reduce, class Transform> R TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::reduce_nodes(const NodeAVL* node, std::size_t threads, Reduce& reduce, Transform& transform){
+	// The results of both subtrees are combined with the one of the node in key order, so reduce only needs to be associative
+	std::optional<R> left, right;
+	if(threads < 2 || node->height <= parallel_height){
+		if(node->leftChild){ left.emplace(reduce_nodes<R>(node->leftChild, 1, reduce, transform)); }
+		if(node->rightChild){ right.emplace(reduce_nodes<R>(node->rightChild, 1, reduce, transform)); }
+	}else{
+		fork_join([&](){
+			if(node->leftChild){ left.emplace(reduce_nodes<R>(node->leftChild, threads - threads/2, reduce, transform)); }
+		}, [&](){
+			if(node->rightChild){ right.emplace(reduce_nodes<R>(node->rightChild, threads/2, reduce, transform)); }
+		});
+	}
+	R result = transform(node->data);
+	if(left){ result = reduce(std::move(*left), std::move(result)); }
+	if(right){ result = reduce(std::move(result), std::move(*right)); }
+	return result;
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class RandomIt> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::sort_parallel(RandomIt first, RandomIt last, std::size_t threads) const{
+	// Both halves are sorted by different threads and then merged by the current one
+	auto less = [this](const std::pair<Key, T>& lhs, const std::pair<Key, T>& rhs){ return this->cmp(lhs.first, rhs.first); };
+	RandomIt middle = first + (last - first)/2;
+	if(threads < 2 || (std::size_t)(last - first) <= parallel_grain){
+		std::sort(first, last, less);
+		return;
+	}
+	fork_join([&](){ this->sort_parallel(first, middle, threads - threads/2); }, [&](){ this->sort_parallel(middle, last, threads/2); });
+	std::inplace_merge(first, middle, last, less);
+}
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> template <class RandomIt> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::build_parallel(RandomIt first, std::size_t n, NodeAVL* parent, std::size_t threads){
+	// Like build_subtree() but both halves are built by different threads while they are large enough, and the elements are moved into the nodes
+	if(!n){ return 0; }
+	std::size_t half = n>>1;
+	NodeAVL *node = this->alloc.allocate(1), *left, *right;
+	if(threads < 2 || n <= parallel_grain){
+		left = this->build_parallel(first, half, node, 1);
+		right = this->build_parallel(first + half + 1, n - half - 1, node, 1);
+	}else{
+		fork_join([&](){ left = this->build_parallel(first, half, node, threads - threads/2); }, [&](){ right = this->build_parallel(first + half + 1, n - half - 1, node, threads/2); });
+	}
+	std::construct_at(node, std::move(first[half].first), parent);
+	node->data.second = std::move(first[half].second);
+	node->leftChild = left;
+	node->rightChild = right;
+	node->recalculate_height();
+	node->recalculate_summary();
+	return node;
 }
 // Tree rotations
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::rotation_LL(NodeAVL* source){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rotation_LL(NodeAVL* source){
 	NodeAVL* result = source->leftChild;
 	result->parent = source->parent;
 	source->leftChild = source->leftChild->rightChild;
 	if(source->leftChild){ source->leftChild->parent = source; }
 	source->recalculate_height();
+	source->recalculate_summary();
 	result->rightChild = source;
 	result->rightChild->parent = result;
 	result->recalculate_height();
+	result->recalculate_summary();
 	return result;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::rotation_RR(NodeAVL* source){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rotation_RR(NodeAVL* source){
 	NodeAVL* result = source->rightChild;
 	result->parent = source->parent;
 	source->rightChild = source->rightChild->leftChild;
 	if(source->rightChild){ source->rightChild->parent = source; }
 	source->recalculate_height();
+	source->recalculate_summary();
 	result->leftChild = source;
 	result->leftChild->parent = result;
 	result->recalculate_height();
+	result->recalculate_summary();
 	return result;
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::rotation_LR(NodeAVL* source){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rotation_LR(NodeAVL* source){
 	source->leftChild = rotation_RR(source->leftChild);
 	source->leftChild->parent = source;
 	source->recalculate_height();
 	return rotation_LL(source);
 }
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::NodeAVL* TreeAVL<Key,T,Compare,Allocator>::rotation_RL(NodeAVL* source){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::rotation_RL(NodeAVL* source){
 	source->rightChild = rotation_LL(source->rightChild);
 	source->rightChild->parent = source;
 	source->recalculate_height();
@@ -792,10 +1790,16 @@ template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Comp
 }
 
 // Iterator actions
-template <class Key, class T, class Compare, class Allocator> TreeAVL<Key,T,Compare,Allocator>::iterator_actions::iterator_actions(NodeAVL* init) : 
-	current(init){ }
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::iterator_actions::next_element(){
-	if(this->current){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions::iterator_actions(NodeAVL* init, const TreeAVL* tree) : 
+	current(init),
+	tree(tree){ }
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions::next_element(){
+	if(!this->current){
+		// Regressing a reverse iterator from rend() reaches the first element
+		if(this->tree && (this->current = this->tree->root)){
+			while(this->current->leftChild){ this->current = this->current->leftChild; }
+		}
+	}else{
 		if(this->current->rightChild){
 			this->current = this->current->rightChild;
 			while(this->current->leftChild){ this->current = this->current->leftChild; }
@@ -805,8 +1809,13 @@ template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T
 		}
 	}
 }
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::iterator_actions::previous_element(){
-	if(this->current){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions::previous_element(){
+	if(!this->current){
+		// Regressing from end() reaches the last element, which is cached unless bulk changes have reset it
+		if(this->tree && !(this->current = this->tree->rightmost) && (this->current = this->tree->root)){
+			while(this->current->rightChild){ this->current = this->current->rightChild; }
+		}
+	}else{
 		if(this->current->leftChild){
 			this->current = this->current->leftChild;
 			while(this->current->rightChild){ this->current = this->current->rightChild; }
@@ -816,17 +1825,18 @@ template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T
 		}
 	}
 }
-template <class Key, class T, class Compare, class Allocator> bool TreeAVL<Key,T,Compare,Allocator>::iterator_actions::operator==(const TreeAVL<Key,T,Compare,Allocator>::iterator_actions& other) const{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> bool TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions::operator==(const TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions& other) const{
 	return this->current == other.current;
 }
-template <class Key, class T, class Compare, class Allocator> bool TreeAVL<Key,T,Compare,Allocator>::iterator_actions::operator!=(const TreeAVL<Key,T,Compare,Allocator>::iterator_actions& other) const{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> bool TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions::operator!=(const TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions& other) const{
 	return this->current != other.current;
 }
-
-template <class Key, class T, class Compare, class Allocator> std::pair<const Key, T> TreeAVL<Key,T,Compare,Allocator>::iterator_actions::nullvalue;
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> bool TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::iterator_actions::operator==(std::default_sentinel_t) const{
+	return !this->current;
+}
 
 // Specialized copy/move calls
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::sp_copy(const TreeAVL& other, std::true_type){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::sp_copy(const TreeAVL& other, std::true_type){
 	NodeAVL* nroot;
 	if(this->alloc != other.alloc){
 		nroot = other.root ? NodeAVL::copy(other.alloc, other.root) : 0;
@@ -840,30 +1850,36 @@ template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T
 	this->cmp = other.cmp;
 	this->counter = other.counter;
 	this->root = nroot;
+	this->rightmost = 0;
 }
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::sp_copy(const TreeAVL& other, std::false_type){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::sp_copy(const TreeAVL& other, std::false_type){
 	NodeAVL* nroot = other.root ? NodeAVL::copy(this->alloc, other.root, this->root) : 0;
 	if(!nroot && this->root){ NodeAVL::destroy(this->alloc, this->root); }
 	this->cmp = other.cmp;
 	this->counter = other.counter;
 	this->root = nroot;
+	this->rightmost = 0;
 }
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::sp_move(TreeAVL&& other, std::true_type) noexcept{
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::sp_move(TreeAVL&& other, std::true_type) noexcept{
 	if(this->root && this->root!=other.root){ NodeAVL::destroy(this->alloc, this->root); }
 	this->alloc = std::move(other.alloc);
 	this->cmp = std::move(other.cmp);
 	this->root = other.root;
+	this->rightmost = other.rightmost;
 	this->counter = other.counter;
 	other.root = 0;
+	other.rightmost = 0;
 	other.counter = 0;
 }
-template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T,Compare,Allocator>::sp_move(TreeAVL&& other, std::false_type){
+template <class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> void TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::sp_move(TreeAVL&& other, std::false_type){
 	if(this->alloc == other.alloc){
 		if(this->root && this->root != other.root){ NodeAVL::destroy(this->alloc, this->root); }
 		this->cmp = std::move(other.cmp);
 		this->root = other.root;
+		this->rightmost = other.rightmost;
 		this->counter = other.counter;
 		other.root = 0;
+		other.rightmost = 0;
 		other.counter = 0;
 	}else{
 		NodeAVL* nroot = other.root ? NodeAVL::copy(this->alloc, other.root, this->root) : 0;
@@ -871,6 +1887,7 @@ template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T
 		this->cmp = other.cmp;
 		this->counter = other.counter;
 		this->root = nroot;
+		this->rightmost = 0;
 	}
 }
 
@@ -878,31 +1895,59 @@ template <class Key, class T, class Compare, class Allocator> void TreeAVL<Key,T
 		namespace serialize{
 
 //! Specialization of the Serialize template to support TreeAVL objects.
-template <typename Buff, typename... Types> std::size_t Serialize<Buff,bpp::collections::map::TreeAVL<Types...>>::operator()(Buff& buffer, const bpp::collections::map::TreeAVL<Types...>& obj) const{
-	std::queue<typename bpp::collections::map::TreeAVL<Types...>::node_type*> queue;
+template <typename Buff, class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t Serialize<Buff,bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>>::operator()(Buff& buffer, const bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& obj) const{
+	// Nodes are written in pre-order, each one preceded by a flag byte with its children (0x1 left, 0x2 right) and whether they are two ranks below it (0x4 left, 0x8 right)
+	typename bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL* ptr = obj.root;
 	std::size_t objs = obj.size();
 	std::size_t res = serialize(buffer, objs);
-	if(objs){
-		queue.push(obj.root);
-		do{
-			typename bpp::collections::map::TreeAVL<Types...>::node_type* ptr = queue.front();
-			queue.pop();
-			res += serialize(buffer, ptr->data);
-			if(ptr->leftChild){ queue.push(ptr->leftChild); }
-			if(ptr->rightChild){ queue.push(ptr->rightChild); }
-		}while(queue.size());
+	while(ptr){
+		uint8_t shape = (ptr->leftChild ? 0x1 : 0x0) | (ptr->rightChild ? 0x2 : 0x0) | ((ptr->height - obj.height_of(ptr->leftChild) == 2) ? 0x4 : 0x0) | ((ptr->height - obj.height_of(ptr->rightChild) == 2) ? 0x8 : 0x0);
+		res += serialize(buffer, shape, ptr->data);
+		if(ptr->leftChild){
+			ptr = ptr->leftChild;
+		}else if(ptr->rightChild){
+			ptr = ptr->rightChild;
+		}else{
+			while(ptr->parent && (ptr == ptr->parent->rightChild || !ptr->parent->rightChild)){ ptr = ptr->parent; }
+			ptr = ptr->parent ? ptr->parent->rightChild : 0;
+		}
 	}
 	return res;
 }
-template <typename Buff, typename... Types> std::size_t Deserialize<Buff,bpp::collections::map::TreeAVL<Types...>>::operator()(Buff& buffer, bpp::collections::map::TreeAVL<Types...>& obj) const{
+template <typename Buff, class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> std::size_t Deserialize<Buff,bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>>::operator()(Buff& buffer, bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& obj) const{
+	// Rebuilds the exact shape written by Serialize, the pending flags are kept in height until the subtree of the node is completed. Relaxed trees take their ranks from the flags, since their heights may not be balanced as in an AVL tree
+	typename bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>::NodeAVL *ptr, *parent = 0, **link = &obj.root;
 	std::size_t objs;
 	std::size_t res = deserialize(buffer, objs);
 	obj.clear();
 	for(std::size_t i=0; i<objs; ++i){
-		std::pair<typename bpp::collections::map::TreeAVL<Types...>::key_type,typename bpp::collections::map::TreeAVL<Types...>::mapped_type> value;
-		res += deserialize(buffer, value);
-		obj.insert(value);
+		std::pair<Key,T> value;
+		uint8_t shape;
+		res += deserialize(buffer, shape, value);
+		ptr = obj.alloc.allocate(1);
+		std::construct_at(ptr, std::move(value.first), parent);
+		ptr->data.second = std::move(value.second);
+		ptr->height = shape;
+		*link = ptr;
+		if(shape & 0x1){
+			parent = ptr;
+			link = &ptr->leftChild;
+		}else if(shape & 0x2){
+			parent = ptr;
+			link = &ptr->rightChild;
+		}else{
+			if constexpr(Relaxed){ ptr->recalculate_rank(); }else{ ptr->recalculate_height(); }
+			ptr->recalculate_summary();
+			while(ptr->parent && (ptr == ptr->parent->rightChild || !(ptr->parent->height & 0x2))){
+				ptr = ptr->parent;
+				if constexpr(Relaxed){ ptr->recalculate_rank(); }else{ ptr->recalculate_height(); }
+				ptr->recalculate_summary();
+			}
+			parent = ptr->parent;
+			link = parent ? &parent->rightChild : 0;
+		}
 	}
+	obj.counter = objs;
 	return res;
 }
 
@@ -912,21 +1957,14 @@ template <typename Buff, typename... Types> std::size_t Deserialize<Buff,bpp::co
 
 // Non-member
 // Other
-template <class A, class B, class C, class D, class Pred> std::size_t std::erase_if(bpp::collections::map::TreeAVL<A,B,C,D>& tree, Pred pred){
-	auto original = tree.size();
-	for (auto i = tree.begin(), last = tree.end(); i != last; ){
-		if(pred(*i)){
-			i = tree.erase(i);
-		}else{
-			++i;
-		}
-	}
-	return original - tree.size();
+template <class A, class B, class C, class D, bool E, class F, bool G, class Pred> std::size_t std::erase_if(bpp::collections::map::TreeAVL<A,B,C,D,E,F,G>& tree, Pred pred){
+	return tree.erase_nodes_if(pred);
 }
-template <class A, class B, class C, class D> void std::swap(bpp::collections::map::TreeAVL<A,B,C,D>& lhs, bpp::collections::map::TreeAVL<A,B,C,D>& rhs){
+template <class A, class B, class C, class D, bool E, class F, bool G> void std::swap(bpp::collections::map::TreeAVL<A,B,C,D,E,F,G>& lhs, bpp::collections::map::TreeAVL<A,B,C,D,E,F,G>& rhs){
 	std::swap(lhs.alloc, rhs.alloc);
 	std::swap(lhs.cmp, rhs.cmp);
 	std::swap(lhs.root, rhs.root);
+	std::swap(lhs.rightmost, rhs.rightmost);
 	std::swap(lhs.counter, rhs.counter);
 }
 
@@ -1,26 +1,88 @@
 #ifndef BPP_COLLECTIONS_MAP_TREEAVL_H
 #define BPP_COLLECTIONS_MAP_TREEAVL_H
+#include <algorithm>		// std::sort, std::inplace_merge, std::unique
 #include <compare>			// std::strong_ordering
+#include <cstdint>			// uint8_t
+#include <concepts>			// std::same_as
+#include <exception>		// std::exception_ptr, std::current_exception, std::rethrow_exception
 #include <functional>		// std::less
 #include <initializer_list>	// std::initializer_list<>
+#include <iterator>			// std::forward_iterator, std::distance, std::iterator_traits<>, std::default_sentinel_t
+#include <limits>			// std::numeric_limits<>
 #include <memory>			// std::allocator<>, std::allocator_traits<>, std::construct_at, std::destroy_at
-#include <queue>			// std:queue<>
+#include <optional>			// std::optional<>
+#include <ranges>			// std::ranges::subrange<>, std::ranges::subrange_kind
 #include <stdexcept>		// std::out_of_range
-#include <type_traits>		// std::true_type, std::false_type
+#include <thread>			// std::thread
+#include <type_traits>		// std::true_type, std::false_type, std::conditional_t, std::type_identity<>, std::is_same_v, std::is_void_v, std::is_reference_v, std::is_trivially_destructible_v, std::remove_cvref_t
 #include <utility>			// std::pair, std::swap, std::move
+#include <vector>			// std::vector<>
 #include "../Serialize.h"
 
 namespace bpp{
 	namespace collections{
 		namespace map{
 
+//! Monoid for TreeAVL that aggregates the sum of the mapped values.
+template <class V> struct SumMonoid{
+	//! Type of the aggregates.
+	using value_type = V;
+	//! Returns a value-initialized V.
+	static V identity();
+	//! Returns the sum of lhs and rhs.
+	static V combine(const V& lhs, const V& rhs);
+	//! Returns the mapped value of element.
+	template <class Element> static V lift(const Element& element);
+};
+//! Monoid for TreeAVL that aggregates the minimum of the mapped values.
+template <class V> struct MinMonoid{
+	//! Type of the aggregates.
+	using value_type = V;
+	//! Returns the largest finite value of V.
+	static V identity();
+	//! Returns the smallest of lhs and rhs.
+	static V combine(const V& lhs, const V& rhs);
+	//! Returns the mapped value of element.
+	template <class Element> static V lift(const Element& element);
+};
+//! Monoid for TreeAVL that aggregates the maximum of the mapped values. With the start of intervals as keys and their end as mapped values it turns the tree into an interval tree (see TreeAVL::for_each_where()).
+template <class V> struct MaxMonoid{
+	//! Type of the aggregates.
+	using value_type = V;
+	//! Returns the lowest finite value of V.
+	static V identity();
+	//! Returns the largest of lhs and rhs.
+	static V combine(const V& lhs, const V& rhs);
+	//! Returns the mapped value of element.
+	template <class Element> static V lift(const Element& element);
+};
+
 //! TreeAVL is a sorted associative container that contains key-value pairs with unique keys. Keys are sorted by using the comparison function Compare. Search, removal, and insertion operations have logarithmic complexity. This is an implementation of an Adelson-Velsky and Landis Tree.
-template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>> class TreeAVL{
+//! If Ranked is true every node also keeps the size of its subtree, which enables the order statistic operations select(), rank() and distance() in logarithmic time.
+//! If Monoid is not void every node also keeps the aggregate of the elements in its subtree, which enables range_query() in logarithmic time. Monoid must define value_type and the static member functions identity(), combine(lhs, rhs), which must be associative with identity() as its identity element, and lift(element), which returns the value_type of an element (see SumMonoid, MinMonoid and MaxMonoid).
+//! If Relaxed is true the heights kept by the nodes become ranks of a weak AVL (rank-balanced) tree, in which a node may be two ranks above both its children. Insertions rebalance exactly as in an AVL tree, but removals stop as soon as no child is three ranks below its parent and perform at most one single or double rotation, so under heavy churn far fewer ancestors are rewritten. The height stays below 2 log2(n), and it is that of an AVL tree as long as no element is removed.
+//! Lookups accept keys of any type. If Compare defines is_transparent (e.g. std::less<>) they are compared directly with the stored keys, otherwise they are converted to Key once per lookup.
+template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>, bool Ranked = false, class Monoid = void, bool Relaxed = false> class TreeAVL{
 	private:
 		struct NodeAVL;
 		struct iterator_actions;
 		// Rebind Allocator
 		using AllocatorNodes = typename std::allocator_traits<Allocator>::rebind_alloc<NodeAVL>;
+		// Heterogeneous lookup, keys of other types are converted once to Key unless Compare is transparent
+		static constexpr bool transparent = requires{ typename Compare::is_transparent; };
+		template <class K> using lookup_key = std::conditional_t<transparent || std::is_same_v<K, Key>, const K&, const Key>;
+		// Augmentation, Monoid is only inspected if it is not void
+		static constexpr bool augmented = !std::is_void_v<Monoid>;
+		template <class M> struct monoid_value{
+			using type = typename M::value_type;
+		};
+		// Number of descents interleaved by batched lookups
+		static constexpr std::size_t lookup_group = 16;
+		// Ranges shorter than this are erased one node at a time instead of splitting the tree
+		static constexpr std::size_t erase_run = 16;
+		// Subtrees at most this tall are traversed by a single thread, and ranges at most this long are sorted or built by a single thread
+		static constexpr std::size_t parallel_height = 12;
+		static constexpr std::size_t parallel_grain = 1<<14;
 	public:
 		// Declares member types
 		//! Type of the keys for the key-value pairs.
@@ -41,8 +103,42 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		using reference = value_type&;
 		//! Type of constant references to values.
 		using const_reference = const value_type&;
-		//! Type of container node.
-		using node_type = NodeAVL;
+		//! Type of the aggregates kept by the nodes, void if Monoid is void.
+		using aggregate_type = typename std::conditional_t<augmented, monoid_value<Monoid>, std::type_identity<void>>::type;
+		//! Node handle, owns an element extracted from a container until it is inserted into another one or destroyed. Inserting it into a container with an allocator that compares equal relinks the node without allocating or copying.
+		struct node_type{
+			//! Type of the keys for the key-value pair.
+			using key_type = Key;
+			//! Type of the mapped value for the key-value pair.
+			using mapped_type = T;
+			//! Type of allocator used.
+			using allocator_type = Allocator;
+			//! Constructs an empty node handle.
+			node_type() noexcept;
+			//! Move constructor. Takes ownership of the element of other, which becomes empty.
+			node_type(node_type&& other) noexcept;
+			//! Move assignment. Destroys the owned element (if any) and takes ownership of the element of other, which becomes empty.
+			node_type& operator=(node_type&& other);
+			//! Destroys the owned element (if any) and deallocates its node.
+			~node_type();
+			//! Checks if the node handle owns no element.
+			bool empty() const noexcept;
+			//! Checks if the node handle owns an element.
+			explicit operator bool() const noexcept;
+			//! Returns a copy of the allocator of the owned node.
+			Allocator get_allocator() const;
+			//! Returns a reference to the key of the owned element, which can be modified before inserting it again.
+			Key& key() const;
+			//! Returns a reference to the mapped value of the owned element.
+			T& mapped() const;
+			//! Swaps the elements and allocators of both node handles.
+			void swap(node_type& other) noexcept;
+			private:
+				friend class TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>;
+				NodeAVL* node;
+				AllocatorNodes alloc;
+				node_type(NodeAVL* node, const AllocatorNodes& alloc);
+		};
 		
 		//! Constructs an empty container.
 		TreeAVL();
@@ -51,9 +147,9 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		//! Constructs an empty container. Receives the allocator to use for all memory allocations.
 		explicit TreeAVL(const Allocator& alloc);
 		
-		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations.
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Can receive the comparison function object to use for all comparisons of keys and the allocator to use for all memory allocations. If the range is sorted in strictly increasing order of keys, the tree is built in linear time.
 		template <class InputIt> TreeAVL(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator());
-		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Receives the allocator to use for all memory allocations.
+		//! Constructs the container with the contents of the range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. Receives the allocator to use for all memory allocations. If the range is sorted in strictly increasing order of keys, the tree is built in linear time.
 		template <class InputIt> TreeAVL(InputIt first, InputIt last, const Allocator& alloc);
 		
 		//! Copy constructor. Constructs the container with the copy of the contents of other.
@@ -89,6 +185,8 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		// Element access
 		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown.
 		const T& at(const Key& key) const;
+		//! Returns a reference to the mapped value of the element with key equivalent to key. If no such element exists, an exception of type std::out_of_range is thrown. Only available if Compare is transparent.
+		template <class K> const T& at(const K& key) const requires transparent;
 		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
 		T& operator[](const Key& key);
 		//! Returns a reference to the value that is mapped to a key equivalent to key, performing an insertion if such key does not already exist.
@@ -102,11 +200,13 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			//! Type of values accessed by the iterator.
 			using value_type = std::pair<const Key, T>;
 			//! Type of differences between iterators.
-			using difference_type = std::size_t;
-			//! Type of objects pointed to by the iterator.
-			using pointer = NodeAVL*;
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = std::pair<const Key, T>*;
 			//! Type of references to values.
 			using reference = std::pair<const Key, T>&;
+			//! Constructs an iterator pointing at init, or equal to end() if init is null. The tree of init is required to regress from end().
+			iterator(NodeAVL* init = 0, const TreeAVL* tree = 0);
 			//! References the key-value pair pointed at by the iterator.
 			std::pair<const Key, T>& operator*() const;
 			//! Dereferences the key-value pair pointed at by the iterator.
@@ -115,9 +215,9 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			iterator& operator++();
 			//! Advances the iterator to the next key-value in the map.
 			iterator operator++(int);
-			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the previous key-value in the map, end() regresses to the last one. If out of bounds, becomes equal to end().
 			iterator& operator--();
-			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the previous key-value in the map, end() regresses to the last one. If out of bounds, becomes equal to end().
 			iterator operator--(int);
 		};
 		//! const_iterator is an object that allows iteration of the container in the order of the sorted keys for access only. Beware that any changes in the tree may invalidate the iterators and produce undefined behaviour.
@@ -125,13 +225,17 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			//! Category of the iterator.
 			using iterator_category = std::bidirectional_iterator_tag;
 			//! Type of values accessed by the iterator.
-			using value_type = const std::pair<const Key, T>;
+			using value_type = std::pair<const Key, T>;
 			//! Type of differences between iterators.
-			using difference_type = std::size_t;
-			//! Type of objects pointed to by the iterator.
-			using pointer = NodeAVL*;
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = const std::pair<const Key, T>*;
 			//! Type of references to values.
 			using reference = const std::pair<const Key, T>&;
+			//! Constructs an iterator pointing at init, or equal to end() if init is null. The tree of init is required to regress from end().
+			const_iterator(NodeAVL* init = 0, const TreeAVL* tree = 0);
+			//! Constructs a constant iterator pointing at the same element as other.
+			const_iterator(const iterator& other);
 			//! References the key-value pair pointed at by the iterator.
 			const std::pair<const Key, T>& operator*() const;
 			//! Dereferences the key-value pair pointed at by the iterator.
@@ -140,9 +244,9 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			const_iterator& operator++();
 			//! Advances the iterator to the next key-value in the map.
 			const_iterator operator++(int);
-			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the previous key-value in the map, end() regresses to the last one. If out of bounds, becomes equal to end().
 			const_iterator& operator--();
-			//! Regresses the iterator to the previous key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the previous key-value in the map, end() regresses to the last one. If out of bounds, becomes equal to end().
 			const_iterator operator--(int);
 		};
 		//! reverse_iterator is an object that allows iteration of the container in the inverse order of the sorted keys. Beware that any changes in the tree may invalidate the iterators and produce undefined behaviour.
@@ -152,11 +256,13 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			//! Type of values accessed by the iterator.
 			using value_type = std::pair<const Key, T>;
 			//! Type of differences between iterators.
-			using difference_type = std::size_t;
-			//! Type of objects pointed to by the iterator.
-			using pointer = NodeAVL*;
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = std::pair<const Key, T>*;
 			//! Type of references to values.
 			using reference = std::pair<const Key, T>&;
+			//! Constructs an iterator pointing at init, or equal to rend() if init is null. The tree of init is required to regress from rend().
+			reverse_iterator(NodeAVL* init = 0, const TreeAVL* tree = 0);
 			//! Returns the underlying base iterator.
 			inline constexpr iterator base() const;
 			//! References the key-value pair pointed at by the iterator.
@@ -167,9 +273,9 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			reverse_iterator& operator++();
 			//! Advances the iterator to the previous key-value in the map.
 			reverse_iterator operator++(int);
-			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the next key-value in the map, rend() regresses to the first one. If out of bounds, becomes equal to rend().
 			reverse_iterator& operator--();
-			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the next key-value in the map, rend() regresses to the first one. If out of bounds, becomes equal to rend().
 			reverse_iterator operator--(int);
 		};
 		//! const_reverse_iterator is an object that allows iteration of the container in the inverse order of the sorted keys for access only. Beware that any changes in the tree may invalidate the iterators and produce undefined behaviour.
@@ -177,13 +283,15 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			//! Category of the iterator.
 			using iterator_category = std::bidirectional_iterator_tag;
 			//! Type of values accessed by the iterator.
-			using value_type = const std::pair<const Key, T>;
+			using value_type = std::pair<const Key, T>;
 			//! Type of differences between iterators.
-			using difference_type = std::size_t;
-			//! Type of objects pointed to by the iterator.
-			using pointer = NodeAVL*;
+			using difference_type = std::ptrdiff_t;
+			//! Type of pointers to values.
+			using pointer = const std::pair<const Key, T>*;
 			//! Type of references to values.
 			using reference = const std::pair<const Key, T>&;
+			//! Constructs an iterator pointing at init, or equal to rend() if init is null. The tree of init is required to regress from rend().
+			const_reverse_iterator(NodeAVL* init = 0, const TreeAVL* tree = 0);
 			//! Returns the underlying base iterator.
 			inline constexpr const_iterator base() const;
 			//! References the key-value pair pointed at by the iterator.
@@ -194,11 +302,21 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 			const_reverse_iterator& operator++();
 			//! Advances the iterator to the previous key-value in the map.
 			const_reverse_iterator operator++(int);
-			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the next key-value in the map, rend() regresses to the first one. If out of bounds, becomes equal to rend().
 			const_reverse_iterator& operator--();
-			//! Regresses the iterator to the next key-value in the map. If out of bounds, becomes equal to end().
+			//! Regresses the iterator to the next key-value in the map, rend() regresses to the first one. If out of bounds, becomes equal to rend().
 			const_reverse_iterator operator--(int);
 		};
+		//! Result of inserting a node handle: the position of the inserted element (or of the element that prevented the insertion), whether the insertion took place and, if it did not, the node handle that was not inserted.
+		struct insert_return_type{
+			iterator position;
+			bool inserted;
+			node_type node;
+		};
+		//! Sized view of the map, iterated from begin() to a sentinel.
+		using view_type = std::ranges::subrange<iterator, std::default_sentinel_t, std::ranges::subrange_kind::sized>;
+		//! Sized constant view of the map, iterated from begin() to a sentinel.
+		using const_view_type = std::ranges::subrange<const_iterator, std::default_sentinel_t, std::ranges::subrange_kind::sized>;
 		//! Returns an iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
 		iterator begin() noexcept;
 		//! Returns a constant iterator to the first element of the map. If the map is empty, the returned iterator will be equal to end().
@@ -223,6 +341,10 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		const_reverse_iterator rend() const noexcept;
 		//! Returns a constant reverse iterator to the element following the last element of the reversed map. It corresponds to the element preceding the first element of the non-reversed map. This element acts as a placeholder, attempting to access it results in undefined behavior.
 		const_reverse_iterator crend() const noexcept;
+		//! Returns a sized view of the map from begin() to a std::default_sentinel_t end, which compares equal to any iterator past the last element without building an end() iterator.
+		view_type view() noexcept;
+		//! Returns a sized constant view of the map from begin() to a std::default_sentinel_t end, which compares equal to any iterator past the last element without building an end() iterator.
+		const_view_type view() const noexcept;
 		
 		// Capacity
 		//! Checks if the container has no elements, i.e. whether begin() == end().
@@ -234,7 +356,7 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		
 		// Modifiers
 		// Clear
-		//! Erases all elements from the container. After this call, size() returns zero. Invalidates any references, pointers, or iterators referring to contained elements. Any past-the-end iterator remains valid.
+		//! Erases all elements from the container. After this call, size() returns zero. Invalidates any references, pointers, or iterators referring to contained elements. Any past-the-end iterator remains valid. If the allocator supports releasing its storage at once (see bpp::utility::memory::ArenaAllocator) and the elements are trivially destructible, the nodes are released without visiting them.
 		void clear() noexcept;
 		// Insert
 		//! Inserts element(s) into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
@@ -242,37 +364,68 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		// template <class P> std::pair<iterator, bool> insert(P&& value);
 		//! Inserts element(s) into the container, if the container doesn't already contain an element with an equivalent key. Returns a pair consisting of an iterator to the inserted element (or to the element that prevented the insertion) and a bool denoting whether the insertion took place.
 		std::pair<iterator, bool> insert(std::pair<const Key, T>&& value);
-		//! Inserts value in the position as close as possible to hint. Returns an iterator to the inserted element, or to the element that prevented the insertion.
+		//! Inserts value in the position as close as possible to hint. Returns an iterator to the inserted element, or to the element that prevented the insertion. If value belongs right before or right after hint (after the last element if hint is end(), as when appending increasing keys) only its neighbours are compared, otherwise it is searched from the root. The last element is cached, so appending increasing keys at end() takes amortized constant time (unless Ranked or Monoid is used, since their counts and aggregates are updated up to the root); other hints also walk from hint to the neighbours.
 		iterator insert(iterator hint, const std::pair<const Key, T>& value);
 		// template <class P> iterator insert(const_iterator hint, P&& value);
-		//! Inserts value in the position as close as possible to hint. Returns an iterator to the inserted element, or to the element that prevented the insertion.
+		//! Inserts value in the position as close as possible to hint. Returns an iterator to the inserted element, or to the element that prevented the insertion. If value belongs right before or right after hint (after the last element if hint is end(), as when appending increasing keys) only its neighbours are compared, otherwise it is searched from the root. The last element is cached, so appending increasing keys at end() takes amortized constant time (unless Ranked or Monoid is used, since their counts and aggregates are updated up to the root); other hints also walk from hint to the neighbours.
 		iterator insert(iterator hint, std::pair<const Key, T>&& value);
-		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		//! Inserts elements from range [first, last). If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted. If the container is empty and the range is sorted in strictly increasing order of keys, the tree is built in linear time.
 		template <class InputIt> void insert(InputIt first, InputIt last);
 		//! Inserts elements from initializer list ilist. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
 		void insert(std::initializer_list<std::pair<const Key, T>> ilist);
+		//! Inserts the element owned by nh, if the container doesn't already contain an element with an equivalent key. The node is relinked without allocating or copying if the allocators compare equal, otherwise its element is moved into a new node. If nh is empty, inserted is false and position is end(). If the key was already present, nh is returned unchanged in the result.
+		insert_return_type insert(node_type&& nh);
+		//! Inserts the element owned by nh, if the container doesn't already contain an element with an equivalent key. Returns an iterator to the inserted element, or to the element that prevented the insertion (in which case nh keeps its element). If nh is empty, returns end(). The position is searched from hint as in insert(hint, value).
+		iterator insert(const_iterator hint, node_type&& nh);
+		//! Replaces the contents with the elements from range [first, last), which must be sorted in strictly increasing order of keys (otherwise the behaviour is undefined). The balanced tree is built bottom-up in linear time without any comparisons or rotations.
+		template <class InputIt> void assign_sorted(InputIt first, InputIt last) requires std::forward_iterator<InputIt>;
 		// Insert or Assign
 		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
 		template <class M> std::pair<iterator, bool> insert_or_assign(const Key& k, M&& obj);
 		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
 		template <class M> std::pair<iterator, bool> insert_or_assign(Key&& k, M&& obj);
-		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert(hint, value).
 		template <class M> std::pair<iterator, bool> insert_or_assign(iterator hint, const Key& k, M&& obj);
-		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert.
+		//! If a key equivalent to k already exists in the container, assigns obj to the mapped_type corresponding to the key k. If the key does not exist, inserts the new value as if by insert(hint, value).
 		template <class M> std::pair<iterator, bool> insert_or_assign(iterator hint, Key&& k, M&& obj);
 		// Erase
 		//! Removes element at pos from the container. Returns iterator following the last removed element.
 		iterator erase(iterator pos);
 		//! Removes element at pos from the container. Returns iterator following the last removed element.
 		iterator erase(const_iterator pos);
-		//! Removes the elements in the range [first; last), which must be a valid range in *this.
+		//! Removes the elements in the range [first; last), which must be a valid range in *this. Iterators to the other elements remain valid. Longer ranges are cut out with two splits and a join, so removing k elements costs O(log n + k).
 		iterator erase(iterator first, iterator last);
-		//! Removes the elements in the range [first; last), which must be a valid range in *this.
+		//! Removes the elements in the range [first; last), which must be a valid range in *this. Iterators to the other elements remain valid. Longer ranges are cut out with two splits and a join, so removing k elements costs O(log n + k).
 		iterator erase(const_iterator first, const_iterator last);
 		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
 		std::size_t erase(const Key& key);
 		//! Removes the element (if one exists) with the key equivalent to key. Returns the number of elements removed (0 or 1).
 		template <class K> std::size_t erase(K&& key);
+		// Extract and merge
+		//! Unlinks the element at pos from the container and returns a node handle that owns it. No element is copied or moved and the node is not deallocated. Only iterators to the extracted element are invalidated.
+		node_type extract(iterator pos);
+		//! Unlinks the element at pos from the container and returns a node handle that owns it. No element is copied or moved and the node is not deallocated. Only iterators to the extracted element are invalidated.
+		node_type extract(const_iterator pos);
+		//! Unlinks the element (if one exists) with the key equivalent to key from the container and returns a node handle that owns it, or an empty node handle otherwise.
+		template <class K> node_type extract(const K& key);
+		//! Moves into the container every element of source whose key is not already present, relinking their nodes without allocating or copying if both allocators compare equal. The elements with keys already present remain in source. Iterators to the moved elements remain valid, but now refer into the container.
+		void merge(TreeAVL& source);
+		//! Moves into the container every element of source whose key is not already present, relinking their nodes without allocating or copying if both allocators compare equal. The elements with keys already present remain in source. Iterators to the moved elements remain valid, but now refer into the container.
+		void merge(TreeAVL&& source);
+		// Join and split
+		//! Moves all the elements of other into the container without reallocating nodes. All keys in other must compare greater than all keys in the container, or all of them less. Logarithmic complexity if both allocators compare equal, otherwise the elements are inserted one by one. After the call, other is empty().
+		void join(TreeAVL&& other);
+		//! Inserts value and moves all the elements of other into the container without reallocating nodes. The key of value must compare greater than all keys in the container and all keys in other must compare greater than it. Logarithmic complexity if both allocators compare equal, otherwise the elements are inserted one by one. After the call, other is empty().
+		void join(const std::pair<const Key, T>& value, TreeAVL&& other);
+		//! Removes all elements with a key that compares not less than key and returns them in a new container, without reallocating nodes. Logarithmic complexity if Ranked is true, otherwise the sizes of both parts are recounted in linear time on the size of the smaller part.
+		template <class K> TreeAVL split(const K& key);
+		// Set operations
+		//! Moves into the container all the elements of other whose keys are not already present, without reallocating nodes. The elements of other with keys already present are destroyed. Uses the join-based algorithm with O(m log(n/m + 1)) complexity if both allocators compare equal, otherwise the elements are inserted one by one. After the call, other is empty().
+		void set_union(TreeAVL&& other);
+		//! Removes all elements whose keys are not present in other. Uses the join-based algorithm with O(m log(n/m + 1)) complexity.
+		void set_intersection(const TreeAVL& other);
+		//! Removes all elements whose keys are present in other. Uses the join-based algorithm with O(m log(n/m + 1)) complexity.
+		void set_difference(const TreeAVL& other);
 		
 		// Lookup
 		// Count
@@ -286,6 +439,13 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		// Contains
 		//! Checks if there is an element with key that compares equivalent to the value of key.
 		template <class K> bool contains(const K& key) const;
+		// Batched lookup
+		//! Finds the elements with keys equivalent to each key in the range [first, last) and writes an iterator to each of them (or end() if not found) to the range beginning at d_first. The descents of several keys are interleaved and their next nodes prefetched, so that their cache misses overlap. Returns an iterator past the last element written.
+		template <class ForwardIt, class OutputIt> OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt d_first);
+		//! Finds the elements with keys equivalent to each key in the range [first, last) and writes an iterator to each of them (or cend() if not found) to the range beginning at d_first. The descents of several keys are interleaved and their next nodes prefetched, so that their cache misses overlap. Returns an iterator past the last element written.
+		template <class ForwardIt, class OutputIt> OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt d_first) const;
+		//! Checks for each key in the range [first, last) if there is an element with an equivalent key and writes the results to the range beginning at d_first. The descents of several keys are interleaved and their next nodes prefetched, so that their cache misses overlap. Returns an iterator past the last element written.
+		template <class ForwardIt, class OutputIt> OutputIt contains_many(ForwardIt first, ForwardIt last, OutputIt d_first) const;
 		// Bounds
 		//! Returns an iterator pointing to the first element that compares not less (i.e. greater or equal) to the value of key. If no such element is found, past-the-end (see end()) iterator is returned.
 		template <class K> iterator lower_bound(const K& key);
@@ -300,17 +460,51 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		//! Returns a range containing all elements with the given key in the container. The range is defined by two iterators, one pointing to the first element that is not less than key and another pointing to the first element greater than key. Alternatively, the first iterator may be obtained with lower_bound(), and the second with upper_bound().
 		template <class K> std::pair<const_iterator,const_iterator> equal_range(const K& key) const;
 		
+		// Order statistics
+		//! Returns an iterator to the k-th smallest element of the map (counting from zero). If k is not less than size(), past-the-end (see end()) iterator is returned. Only available if Ranked is true.
+		iterator select(std::size_t k) requires Ranked;
+		//! Returns a constant iterator to the k-th smallest element of the map (counting from zero). If k is not less than size(), past-the-end (see cend()) iterator is returned. Only available if Ranked is true.
+		const_iterator select(std::size_t k) const requires Ranked;
+		//! Returns the number of elements with a key that compares less than key. Only available if Ranked is true.
+		template <class K> std::size_t rank(const K& key) const requires Ranked;
+		//! Returns the number of increments needed to go from first to last, negative if last precedes first. Only available if Ranked is true.
+		std::ptrdiff_t distance(const_iterator first, const_iterator last) const requires Ranked;
+		//! Returns the number of increments needed to go from first to last, negative if last precedes first. Only available if Ranked is true.
+		std::ptrdiff_t distance(iterator first, iterator last) const requires Ranked;
+		
+		// Aggregates
+		//! Returns the aggregate of all the elements of the container, or Monoid::identity() if it is empty. Constant complexity. Only available if Monoid is not void.
+		aggregate_type aggregate() const requires augmented;
+		//! Returns the aggregate, in the order of the keys, of the elements with a key that compares not less than first and less than last. Logarithmic complexity. Only available if Monoid is not void.
+		template <class K> aggregate_type range_query(const K& first, const K& last) const requires augmented;
+		//! Calls f in the order of the keys with every element whose key compares less than last and for which pred(Monoid::lift(element)) is true, skipping the subtrees whose aggregate does not satisfy pred. pred must hold for the aggregate of a subtree whenever it holds for one of its elements: e.g. with MaxMonoid over the end of intervals keyed by their start, pred(end) = end > start visits the intervals that overlap [start, last). Only available if Monoid is not void.
+		template <class K, class Pred, class Function> void for_each_where(const K& last, Pred pred, Function f) const requires augmented;
+		//! Recalculates the aggregates that depend on the element at pos. Must be called after modifying its mapped value through a reference (e.g. returned by operator[], at() or an iterator), since the container can not observe those changes. Logarithmic complexity. Only available if Monoid is not void.
+		void refresh(iterator pos) requires augmented;
+		//! Recalculates the aggregates that depend on the element at pos. Must be called after modifying its mapped value through a reference (e.g. returned by operator[], at() or an iterator), since the container can not observe those changes. Logarithmic complexity. Only available if Monoid is not void.
+		void refresh(const_iterator pos) requires augmented;
+		
+		// Parallel operations
+		//! Calls f with every element of the container, splitting the tree along its subtrees between up to threads threads (one per hardware thread by default). The order of the calls is unspecified, f must be safe to call concurrently and it may modify the mapped values. An exception thrown by f is rethrown once every thread has finished.
+		template <class Function> void parallel_for_each(Function f, std::size_t threads = std::thread::hardware_concurrency());
+		//! Calls f with every element of the container, splitting the tree along its subtrees between up to threads threads (one per hardware thread by default). The order of the calls is unspecified and f must be safe to call concurrently. An exception thrown by f is rethrown once every thread has finished.
+		template <class Function> void parallel_for_each(Function f, std::size_t threads = std::thread::hardware_concurrency()) const;
+		//! Combines init and the results of transform for every element with reduce, following the order of the keys: reduce must be associative but does not need to be commutative. The subtrees are reduced by up to threads threads (one per hardware thread by default). Returns init if the container is empty.
+		template <class R, class Reduce, class Transform> R parallel_reduce(R init, Reduce reduce, Transform transform, std::size_t threads = std::thread::hardware_concurrency()) const;
+		//! Replaces the contents with the elements from range [first, last), which does not need to be sorted. The elements are sorted by up to threads threads (one per hardware thread by default) and the balanced tree is built bottom-up in linear time, also in parallel if the allocator is stateless. If multiple elements in the range have keys that compare equivalent, it is unspecified which element is inserted.
+		template <class InputIt> void assign_parallel(InputIt first, InputIt last, std::size_t threads = std::thread::hardware_concurrency());
+		
 		// Non-member
 		// Operators
 		//! Checks if the contents of lhs and rhs are equal, that is, they have the same number of elements and each element in lhs compares equal with the element in rhs at the same position.
-		template <class A, class B, class C, class D> friend bool operator==(const TreeAVL<A,B,C,D>& lhs, const TreeAVL<A,B,C,D>& rhs);
+		template <class A, class B, class C, class D, bool E, class F, bool G> friend bool operator==(const TreeAVL<A,B,C,D,E,F,G>& lhs, const TreeAVL<A,B,C,D,E,F,G>& rhs);
 		//! Compares the contents of lhs and rhs lexicographically.
-		template <class A, class B, class C, class D> friend std::strong_ordering operator<=>(const TreeAVL<A,B,C,D>& lhs, const TreeAVL<A,B,C,D>& rhs);
+		template <class A, class B, class C, class D, bool E, class F, bool G> friend std::strong_ordering operator<=>(const TreeAVL<A,B,C,D,E,F,G>& lhs, const TreeAVL<A,B,C,D,E,F,G>& rhs);
 		// Other
-		//! Erases all elements that satisfy the predicate pred from the container.
-		template <class A, class B, class C, class D, class Pred> friend std::size_t std::erase_if(TreeAVL<A,B,C,D>& tree, Pred pred);
+		//! Erases all elements that satisfy the predicate pred from the container. Once the matches reach an eighth of the visited elements, the remaining ones are filtered and rebuilt balanced in a single linear pass instead of being erased one by one.
+		template <class A, class B, class C, class D, bool E, class F, bool G, class Pred> friend std::size_t std::erase_if(TreeAVL<A,B,C,D,E,F,G>& tree, Pred pred);
 		//! Specialized swapping function.
-		template <class A, class B, class C, class D> friend void std::swap(TreeAVL<A,B,C,D> &lhs, TreeAVL<A,B,C,D>& rhs);
+		template <class A, class B, class C, class D, bool E, class F, bool G> friend void std::swap(TreeAVL<A,B,C,D,E,F,G> &lhs, TreeAVL<A,B,C,D,E,F,G>& rhs);
 		// Friendship
 		//! Specialization of the Serialize template to support TreeAVL objects.
 		template <typename Buff, typename... Types> friend struct bpp::collections::serialize::Serialize;
@@ -319,42 +513,92 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		
 	private:
 		// Nested class NodeAVL
+		struct Empty{};
+		struct NoAggregate{};
 		struct NodeAVL{
 			NodeAVL *parent,*leftChild,*rightChild;
 			std::pair<const Key,T> data;
 			std::size_t height;
+			[[no_unique_address]] std::conditional_t<Ranked, std::size_t, Empty> count;
+			[[no_unique_address]] std::conditional_t<augmented, aggregate_type, NoAggregate> aggregate;
 			NodeAVL(NodeAVL* parent=0);
 			NodeAVL(const Key& key, NodeAVL* parent=0);
 			NodeAVL(Key&& key, NodeAVL* parent=0);
 			~NodeAVL();
 			inline void recalculate_height();
+			inline void recalculate_rank();
+			inline void recalculate_summary();
 			inline int left_heavy();
+			inline int right_heavy();
 			static NodeAVL* copy(AllocatorNodes& alloc, NodeAVL* src, NodeAVL* dst=0);
 			static NodeAVL* destroy(AllocatorNodes& alloc, NodeAVL* node);
 		};
 		AllocatorNodes alloc;
 		Compare cmp;
 		NodeAVL *root;
+		// Last node in order, or null if it must be searched again (after bulk changes to the tree)
+		NodeAVL *rightmost;
 		std::size_t counter;
+		template <class K> inline NodeAVL* find_node(const K& key) const;
+		template <class K> inline NodeAVL* lower_node(const K& key) const;
+		template <class K> inline NodeAVL* upper_node(const K& key) const;
+		template <class ForwardIt, class Visit> void lookup_many(ForwardIt first, ForwardIt last, Visit visit) const;
+		inline static void prefetch(const NodeAVL* node);
 		inline NodeAVL* get_forward(const Key& key);
 		inline NodeAVL* get_forward(Key&& key);
 		inline NodeAVL* get_forward(const Key& key, NodeAVL* hint);
 		inline NodeAVL* get_forward(Key&& key, NodeAVL* hint);
 		inline NodeAVL* remove_node(NodeAVL* src);
+		template <class K> inline NodeAVL** search_link(const K& key, NodeAVL*& parent);
+		template <class K> inline NodeAVL** hint_link(const K& key, NodeAVL* hint, NodeAVL*& parent);
+		inline void link_node(NodeAVL* node, NodeAVL* parent, NodeAVL** link);
+		inline void unlink_node(NodeAVL* src);
+		inline NodeAVL* take_node(NodeAVL* node, AllocatorNodes& owner);
+		inline void destroy_nodes();
+		inline NodeAVL* erase_nodes(NodeAVL* first, NodeAVL* last);
+		template <class Pred> std::size_t erase_nodes_if(Pred& pred);
+		template <class Pred> void filter_nodes(NodeAVL* first, Pred& pred);
+		template <class Pred> void flatten_nodes(NodeAVL*& node, NodeAVL**& tail, std::size_t& kept, Pred& pred);
+		static NodeAVL* relink_subtree(NodeAVL*& head, std::size_t n, NodeAVL* parent);
+		template <class InputIt> inline bool build_sorted(InputIt first, InputIt last);
+		template <class InputIt> NodeAVL* build_subtree(InputIt& it, std::size_t n, NodeAVL* parent);
+		inline std::size_t index_of(NodeAVL* node) const requires Ranked;
+		inline static std::size_t count_of(NodeAVL* node);
+		inline static aggregate_type aggregate_of(const NodeAVL* node) requires augmented;
+		template <class V> inline void assign_mapped(NodeAVL* node, V&& value);
+		inline static void recalculate_path(NodeAVL* node);
+		template <class K, class Pred, class Function> void visit_where(const NodeAVL* node, const K& last, Pred& pred, Function& f) const;
 		inline void rebalance(NodeAVL *source);
+		inline void rebalance_erase(NodeAVL *source);
+		inline static NodeAVL* rebalance_subtree(NodeAVL *source);
+		inline static NodeAVL* rebalance_node(NodeAVL *source);
+		inline static std::size_t height_of(NodeAVL* node);
+		static NodeAVL* join_nodes(NodeAVL* left, NodeAVL* node, NodeAVL* right);
+		static NodeAVL* join_nodes(NodeAVL* left, NodeAVL* right);
+		template <class K> NodeAVL* split_nodes(NodeAVL* node, const K& key, NodeAVL*& left, NodeAVL*& right) const;
+		NodeAVL* union_nodes(NodeAVL* lhs, NodeAVL* rhs, std::size_t& repeated);
+		NodeAVL* intersection_nodes(NodeAVL* lhs, const NodeAVL* rhs, std::size_t& kept);
+		NodeAVL* difference_nodes(NodeAVL* lhs, const NodeAVL* rhs, std::size_t& removed);
+		inline std::size_t recount(NodeAVL* left, NodeAVL* right, std::size_t total) const;
+		template <class Left, class Right> static void fork_join(Left left, Right right);
+		template <class Function> static void for_each_nodes(NodeAVL* node, std::size_t threads, Function& f);
+		template <class R, class Reduce, class Transform> static R reduce_nodes(const NodeAVL* node, std::size_t threads, Reduce& reduce, Transform& transform);
+		template <class RandomIt> void sort_parallel(RandomIt first, RandomIt last, std::size_t threads) const;
+		template <class RandomIt> NodeAVL* build_parallel(RandomIt first, std::size_t n, NodeAVL* parent, std::size_t threads);
 		inline static NodeAVL* rotation_LL(NodeAVL* source);
 		inline static NodeAVL* rotation_RR(NodeAVL* source);
 		inline static NodeAVL* rotation_LR(NodeAVL* source);
 		inline static NodeAVL* rotation_RL(NodeAVL* source);
 		// Iterator base structure
 		struct iterator_actions{
-			friend class TreeAVL<Key,T,Compare,Allocator>;
-			iterator_actions(NodeAVL* init = 0);
+			friend class TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>;
+			iterator_actions(NodeAVL* init = 0, const TreeAVL* tree = 0);
 			bool operator==(const iterator_actions& other) const;
 			bool operator!=(const iterator_actions& other) const;
+			bool operator==(std::default_sentinel_t) const;
 			protected:
 				NodeAVL* current;
-				static std::pair<const Key, T> nullvalue;
+				const TreeAVL* tree;
 				inline void next_element();
 				inline void previous_element();
 		};
@@ -368,13 +612,13 @@ template <class Key, class T, class Compare = std::less<Key>, class Allocator =
 		}
 		namespace serialize{
 
-//! Specialization of the Serialize template to support TreeAVL objects.
-template <typename Buff, typename... Types> struct Serialize<Buff,bpp::collections::map::TreeAVL<Types...>>{
-	std::size_t operator()(Buff& buffer, const bpp::collections::map::TreeAVL<Types...>& obj) const;
+//! Specialization of the Serialize template to support TreeAVL objects. The nodes are stored in pre-order along with the shape of the tree, so that it can be rebuilt exactly without comparisons or rotations.
+template <typename Buff, class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> struct Serialize<Buff,bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>>{
+	std::size_t operator()(Buff& buffer, const bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& obj) const;
 };
-//! Specialization of the Deserialize template to support TreeAVL objects.
-template <typename Buff, typename... Types> struct Deserialize<Buff,bpp::collections::map::TreeAVL<Types...>>{
-	std::size_t operator()(Buff& buffer, bpp::collections::map::TreeAVL<Types...>& obj) const;
+//! Specialization of the Deserialize template to support TreeAVL objects. The tree is rebuilt with the exact shape it had when it was serialized.
+template <typename Buff, class Key, class T, class Compare, class Allocator, bool Ranked, class Monoid, bool Relaxed> struct Deserialize<Buff,bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>>{
+	std::size_t operator()(Buff& buffer, bpp::collections::map::TreeAVL<Key,T,Compare,Allocator,Ranked,Monoid,Relaxed>& obj) const;
 };
 
 		}
@@ -6,210 +6,220 @@ namespace bpp{
 		namespace map{
 
 // Constructors
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::Trie() :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::Trie() :
 	root(&data),
 	counter(0),
 	nCounter(0){ }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::Trie(const Allocator& alloc) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::Trie(const Allocator& alloc) :
 	root(&data),
 	counter(0),
 	nCounter(0),
 	alloc(alloc){ }
-template <class Key, class T, class Container, class Allocator> template<class InputIt> Trie<Key,T,Container,Allocator>::Trie(InputIt first, InputIt last, const Allocator& alloc) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class InputIt> Trie<Key,T,Container,Allocator,Counted,Score>::Trie(InputIt first, InputIt last, const Allocator& alloc) :
 	root(&data),
 	counter(0),
 	nCounter(0),
 	alloc(alloc){
 	for(auto it = first; it != last; ++it){
-		this->get_forward(it->first)->data.second = it->second;
+		NodeTrie* tmp = this->get_forward(it->first, len_array(it->first));
+		tmp->data.second = it->second;
+		this->rescore(tmp);
 	}
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::Trie(const Trie& other, const Allocator& alloc) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::Trie(const Trie& other, const Allocator& alloc) :
 	root(&data),
 	counter(other.counter),
 	nCounter(other.nCounter),
 	alloc(alloc){
 	NodeTrie::copy(this->alloc, other.root, this->root);
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::Trie(Trie&& other) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::Trie(Trie&& other) :
 	root(&data),
-	counter(other.counter),
-	nCounter(other.nCounter),
-	alloc(std::move(other.alloc)),
-	data(std::move(other.data)){
-	other.counter = 0;
-	other.nCounter = 0;
+	counter(0),
+	nCounter(0),
+	alloc(std::move(other.alloc)){
+	this->adopt(other);
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::Trie(Trie&& other, const Allocator& alloc) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::Trie(Trie&& other, const Allocator& alloc) :
 	root(&data),
 	counter(other.counter),
 	nCounter(other.nCounter),
 	alloc(alloc){
 	if(this->alloc == other.alloc){
-		this->data = std::move(other.data);
-		other.counter = 0;
-		other.nCounter = 0;
+		this->adopt(other);
 	}else{
 		NodeTrie::copy(this->alloc, other.root, this->root);
 		other.clear();
 	}
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> Trie<Key,T,Container,Allocator>::Trie(std::initializer_list<std::pair<const Vector, T>> ilist, const Allocator& alloc) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> Trie<Key,T,Container,Allocator,Counted,Score>::Trie(std::initializer_list<std::pair<const Vector, T>> ilist, const Allocator& alloc) :
 	root(&data),
 	counter(0),
 	nCounter(0),
 	alloc(alloc){
 	for(auto it : ilist){
-		this->get_forward(it.first)->data.second = it.second;
+		NodeTrie* tmp = this->get_forward(it.first, len_array(it.first));
+		tmp->data.second = it.second;
+		this->rescore(tmp);
 	}
 }
 
 // Destructor
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::~Trie(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::~Trie(){
 	for(auto it = this->data.children.begin(); it != this->data.children.end(); ++it){
 		NodeTrie::destroy(this->alloc, (NodeTrie*) it->second);
 	}
 }
 
 // Assignment
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>& Trie<Key,T,Container,Allocator>::operator=(const Trie& other){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>& Trie<Key,T,Container,Allocator,Counted,Score>::operator=(const Trie& other){
 	this->sp_copy(other, typename std::allocator_traits<Allocator>::propagate_on_container_copy_assignment());
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>& Trie<Key,T,Container,Allocator>::operator=(Trie&& other){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>& Trie<Key,T,Container,Allocator,Counted,Score>::operator=(Trie&& other){
 	this->sp_move(std::move(other), typename std::allocator_traits<Allocator>::propagate_on_container_move_assignment());
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector> Trie<Key,T,Container,Allocator>& Trie<Key,T,Container,Allocator>::operator=(std::initializer_list<std::pair<const Vector, T>> ilist){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> Trie<Key,T,Container,Allocator,Counted,Score>& Trie<Key,T,Container,Allocator,Counted,Score>::operator=(std::initializer_list<std::pair<const Vector, T>> ilist){
 	this->clear();
 	for(auto it : ilist){
-		this->get_forward(it.first)->data.second = it.second;
+		NodeTrie* tmp = this->get_forward(it.first, len_array(it.first));
+		tmp->data.second = it.second;
+		this->rescore(tmp);
 	}
 	return *this;
 }
 
 // Get allocator
-template <class Key, class T, class Container, class Allocator> Allocator Trie<Key,T,Container,Allocator>::get_allocator() const noexcept{ return this->alloc; }
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Allocator Trie<Key,T,Container,Allocator,Counted,Score>::get_allocator() const noexcept{ return this->alloc; }
 
 // Element access
-template <class Key, class T, class Container, class Allocator> template<class Vector> const T& Trie<Key,T,Container,Allocator>::at(const Vector& key) const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> const T& Trie<Key,T,Container,Allocator,Counted,Score>::at(const Vector& key) const{
 	NodeTrie* ptr = this->find_node(key, len_array(key));
 	if(!ptr || !ptr->valid){ throw std::out_of_range("bpp::collections::map::Trie::at"); }
 	return ptr->data.second;
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> T& Trie<Key,T,Container,Allocator>::operator[](const Vector& key){
-	return get_forward(key, len_array(key))->data.second;
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> T& Trie<Key,T,Container,Allocator,Counted,Score>::operator[](const Vector& key){
+	std::size_t pcounter = this->counter;
+	NodeTrie* tmp = this->get_forward(key, len_array(key));
+	if(pcounter != this->counter){ tmp->data.second = T(); }
+	this->rescore(tmp);
+	return tmp->data.second;
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> T& Trie<Key,T,Container,Allocator>::operator[](Vector&& key){
-	return get_forward(std::move(key), len_array(key))->data.second;
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> T& Trie<Key,T,Container,Allocator,Counted,Score>::operator[](Vector&& key){
+	std::size_t pcounter = this->counter;
+	NodeTrie* tmp = this->get_forward(std::move(key), len_array(key));
+	if(pcounter != this->counter){ tmp->data.second = T(); }
+	this->rescore(tmp);
+	return tmp->data.second;
 }
 
 // Iterators
 // Iterator
-template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>& Trie<Key,T,Container,Allocator>::iterator::operator*(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::pair<const std::vector<Key>&, T&>& Trie<Key,T,Container,Allocator,Counted,Score>::iterator::operator*(){
 	return this->data;
 }
-template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>* Trie<Key,T,Container,Allocator>::iterator::operator->(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::pair<const std::vector<Key>&, T&>* Trie<Key,T,Container,Allocator,Counted,Score>::iterator::operator->(){
 	return &this->data;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator& Trie<Key,T,Container,Allocator>::iterator::operator++(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator& Trie<Key,T,Container,Allocator,Counted,Score>::iterator::operator++(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::iterator::operator++(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::iterator::operator++(int){
 	iterator pit(this->current);
 	this->next_element();
 	return pit;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator& Trie<Key,T,Container,Allocator>::iterator::operator--(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator& Trie<Key,T,Container,Allocator,Counted,Score>::iterator::operator--(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::iterator::operator--(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::iterator::operator--(int){
 	iterator pit(this->current);
 	this->previous_element();
 	return pit;
 }
 // Constant Iterator
-template <class Key, class T, class Container, class Allocator> const std::pair<const std::vector<Key>&, const T&>& Trie<Key,T,Container,Allocator>::const_iterator::operator*() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> const std::pair<const std::vector<Key>&, const T&>& Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator::operator*() const{
 	return this->data;
 }
-template <class Key, class T, class Container, class Allocator> const std::pair<const std::vector<Key>&, const T&>* Trie<Key,T,Container,Allocator>::const_iterator::operator->() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> const std::pair<const std::vector<Key>&, const T&>* Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator::operator->() const{
 	return (const std::pair<const std::vector<Key>&, const T&>*)&this->data;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_iterator& Trie<Key,T,Container,Allocator>::const_iterator::operator++(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator& Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator::operator++(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_iterator Trie<Key,T,Container,Allocator>::const_iterator::operator++(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator::operator++(int){
 	const_iterator pit(this->current);
 	this->next_element();
 	return pit;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_iterator& Trie<Key,T,Container,Allocator>::const_iterator::operator--(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator& Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator::operator--(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_iterator Trie<Key,T,Container,Allocator>::const_iterator::operator--(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator::operator--(int){
 	const_iterator pit(this->current);
 	this->previous_element();
 	return pit;
 }
 // Reverse Iterator
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::reverse_iterator::base() const{ return iterator(*this); }
-template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>& Trie<Key,T,Container,Allocator>::reverse_iterator::operator*(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator::base() const{ return iterator(*this); }
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::pair<const std::vector<Key>&, T&>& Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator::operator*(){
 	return this->data;
 }
-template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&>* Trie<Key,T,Container,Allocator>::reverse_iterator::operator->(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::pair<const std::vector<Key>&, T&>* Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator::operator->(){
 	return &this->data;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::reverse_iterator& Trie<Key,T,Container,Allocator>::reverse_iterator::operator++(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator& Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator::operator++(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::reverse_iterator Trie<Key,T,Container,Allocator>::reverse_iterator::operator++(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator::operator++(int){
 	reverse_iterator pit(this->current);
 	this->previous_element();
 	return pit;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::reverse_iterator& Trie<Key,T,Container,Allocator>::reverse_iterator::operator--(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator& Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator::operator--(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::reverse_iterator Trie<Key,T,Container,Allocator>::reverse_iterator::operator--(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator::operator--(int){
 	reverse_iterator pit(this->current);
 	this->next_element();
 	return pit;
 }
 // Constant Reverse Iterator
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_iterator Trie<Key,T,Container,Allocator>::const_reverse_iterator::base() const{ return const_iterator(*this); }
-template <class Key, class T, class Container, class Allocator> const std::pair<const std::vector<Key>&, const T&>& Trie<Key,T,Container,Allocator>::const_reverse_iterator::operator*() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator::base() const{ return const_iterator(*this); }
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> const std::pair<const std::vector<Key>&, const T&>& Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator::operator*() const{
 	return this->data;
 }
-template <class Key, class T, class Container, class Allocator> const std::pair<const std::vector<Key>&, const T&>* Trie<Key,T,Container,Allocator>::const_reverse_iterator::operator->() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> const std::pair<const std::vector<Key>&, const T&>* Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator::operator->() const{
 	return (const std::pair<const std::vector<Key>&, const T&>*)&this->data;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_reverse_iterator& Trie<Key,T,Container,Allocator>::const_reverse_iterator::operator++(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator& Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator::operator++(){
 	this->previous_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_reverse_iterator Trie<Key,T,Container,Allocator>::const_reverse_iterator::operator++(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator::operator++(int){
 	const_reverse_iterator pit(this->current);
 	this->previous_element();
 	return pit;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_reverse_iterator& Trie<Key,T,Container,Allocator>::const_reverse_iterator::operator--(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator& Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator::operator--(){
 	this->next_element();
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_reverse_iterator Trie<Key,T,Container,Allocator>::const_reverse_iterator::operator--(int){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator::operator--(int){
 	const_reverse_iterator pit(this->current);
 	this->next_element();
 	return pit;
 }
 
 // Iterator generation methods
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::begin() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::begin() const{
 	NodeTrie* tmp = 0;
 	iterator result;
 	if(this->counter){
@@ -222,7 +232,7 @@ template <class Key, class T, class Container, class Allocator> Trie<Key,T,Conta
 	result.update(tmp);
 	return result;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_iterator Trie<Key,T,Container,Allocator>::cbegin() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator Trie<Key,T,Container,Allocator,Counted,Score>::cbegin() const{
 	NodeTrie* tmp = 0;
 	const_iterator result;
 	if(this->counter){
@@ -235,13 +245,13 @@ template <class Key, class T, class Container, class Allocator> Trie<Key,T,Conta
 	result.update(tmp);
 	return result;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::end() const noexcept{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::end() const noexcept{
 	return iterator();
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_iterator Trie<Key,T,Container,Allocator>::cend() const noexcept{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_iterator Trie<Key,T,Container,Allocator,Counted,Score>::cend() const noexcept{
 	return const_iterator();
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::reverse_iterator Trie<Key,T,Container,Allocator>::rbegin() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::rbegin() const{
 	NodeTrie* tmp = 0;
 	reverse_iterator result;
 	if(this->counter){
@@ -254,7 +264,7 @@ template <class Key, class T, class Container, class Allocator> Trie<Key,T,Conta
 	result.update(tmp);
 	return result;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_reverse_iterator Trie<Key,T,Container,Allocator>::crbegin() const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::crbegin() const{
 	NodeTrie* tmp = 0;
 	const_reverse_iterator result;
 	if(this->counter){
@@ -267,95 +277,118 @@ template <class Key, class T, class Container, class Allocator> Trie<Key,T,Conta
 	result.update(tmp);
 	return result;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::reverse_iterator Trie<Key,T,Container,Allocator>::rend() const noexcept{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::rend() const noexcept{
 	return reverse_iterator();
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::const_reverse_iterator Trie<Key,T,Container,Allocator>::crend() const noexcept{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::const_reverse_iterator Trie<Key,T,Container,Allocator,Counted,Score>::crend() const noexcept{
 	return const_reverse_iterator();
 }
 
 // Capacity
-template <class Key, class T, class Container, class Allocator> bool Trie<Key,T,Container,Allocator>::empty() const noexcept{
-	return this->counter != 0;
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> bool Trie<Key,T,Container,Allocator,Counted,Score>::empty() const noexcept{
+	return this->counter == 0;
 }
-template <class Key, class T, class Container, class Allocator> std::size_t Trie<Key,T,Container,Allocator>::size() const noexcept{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::size() const noexcept{
 	return this->counter;
 }
-template <class Key, class T, class Container, class Allocator> std::size_t Trie<Key,T,Container,Allocator>::memory() const noexcept{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::memory() const noexcept{
 	return this->nCounter * (sizeof(typename Container::node_type) + sizeof(NodeTrie)) + sizeof(Trie);
 }
 
 // Modifiers
 // Clear
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::clear() noexcept{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::clear() noexcept{
 	for(auto it = this->data.children.begin(); it != this->data.children.end(); ++it){
 		NodeTrie::destroy(this->alloc, (NodeTrie*) it->second);
 	}
 	this->data.children.clear();
+	this->data.valid = false;
+	this->data.count = {};
+	if constexpr(scored){ this->data.best = Score::identity(); }
 	this->counter = 0;
 	this->nCounter = 0;
 }
 // Inserts
-template <class Key, class T, class Container, class Allocator> template <class Vector> std::pair<typename Trie<Key,T,Container,Allocator>::iterator, bool> Trie<Key,T,Container,Allocator>::insert(const std::pair<Vector, T>& value){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, bool> Trie<Key,T,Container,Allocator,Counted,Score>::insert(const std::pair<Vector, T>& value){
 	std::size_t pcounter = this->counter, size = len_array(value.first);
 	NodeTrie* tmp = this->get_forward(value.first, size);
-	if(pcounter != this->counter){ tmp->data.second = value.second; }
+	if(pcounter != this->counter){
+		tmp->data.second = value.second;
+		this->rescore(tmp);
+	}
 	return std::pair<iterator, bool>(iterator(tmp,size), pcounter != this->counter);
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector> std::pair<typename Trie<Key,T,Container,Allocator>::iterator, bool> Trie<Key,T,Container,Allocator>::insert(std::pair<Vector, T>&& value){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, bool> Trie<Key,T,Container,Allocator,Counted,Score>::insert(std::pair<Vector, T>&& value){
 	std::size_t pcounter = this->counter, size = len_array(value.first);
 	NodeTrie* tmp = this->get_forward(std::move(value.first), size);
-	if(pcounter != this->counter){ tmp->data.second = std::move(value.second); }
+	if(pcounter != this->counter){
+		tmp->data.second = std::move(value.second);
+		this->rescore(tmp);
+	}
 	return std::pair<iterator, bool>(iterator(tmp,size), pcounter != this->counter);
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::insert(iterator hint, const std::pair<Vector, T>& value){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::insert(iterator hint, const std::pair<Vector, T>& value){
 	NodeTrie* tmp = hint.current;
 	std::size_t pcounter = this->counter, size_input = len_array(value.first), size_hint = len_array(hint.key), equal = 0, size;
 	size = size_input <= size_hint ? size_input : size_hint;
 	while(equal < size && hint.key[equal]==value.first[equal]){ ++equal; }
 	for(std::size_t i = equal; i < size_hint; ++i){ tmp = tmp->parent; }
 	tmp = this->get_forward(value.first, size_input, tmp, equal);
-	if(pcounter != this->counter){ tmp->data.second = value.second; }
+	if(pcounter != this->counter){
+		tmp->data.second = value.second;
+		this->rescore(tmp);
+	}
 	return iterator(tmp,size);
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::insert(iterator hint, std::pair<Vector, T>&& value){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::insert(iterator hint, std::pair<Vector, T>&& value){
 	NodeTrie* tmp = hint.current;
 	std::size_t pcounter = this->counter, size_input = len_array(value.first), size_hint = len_array(hint.key), equal = 0, size;
 	size = size_input <= size_hint ? size_input : size_hint;
 	while(equal < size && hint.key[equal]==value.first[equal]){ ++equal; }
 	for(std::size_t i = equal; i < size_hint; ++i){ tmp = tmp->parent; }
 	tmp = this->get_forward(std::move(value.first), size_input, tmp, equal);
-	if(pcounter != this->counter){ tmp->data.second = std::move(value.second); }
+	if(pcounter != this->counter){
+		tmp->data.second = std::move(value.second);
+		this->rescore(tmp);
+	}
 	return iterator(tmp,size);
 }
-template <class Key, class T, class Container, class Allocator> template <class InputIt> void Trie<Key,T,Container,Allocator>::insert(InputIt first, InputIt last){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class InputIt> void Trie<Key,T,Container,Allocator,Counted,Score>::insert(InputIt first, InputIt last){
 	for(auto it = first; it != last; ++it){
 		std::size_t pcounter = this->counter, size = len_array(it->first);
 		NodeTrie* tmp = this->get_forward(it->first, size);
-		if(pcounter != this->counter){ tmp->data.second = it->second; }
+		if(pcounter != this->counter){
+			tmp->data.second = it->second;
+			this->rescore(tmp);
+		}
 	}
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector> void Trie<Key,T,Container,Allocator>::insert(std::initializer_list<std::pair<Vector, T>> ilist){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> void Trie<Key,T,Container,Allocator,Counted,Score>::insert(std::initializer_list<std::pair<Vector, T>> ilist){
 	for(auto it : ilist){
 		std::size_t pcounter = this->counter, size = len_array(it.first);
 		NodeTrie* tmp = this->get_forward(it.first, size);
-		if(pcounter != this->counter){ tmp->data.second = it.second; }
+		if(pcounter != this->counter){
+			tmp->data.second = it.second;
+			this->rescore(tmp);
+		}
 	}
 }
 // Insert or Assign
-template <class Key, class T, class Container, class Allocator> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator>::iterator, bool> Trie<Key,T,Container,Allocator>::insert_or_assign(const Vector& k, M&& obj){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, bool> Trie<Key,T,Container,Allocator,Counted,Score>::insert_or_assign(const Vector& k, M&& obj){
 	std::size_t pcounter = this->counter, size = len_array(k);
 	NodeTrie* tmp = this->get_forward(k, size);
 	tmp->data.second = std::move(obj);
+	this->rescore(tmp);
 	return std::pair<iterator, bool>(iterator(tmp,size), pcounter != this->counter);
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator>::iterator, bool> Trie<Key,T,Container,Allocator>::insert_or_assign(Vector&& k, M&& obj){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, bool> Trie<Key,T,Container,Allocator,Counted,Score>::insert_or_assign(Vector&& k, M&& obj){
 	std::size_t pcounter = this->counter, size = len_array(k);
 	NodeTrie* tmp = this->get_forward(std::move(k), size);
 	tmp->data.second = std::move(obj);
+	this->rescore(tmp);
 	return std::pair<iterator, bool>(iterator(tmp,size), pcounter != this->counter);
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator>::iterator, bool> Trie<Key,T,Container,Allocator>::insert_or_assign(iterator hint, const Vector& k, M&& obj){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, bool> Trie<Key,T,Container,Allocator,Counted,Score>::insert_or_assign(iterator hint, const Vector& k, M&& obj){
 	NodeTrie* tmp = hint.current;
 	std::size_t pcounter = this->counter, size_input = len_array(k), size_hint = len_array(hint.key), equal = 0, size;
 	size = size_input <= size_hint ? size_input : size_hint;
@@ -363,9 +396,10 @@ template <class Key, class T, class Container, class Allocator> template <class
 	for(std::size_t i = equal; i < size_hint; ++i){ tmp = tmp->parent; }
 	tmp = this->get_forward(k, size_input, tmp, equal);
 	tmp->data.second = std::move(obj);
+	this->rescore(tmp);
 	return std::pair<iterator, bool>(iterator(tmp,size), pcounter != this->counter);
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator>::iterator, bool> Trie<Key,T,Container,Allocator>::insert_or_assign(iterator hint, Vector&& k, M&& obj){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector, class M> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, bool> Trie<Key,T,Container,Allocator,Counted,Score>::insert_or_assign(iterator hint, Vector&& k, M&& obj){
 	NodeTrie* tmp = hint.current;
 	std::size_t pcounter = this->counter, size_input = len_array(k), size_hint = len_array(hint.key), equal = 0, size;
 	size = size_input <= size_hint ? size_input : size_hint;
@@ -373,16 +407,17 @@ template <class Key, class T, class Container, class Allocator> template <class
 	for(std::size_t i = equal; i < size_hint; ++i){ tmp = tmp->parent; }
 	tmp = this->get_forward(std::move(k), size_input, tmp, equal);
 	tmp->data.second = std::move(obj);
+	this->rescore(tmp);
 	return std::pair<iterator, bool>(iterator(tmp,size), pcounter != this->counter);
 }
 // Erase
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::erase(iterator pos){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::erase(iterator pos){
 	NodeTrie* ptr = pos.current;
 	++pos;
 	this->remove_node(ptr);
 	return pos;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::erase(iterator first, iterator last){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::erase(iterator first, iterator last){
 	while(first != last){
 		NodeTrie* ptr = first.current;
 		++first;
@@ -390,13 +425,13 @@ template <class Key, class T, class Container, class Allocator> Trie<Key,T,Conta
 	}
 	return first;
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector> std::size_t Trie<Key,T,Container,Allocator>::erase(const Vector& key){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::erase(const Vector& key){
 	NodeTrie* tmp = this->find_node(key, len_array(key));
 	std::size_t result = (tmp && tmp->valid);
 	this->remove_node(tmp);
 	return result;
 }
-template <class Key, class T, class Container, class Allocator> template <class Vector> std::size_t Trie<Key,T,Container,Allocator>::erase(Vector&& key){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class Vector> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::erase(Vector&& key){
 	NodeTrie* tmp = this->find_node(key, len_array(key));
 	std::size_t result = (tmp && tmp->valid);
 	this->remove_node(tmp);
@@ -405,23 +440,23 @@ template <class Key, class T, class Container, class Allocator> template <class
 
 // Lookup
 // Count
-template <class Key, class T, class Container, class Allocator> template <class K> std::size_t Trie<Key,T,Container,Allocator>::count(const K& key) const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::count(const K& key) const{
 	NodeTrie* tmp = this->find_node(key, len_array(key));
 	return tmp && tmp->valid;
 }
 // Find
-template <class Key, class T, class Container, class Allocator> template <class K> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::find(const K& key){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::find(const K& key){
 	std::size_t size = len_array(key);
 	NodeTrie* tmp = this->find_node(key, size);
 	return (tmp && tmp->valid) ? iterator(tmp, size) : this->end();
 }
 // Contains
-template <class Key, class T, class Container, class Allocator> template <class K> bool Trie<Key,T,Container,Allocator>::contains(const K& key) const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> bool Trie<Key,T,Container,Allocator,Counted,Score>::contains(const K& key) const{
 	NodeTrie* tmp = this->find_node(key, len_array(key));
 	return tmp && tmp->valid;
 }
 // Bounds
-template <class Key, class T, class Container, class Allocator> template <class K> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::lower_bound(const K& key){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::lower_bound(const K& key){
 	NodeTrie *ptr = root;
 	std::size_t size = len_array(key), i=0;
 	while(i < size){
@@ -449,7 +484,7 @@ template <class Key, class T, class Container, class Allocator> template <class
 	}
 	return (ptr && ptr->valid) ? iterator(ptr, i) : this->end();
 }
-template <class Key, class T, class Container, class Allocator> template <class K> Trie<Key,T,Container,Allocator>::iterator Trie<Key,T,Container,Allocator>::upper_bound(const K& key){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::upper_bound(const K& key){
 	NodeTrie *ptr = root;
 	std::size_t size = len_array(key), i=0;
 	bool search = false;
@@ -481,15 +516,121 @@ template <class Key, class T, class Container, class Allocator> template <class
 	}
 	return (ptr && ptr->valid) ? iterator(ptr, i) : this->end();
 }
-template <class Key, class T, class Container, class Allocator> template <class K> std::pair<typename Trie<Key,T,Container,Allocator>::iterator, typename Trie<Key,T,Container,Allocator>::iterator> Trie<Key,T,Container,Allocator>::equal_range(const K& key){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator> Trie<Key,T,Container,Allocator,Counted,Score>::equal_range(const K& key){
 	return std::pair<iterator,iterator>(this->lower_bound(key), this->upper_bound(key));
 }
+// Prefixes
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> Trie<Key,T,Container,Allocator,Counted,Score>::iterator Trie<Key,T,Container,Allocator,Counted,Score>::longest_prefix_match(const K& key){
+	NodeTrie* tmp = 0;
+	std::size_t size = 0;
+	this->prefix_nodes(key, len_array(key), [&tmp, &size](NodeTrie* ptr, std::size_t length){
+		tmp = ptr;
+		size = length;
+	});
+	return tmp ? iterator(tmp, size) : this->end();
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> std::vector<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator> Trie<Key,T,Container,Allocator,Counted,Score>::all_prefixes_of(const K& key){
+	std::vector<iterator> result;
+	this->prefix_nodes(key, len_array(key), [&result](NodeTrie* ptr, std::size_t length){
+		result.push_back(iterator(ptr, length));
+	});
+	return result;
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> std::pair<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator, typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator> Trie<Key,T,Container,Allocator,Counted,Score>::prefix_range(const K& prefix){
+	// Every node below the root holds an element or has one below it, so the range goes from the first element below the node of prefix to the first one below its next sibling or that of an ancestor
+	std::size_t size = len_array(prefix);
+	NodeTrie *ptr = this->find_node(prefix, size), *tmp;
+	if(!ptr || !this->counter){ return std::pair<iterator,iterator>(this->end(), this->end()); }
+	iterator first(ptr, size);
+	for(tmp = ptr; !tmp->valid; ){
+		tmp = (NodeTrie*) tmp->children.begin()->second;
+		first.key.push_back(tmp->data.first);
+	}
+	first.update(tmp);
+	for(tmp = ptr; tmp->parent; tmp = tmp->parent, --size){
+		typename Container::iterator it = ++(tmp->parent->children.find(tmp->data.first));
+		if(it != tmp->parent->children.end()){
+			tmp = (NodeTrie*) it->second;
+			break;
+		}
+	}
+	if(!tmp->parent){ return std::pair<iterator,iterator>(first, this->end()); }
+	iterator last(tmp, size);
+	while(!tmp->valid){
+		tmp = (NodeTrie*) tmp->children.begin()->second;
+		last.key.push_back(tmp->data.first);
+	}
+	last.update(tmp);
+	return std::pair<iterator,iterator>(first, last);
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::count_prefix(const K& prefix) const{
+	NodeTrie* ptr = this->find_node(prefix, len_array(prefix));
+	if(!ptr){ return 0; }
+	if constexpr(Counted){
+		return ptr->count;
+	}else{
+		std::size_t result = 0;
+		std::vector<NodeTrie*> pending(1, ptr);
+		while(pending.size()){
+			NodeTrie* tmp = pending.back();
+			pending.pop_back();
+			result += tmp->valid;
+			for(auto it = tmp->children.begin(); it != tmp->children.end(); ++it){
+				pending.push_back((NodeTrie*) it->second);
+			}
+		}
+		return result;
+	}
+}
+
+// Scores
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template <class K> std::vector<typename Trie<Key,T,Container,Allocator,Counted,Score>::iterator> Trie<Key,T,Container,Allocator,Counted,Score>::top_k(const K& prefix, std::size_t k) requires scored{
+	// The highest score of a subtree bounds those of its elements, so the elements leave the heap in decreasing order of score and a subtree is only opened if its bound is not lower than the elements still missing
+	struct Entry{
+		score_type score;
+		NodeTrie* node;
+		std::size_t size;
+		bool element;
+	};
+	auto lower = [](const Entry& lhs, const Entry& rhs){ return lhs.score < rhs.score; };
+	std::vector<iterator> result;
+	std::vector<Entry> heap;
+	std::size_t size = len_array(prefix);
+	NodeTrie* ptr = this->find_node(prefix, size);
+	if(ptr && k){ heap.push_back(Entry{ptr->best, ptr, size, false}); }
+	while(heap.size()){
+		std::pop_heap(heap.begin(), heap.end(), lower);
+		Entry tmp = heap.back();
+		heap.pop_back();
+		if(tmp.element){
+			result.push_back(iterator(tmp.node, tmp.size));
+			if(result.size() == k){ break; }
+			continue;
+		}
+		if(tmp.node->valid){
+			heap.push_back(Entry{Score::lift(tmp.node->data), tmp.node, tmp.size, true});
+			std::push_heap(heap.begin(), heap.end(), lower);
+		}
+		for(auto it = tmp.node->children.begin(); it != tmp.node->children.end(); ++it){
+			NodeTrie* child = (NodeTrie*) it->second;
+			heap.push_back(Entry{child->best, child, tmp.size + 1, false});
+			std::push_heap(heap.begin(), heap.end(), lower);
+		}
+	}
+	return result;
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::refresh(iterator pos) requires scored{
+	this->rescore(pos.current);
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::refresh(const_iterator pos) requires scored{
+	this->rescore(pos.current);
+}
 
 // Non-member functions
 // Operators
-template<class A,class B,class C,class D> bool operator==(const Trie<A,B,C,D>& lhs, const Trie<A,B,C,D>& rhs){
+template<class A,class B,class C,class D,bool E,class F> bool operator==(const Trie<A,B,C,D,E,F>& lhs, const Trie<A,B,C,D,E,F>& rhs){
 	if((lhs.counter != rhs.counter) || (lhs.nCounter != rhs.nCounter) || (lhs.data.valid != rhs.data.valid) || (lhs.data.valid && (lhs.data.data.second != rhs.data.data.second))){ return false; }
-	typename Trie<A,B,C,D>::NodeTrie *lPtr = lhs.root, *rPtr = rhs.root;
+	typename Trie<A,B,C,D,E,F>::NodeTrie *lPtr = lhs.root, *rPtr = rhs.root;
 	typename C::iterator lit, rit;
 	goto descend_to_first_leaf;
 	while(lPtr->parent){
@@ -499,21 +640,21 @@ template<class A,class B,class C,class D> bool operator==(const Trie<A,B,C,D>& l
 			rPtr = rPtr->parent;
 		}else{
 			rit = rPtr->parent->children.upper_bound(rPtr->data.first);
-			lPtr = (typename Trie<A,B,C,D>::NodeTrie*) lit->second;
-			rPtr = (typename Trie<A,B,C,D>::NodeTrie*) rit->second;
+			lPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) lit->second;
+			rPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) rit->second;
 			if((lPtr->data.first!=rPtr->data.first) || (lPtr->valid!=rPtr->valid) || (lPtr->valid && (lPtr->data.second != rPtr->data.second)) ||  (lPtr->children.size() != rPtr->children.size())){ return false; }
 			descend_to_first_leaf:
 			while(lPtr->children.size() && rPtr->children.size()){
-				lPtr = (typename Trie<A,B,C,D>::NodeTrie*) lPtr->children.begin()->second;
-				rPtr = (typename Trie<A,B,C,D>::NodeTrie*) rPtr->children.begin()->second;
+				lPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) lPtr->children.begin()->second;
+				rPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) rPtr->children.begin()->second;
 				if((lPtr->data.first!=rPtr->data.first) || (lPtr->valid!=rPtr->valid) || (lPtr->valid && (lPtr->data.second != rPtr->data.second)) ||  (lPtr->children.size() != rPtr->children.size())){ return false; }
 			}
 		}
 	}
 	return true;
 }
-template<class A,class B,class C,class D> std::strong_ordering operator<=>(const Trie<A,B,C,D>& lhs, const Trie<A,B,C,D>& rhs){
-	typename Trie<A,B,C,D>::NodeTrie *lPtr = lhs.root, *rPtr = rhs.root;
+template<class A,class B,class C,class D,bool E,class F> std::strong_ordering operator<=>(const Trie<A,B,C,D,E,F>& lhs, const Trie<A,B,C,D,E,F>& rhs){
+	typename Trie<A,B,C,D,E,F>::NodeTrie *lPtr = lhs.root, *rPtr = rhs.root;
 	typename C::iterator lit, rit;
 	bool lend, rend;
 	if(lPtr->valid != rPtr->valid){
@@ -534,8 +675,8 @@ template<class A,class B,class C,class D> std::strong_ordering operator<=>(const
 			lPtr = lPtr->parent;
 			rPtr = rPtr->parent;
 		}else{
-			lPtr = (typename Trie<A,B,C,D>::NodeTrie*) lit->second;
-			rPtr = (typename Trie<A,B,C,D>::NodeTrie*) rit->second;
+			lPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) lit->second;
+			rPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) rit->second;
 			if(lPtr->valid!=rPtr->valid){
 				return lPtr->valid ? std::strong_ordering::less : std::strong_ordering::greater;
 			}else if(lPtr->data.first != rPtr->data.first){
@@ -545,8 +686,8 @@ template<class A,class B,class C,class D> std::strong_ordering operator<=>(const
 			}
 			descend_to_first_leaf:
 			while(lPtr->children.size() && rPtr->children.size()){
-				lPtr = (typename Trie<A,B,C,D>::NodeTrie*) lPtr->children.begin()->second;
-				rPtr = (typename Trie<A,B,C,D>::NodeTrie*) rPtr->children.begin()->second;
+				lPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) lPtr->children.begin()->second;
+				rPtr = (typename Trie<A,B,C,D,E,F>::NodeTrie*) rPtr->children.begin()->second;
 				if(lPtr->valid!=rPtr->valid){
 					return lPtr->valid ? std::strong_ordering::less : std::strong_ordering::greater;
 				}else if(lPtr->data.first != rPtr->data.first){
@@ -564,39 +705,53 @@ template<class A,class B,class C,class D> std::strong_ordering operator<=>(const
 }
 
 // Nested class NodeTrie
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::NodeTrie::NodeTrie(NodeTrie* parent) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie::NodeTrie(NodeTrie* parent) :
 	parent(parent),
-	valid(false){ }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::NodeTrie::NodeTrie(const Key& key, NodeTrie* parent) :
+	valid(false),
+	count(){
+	if constexpr(scored){ this->best = Score::identity(); }
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie::NodeTrie(const Key& key, NodeTrie* parent) :
 	parent(parent),
-	valid(false){
+	valid(false),
+	count(){
+	if constexpr(scored){ this->best = Score::identity(); }
 	this->data.first = key;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::NodeTrie::NodeTrie(Key&& key, NodeTrie* parent) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie::NodeTrie(Key&& key, NodeTrie* parent) :
 	parent(parent),
-	valid(false){
+	valid(false),
+	count(){
+	if constexpr(scored){ this->best = Score::identity(); }
 	this->data.first = std::move(key);
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::NodeTrie::~NodeTrie(){}
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::NodeTrie::copy(AllocatorNodes& alloc, NodeTrie* src, NodeTrie* dst){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie::~NodeTrie(){}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie::copy(AllocatorNodes& alloc, NodeTrie* src, NodeTrie* dst){
 	NodeTrie* ptrSrc = src;
 	NodeTrie* ptrDst = dst;
 	typename Container::key_compare cmp;
 	bool up = false;
 	while(ptrSrc){
-		typename Container::iterator mit = ptrDst->children.begin(), mite = ptrDst->children.end(), oit = ptrSrc->children.begin(), oite = ptrSrc->children.end();
+		typename Container::iterator mit = ptrDst->children.begin(), oit = ptrSrc->children.begin(), oite = ptrSrc->children.end();
 		ptrDst->valid = ptrSrc->valid;
+		ptrDst->count = ptrSrc->count;
+		ptrDst->best = ptrSrc->best;
 		ptrDst->data.second = ptrSrc->data.second;
 		if(!up){
-			while(mit != mite){
+			// Containers may move their elements on insertion, so the position in the destination is searched again afterwards
+			while(mit != ptrDst->children.end()){
 				if(oit == oite || cmp(mit->first, oit->first)){
 					NodeTrie* tmp = (NodeTrie*) mit->second;
 					mit = ptrDst->children.erase(mit);
 					NodeTrie::destroy(alloc, tmp);
-				}else if(mit->first != oit->first){
+				}else if(cmp(oit->first, mit->first)){
 					NodeTrie** tmp = (NodeTrie**)&(ptrDst->children[oit->first]);
 					*tmp = alloc.allocate(1);
 					std::construct_at(*tmp, oit->first, ptrDst);
+					mit = ptrDst->children.upper_bound(oit->first);
+					++oit;
+				}else{
+					++mit;
 					++oit;
 				}
 			}
@@ -627,7 +782,7 @@ template <class Key, class T, class Container, class Allocator> void Trie<Key,T,
 		}
 	}
 }
-template <class Key, class T, class Container, class Allocator> std::size_t Trie<Key,T,Container,Allocator>::NodeTrie::destroy(AllocatorNodes& alloc, NodeTrie* ptr){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie::destroy(AllocatorNodes& alloc, NodeTrie* ptr){
 	NodeTrie *tail;
 	std::size_t result = 0;
 	ptr->next = 0;
@@ -649,7 +804,7 @@ template <class Key, class T, class Container, class Allocator> std::size_t Trie
 }
 
 // Private members
-template <class Key, class T, class Container, class Allocator> template<class Vector> Trie<Key,T,Container,Allocator>::NodeTrie* Trie<Key,T,Container,Allocator>::get_forward(const Vector& key, std::size_t size){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie* Trie<Key,T,Container,Allocator,Counted,Score>::get_forward(const Vector& key, std::size_t size){
 	NodeTrie *ptr = root;
 	std::size_t newNodes = 0;
 	for(std::size_t i=0; i<size; ++i){
@@ -664,11 +819,12 @@ template <class Key, class T, class Container, class Allocator> template<class V
 	if(!ptr->valid){
 		ptr->valid = true;
 		++this->counter;
+		this->recount(ptr, true);
 		this->nCounter += newNodes;
 	}
 	return ptr;
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> Trie<Key,T,Container,Allocator>::NodeTrie* Trie<Key,T,Container,Allocator>::get_forward(Vector&& key, std::size_t size){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie* Trie<Key,T,Container,Allocator,Counted,Score>::get_forward(Vector&& key, std::size_t size){
 	NodeTrie *ptr = root;
 	std::size_t newNodes = 0;
 	for(std::size_t i=0; i<size; ++i){
@@ -683,11 +839,12 @@ template <class Key, class T, class Container, class Allocator> template<class V
 	if(!ptr->valid){
 		ptr->valid = true;
 		++this->counter;
+		this->recount(ptr, true);
 		this->nCounter += newNodes;
 	}
 	return ptr;
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> Trie<Key,T,Container,Allocator>::NodeTrie* Trie<Key,T,Container,Allocator>::get_forward(const Vector& key, std::size_t size, NodeTrie* hint, std::size_t idx){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie* Trie<Key,T,Container,Allocator,Counted,Score>::get_forward(const Vector& key, std::size_t size, NodeTrie* hint, std::size_t idx){
 	NodeTrie *ptr = hint;
 	std::size_t newNodes = 0;
 	for(std::size_t i=idx; i<size; ++i){
@@ -702,11 +859,12 @@ template <class Key, class T, class Container, class Allocator> template<class V
 	if(!ptr->valid){
 		ptr->valid = true;
 		++this->counter;
+		this->recount(ptr, true);
 		this->nCounter += newNodes;
 	}
 	return ptr;
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> Trie<Key,T,Container,Allocator>::NodeTrie* Trie<Key,T,Container,Allocator>::get_forward(Vector&& key, std::size_t size, NodeTrie* hint, std::size_t idx){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie* Trie<Key,T,Container,Allocator,Counted,Score>::get_forward(Vector&& key, std::size_t size, NodeTrie* hint, std::size_t idx){
 	NodeTrie *ptr = hint;
 	std::size_t newNodes = 0;
 	for(std::size_t i=idx; i<size; ++i){
@@ -721,11 +879,12 @@ template <class Key, class T, class Container, class Allocator> template<class V
 	if(!ptr->valid){
 		ptr->valid = true;
 		++this->counter;
+		this->recount(ptr, true);
 		this->nCounter += newNodes;
 	}
 	return ptr;
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> inline Trie<Key,T,Container,Allocator>::NodeTrie* Trie<Key,T,Container,Allocator>::find_node(Vector key, std::size_t size) const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> inline Trie<Key,T,Container,Allocator,Counted,Score>::NodeTrie* Trie<Key,T,Container,Allocator,Counted,Score>::find_node(const Vector& key, std::size_t size) const{
 	NodeTrie* ptr = root;
 	for(std::size_t i=0; i<size; ++i){
 		typename Container::iterator it = ptr->children.find(key[i]);
@@ -734,41 +893,97 @@ template <class Key, class T, class Container, class Allocator> template<class V
 	}
 	return ptr;
 }
-template <class Key, class T, class Container, class Allocator> template<class Vector> std::size_t Trie<Key,T,Container,Allocator>::len_array(const Vector& vec) const{ return vec.size(); }
-template <class Key, class T, class Container, class Allocator> std::size_t Trie<Key,T,Container,Allocator>::len_array(const Key* array) const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector, class Function> inline void Trie<Key,T,Container,Allocator,Counted,Score>::prefix_nodes(const Vector& key, std::size_t size, Function visit) const{
+	// Descends as find_node() does, calling visit with every valid node on the path and the length of its key
+	NodeTrie* ptr = root;
+	for(std::size_t i=0; ; ++i){
+		if(ptr->valid){ visit(ptr, i); }
+		if(i == size){ return; }
+		typename Container::iterator it = ptr->children.find(key[i]);
+		if(it == ptr->children.end()){ return; }
+		ptr = (NodeTrie*)it->second;
+	}
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> template<class Vector> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::len_array(const Vector& vec) const{ return vec.size(); }
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::size_t Trie<Key,T,Container,Allocator,Counted,Score>::len_array(const Key* array) const{
 	std::size_t count = 0;
 	while(array[count]){ ++count; }
 	return count;
 }
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::remove_node(NodeTrie* ptr){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::remove_node(NodeTrie* ptr){
 	if(!ptr){ return; }
 	if(ptr->valid){
 		ptr->valid = false;
 		--this->counter;
+		this->recount(ptr, false);
 	}
-	if(!ptr->children.size()){
-		while(ptr->parent && ptr->parent->children.size()==1 && (!ptr->parent->valid)){
+	// The root is embedded in the container and is never removed, so the climb stops below it
+	if(!ptr->children.size() && ptr != this->root){
+		while(ptr->parent && ptr->parent != this->root && ptr->parent->children.size()==1 && (!ptr->parent->valid)){
 			ptr = ptr->parent;
 		}
-		if(ptr->parent){
-			ptr->parent->children.erase(ptr->data.first);
+		NodeTrie* parent = ptr->parent;
+		if(parent){
+			parent->children.erase(ptr->data.first);
 		}
 		this->nCounter -= NodeTrie::destroy(this->alloc, ptr);
+		ptr = parent;
+	}
+	this->rescore(ptr);
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::recount(NodeTrie* ptr, bool inserted){
+	// Updates the number of elements in the subtrees of ptr and its ancestors
+	if constexpr(Counted){
+		for(; ptr; ptr = ptr->parent){
+			inserted ? ++ptr->count : --ptr->count;
+		}
+	}
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::rescore(NodeTrie* ptr){
+	// Recalculates the highest scores from ptr up to the root, the ones above a node whose score does not change are kept (scores are only ordered by operator<, so unchanged means equivalent)
+	if constexpr(scored){
+		for(; ptr; ptr = ptr->parent){
+			score_type best = ptr->valid ? Score::lift(ptr->data) : Score::identity();
+			for(auto it = ptr->children.begin(); it != ptr->children.end(); ++it){
+				best = Score::combine(best, ((NodeTrie*) it->second)->best);
+			}
+			if(!(best < ptr->best) && !(ptr->best < best)){ return; }
+			ptr->best = best;
+		}
+	}
+}
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::adopt(Trie& other){
+	// Takes the nodes of other, which now hang from this root, which must have no children
+	this->data.children = std::move(other.data.children);
+	this->data.data.second = std::move(other.data.data.second);
+	this->data.valid = other.data.valid;
+	this->data.count = other.data.count;
+	this->data.best = other.data.best;
+	for(auto it = this->data.children.begin(); it != this->data.children.end(); ++it){
+		((NodeTrie*) it->second)->parent = this->root;
 	}
+	this->counter = other.counter;
+	this->nCounter = other.nCounter;
+	other.data.children.clear();
+	other.data.valid = false;
+	other.data.count = {};
+	if constexpr(scored){ other.data.best = Score::identity(); }
+	other.counter = 0;
+	other.nCounter = 0;
 }
 
 // Iterator actions
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator_actions::iterator_actions() :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::iterator_actions() :
 	data(key, nullvalue_value){ }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator_actions::iterator_actions(const Trie<Key,T,Container,Allocator>::iterator_actions& other) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::iterator_actions(const Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions& other) :
 	data(key, other.data.second),
 	key(other.key),
 	current(other.current){ }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator_actions::iterator_actions(Trie<Key,T,Container,Allocator>::iterator_actions&& other) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::iterator_actions(Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions&& other) :
 	data(key, other.data.second),
 	key(std::move(other.key)),
 	current(other.current){ }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator_actions::iterator_actions(NodeTrie* ptr, std::size_t size) :
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::iterator_actions(NodeTrie* ptr, std::size_t size) :
 	data(key, nullvalue_value){
 	NodeTrie* tmp = ptr;
 	this->key.reserve(size);
@@ -779,21 +994,21 @@ template <class Key, class T, class Container, class Allocator> Trie<Key,T,Conta
 	std::reverse(this->key.begin(),this->key.end());
 	this->update(ptr);
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator_actions& Trie<Key,T,Container,Allocator>::iterator_actions::operator=(const Trie<Key,T,Container,Allocator>::iterator_actions& other){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions& Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::operator=(const Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions& other){
 	*((std::vector<Key>*)&this->data.first) = other.data.first;
 	this->update(other.current);
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> Trie<Key,T,Container,Allocator>::iterator_actions& Trie<Key,T,Container,Allocator>::iterator_actions::operator=(Trie<Key,T,Container,Allocator>::iterator_actions&& other){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions& Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::operator=(Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions&& other){
 	*((std::vector<Key>*)&this->data.first) = std::move(*((std::vector<Key>*)& other.data.first));
 	this->update(other.current);
 	return *this;
 }
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::iterator_actions::update(NodeTrie* ptr){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::update(NodeTrie* ptr){
 	this->current = ptr;
 	std::construct_at(&this->data, this->key, ptr ? ptr->data.second : nullvalue_value);
 }
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::iterator_actions::next_element(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::next_element(){
 	NodeTrie* ptr = this->current;
 	if(ptr){
 		do{
@@ -817,7 +1032,7 @@ template <class Key, class T, class Container, class Allocator> void Trie<Key,T,
 		this->update(ptr);
 	}
 }
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::iterator_actions::previous_element(){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::previous_element(){
 	NodeTrie* ptr = this->current;
 	if(ptr){
 		do{
@@ -844,19 +1059,19 @@ template <class Key, class T, class Container, class Allocator> void Trie<Key,T,
 		this->update(ptr);
 	}
 }
-template <class Key, class T, class Container, class Allocator> bool Trie<Key,T,Container,Allocator>::iterator_actions::operator==(const Trie<Key,T,Container,Allocator>::iterator_actions& other) const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> bool Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::operator==(const Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions& other) const{
 	return this->current == other.current;
 }
-template <class Key, class T, class Container, class Allocator> bool Trie<Key,T,Container,Allocator>::iterator_actions::operator!=(const Trie<Key,T,Container,Allocator>::iterator_actions& other) const{
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> bool Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::operator!=(const Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions& other) const{
 	return this->current != other.current;
 }
 
-template <class Key, class T, class Container, class Allocator> T Trie<Key,T,Container,Allocator>::iterator_actions::nullvalue_value;
-template <class Key, class T, class Container, class Allocator> std::vector<Key> Trie<Key,T,Container,Allocator>::iterator_actions::nullvalue_key;
-template <class Key, class T, class Container, class Allocator> std::pair<const std::vector<Key>&, T&> Trie<Key,T,Container,Allocator>::iterator_actions::nullvalue = std::pair<const std::vector<Key>&, T&>(nullvalue_key, nullvalue_value);
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> T Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::nullvalue_value;
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::vector<Key> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::nullvalue_key;
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> std::pair<const std::vector<Key>&, T&> Trie<Key,T,Container,Allocator,Counted,Score>::iterator_actions::nullvalue = std::pair<const std::vector<Key>&, T&>(nullvalue_key, nullvalue_value);
 
 // Specialized copy/move calls
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::sp_copy(const Trie& other, std::true_type){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::sp_copy(const Trie& other, std::true_type){
 	if(this->alloc != other.alloc){
 		this->clear();
 	}
@@ -865,34 +1080,22 @@ template <class Key, class T, class Container, class Allocator> void Trie<Key,T,
 	this->counter = other.counter;
 	this->nCounter = other.nCounter;
 }
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::sp_copy(const Trie& other, std::false_type){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::sp_copy(const Trie& other, std::false_type){
 	NodeTrie::copy(this->alloc, other.root, this->root);
 	this->counter = other.counter;
 	this->nCounter = other.nCounter;
 }
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::sp_move(Trie&& other, std::true_type) noexcept{
-	if(this->root && this->root!=other.root){ this->clear(); }
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::sp_move(Trie&& other, std::true_type) noexcept{
+	if(this->root == other.root){ return; }
+	this->clear();
 	this->alloc = std::move(other.alloc);
-	this->counter = other.counter;
-	this->nCounter = other.nCounter;
-	this->data.children = std::move(other.data.children);
-	this->data.data.second = std::move(other.data.second);
-	this->data.valid = other.data.valid;
-	other.data.valid = false;
-	other.counter = 0;
-	other.nCounter = 0;
+	this->adopt(other);
 }
-template <class Key, class T, class Container, class Allocator> void Trie<Key,T,Container,Allocator>::sp_move(Trie&& other, std::false_type){
+template <class Key, class T, class Container, class Allocator, bool Counted, class Score> void Trie<Key,T,Container,Allocator,Counted,Score>::sp_move(Trie&& other, std::false_type){
+	if(this->root == other.root){ return; }
 	if(this->alloc == other.alloc){
-		if(this->root && this->root != other.root){ this->clear(); }
-		this->counter = other.counter;
-		this->nCounter = other.nCounter;
-		this->data.children = std::move(other.data.children);
-		this->data.data.second = std::move(other.data.second);
-		this->data.valid = other.data.valid;
-		other.data.valid = false;
-		other.counter = 0;
-		other.nCounter = 0;
+		this->clear();
+		this->adopt(other);
 	}else{
 		NodeTrie::copy(this->alloc, other.root, this->root);
 		this->counter = other.counter;
@@ -903,16 +1106,16 @@ template <class Key, class T, class Container, class Allocator> void Trie<Key,T,
 		}
 		namespace serialize{
 
-template<typename Buff, typename... Types> std::size_t Serialize<Buff,bpp::collections::map::Trie<Types...>>::operator()(Buff& buffer, const bpp::collections::map::Trie<Types...>& obj) const{
-	typename bpp::collections::map::Trie<Types...>::node_type* ptr = obj.root;
-	typename bpp::collections::map::Trie<Types...>::key_type key;
+template<typename Buff, class Key, class T, class Container, class Allocator, bool Counted, class Score> std::size_t Serialize<Buff,bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>>::operator()(Buff& buffer, const bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>& obj) const{
+	typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::node_type* ptr = obj.root;
+	typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::key_type key;
 	std::size_t objs = obj.size();
 	std::size_t res = serialize(buffer, objs);
 	std::size_t new_chars, pos=0;
 	uint8_t encoding;
 	if(!objs){ return res; }
 	while(!ptr->valid){
-		ptr = (typename bpp::collections::map::Trie<Types...>::node_type*) ptr->children.begin()->second;
+		ptr = (typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::node_type*) ptr->children.begin()->second;
 		key.push_back(ptr->data.first);
 	}
 	do{
@@ -922,19 +1125,19 @@ template<typename Buff, typename... Types> std::size_t Serialize<Buff,bpp::colle
 			new_chars >>= 6;
 			res += serialize(buffer,encoding);
 		}while(new_chars);
-		do{
+		while(pos < key.size()){
 			res += serialize(buffer,key[pos++]);
-		}while(pos < key.size());
+		}
 		res += serialize(buffer, ptr->data.second);
 		do{
 			if(ptr->children.size()){
-				ptr = (typename bpp::collections::map::Trie<Types...>::node_type*) ptr->children.begin()->second;
+				ptr = (typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::node_type*) ptr->children.begin()->second;
 				key.push_back(ptr->data.first);
 			}else{
 				while(ptr->parent){
-					typename bpp::collections::map::Trie<Types...>::container_type::iterator it = ++(ptr->parent->children.find(ptr->data.first));
+					typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::container_type::iterator it = ++(ptr->parent->children.find(ptr->data.first));
 					if(it != ptr->parent->children.end()){
-						ptr = (typename bpp::collections::map::Trie<Types...>::node_type*) it->second;
+						ptr = (typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::node_type*) it->second;
 						key.back() = ptr->data.first;
 						break;
 					}
@@ -956,9 +1159,9 @@ template<typename Buff, typename... Types> std::size_t Serialize<Buff,bpp::colle
 	}while(ptr);
 	return res;
 }
-template<typename Buff, typename... Types> std::size_t Deserialize<Buff,bpp::collections::map::Trie<Types...>>::operator()(Buff& buffer, bpp::collections::map::Trie<Types...>& obj) const{
-	typename bpp::collections::map::Trie<Types...>::key_type key;
-	typename bpp::collections::map::Trie<Types...>::key_type::value_type skey;
+template<typename Buff, class Key, class T, class Container, class Allocator, bool Counted, class Score> std::size_t Deserialize<Buff,bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>>::operator()(Buff& buffer, bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>& obj) const{
+	typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::key_type key;
+	typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::key_type::value_type skey;
 	std::size_t objs, new_chars, counter, res = deserialize(buffer, objs);
 	uint8_t encoding;
 	bool up;
@@ -978,7 +1181,9 @@ template<typename Buff, typename... Types> std::size_t Deserialize<Buff,bpp::col
 				res += deserialize(buffer, skey);
 				key.push_back(std::move(skey));
 			}
-			res += deserialize(buffer, obj[key]);
+			typename bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>::node_type* ptr = obj.get_forward(std::as_const(key), key.size());
+			res += deserialize(buffer, ptr->data.second);
+			obj.rescore(ptr);
 		}
 	}
 	return res;
@@ -990,7 +1195,7 @@ template<typename Buff, typename... Types> std::size_t Deserialize<Buff,bpp::col
 
 // Non-member
 // Other
-template<class A,class B,class C,class D, class Pred> std::size_t std::erase_if(bpp::collections::map::Trie<A,B,C,D>& trie, Pred pred){
+template<class A,class B,class C,class D,bool E,class F, class Pred> std::size_t std::erase_if(bpp::collections::map::Trie<A,B,C,D,E,F>& trie, Pred pred){
 	auto original = trie.size();
 	for (auto i = trie.begin(), last = trie.end(); i != last; ){
 		if(pred(*i)){
@@ -1001,11 +1206,11 @@ template<class A,class B,class C,class D, class Pred> std::size_t std::erase_if(
 	}
 	return original - trie.size();
 }
-template<class A,class B,class C,class D> void std::swap(bpp::collections::map::Trie<A,B,C,D>& lhs, bpp::collections::map::Trie<A,B,C,D>& rhs){
-	std::swap(lhs.alloc, rhs.alloc);
-	std::swap(lhs.data, rhs.data);
-	std::swap(lhs.counter, rhs.counter);
-	std::swap(lhs.nCounter, rhs.nCounter);
+template<class A,class B,class C,class D,bool E,class F> void std::swap(bpp::collections::map::Trie<A,B,C,D,E,F>& lhs, bpp::collections::map::Trie<A,B,C,D,E,F>& rhs){
+	// The children of each root point back at it, so the nodes are moved between the containers instead of swapping the roots
+	bpp::collections::map::Trie<A,B,C,D,E,F> tmp(std::move(lhs));
+	lhs = std::move(rhs);
+	rhs = std::move(tmp);
 }
 
 #endif
@@ -1,11 +1,12 @@
 #ifndef BPP_COLLECTIONS_MAP_TRIE_H
 #define BPP_COLLECTIONS_MAP_TRIE_H
-#include <algorithm>	// std::reverse
+#include <algorithm>	// std::reverse, std::push_heap, std::pop_heap
 #include <cstdint>		// uint8_t
 #include <map>			// std::map
 #include <memory>		// std::allocator<>, std::allocator_traits<>, std::construct_at, std::destroy_at
 #include <stdexcept>	// std::out_of_range
-#include <utility>		// std::move, std::pair
+#include <type_traits>	// std::conditional_t, std::is_void_v, std::type_identity<>
+#include <utility>		// std::move, std::pair, std::as_const
 #include <vector>		// std::vector
 #include "../Serialize.h"
 
@@ -13,13 +14,20 @@ namespace bpp{
 	namespace collections{
 		namespace map{
 
-//! Trie is a sorted associative container that contains key-value pairs with unique keys. Any indexed collection can be used as key for the Trie, but the base type should be specified. The Container support class can be specified but by default std::map is used. Keys are sorted by using the comparison function within Container. Search, removal, and insertion operations have loglinear complexity. This is an implementation of a trie/prefix tree structure.
-template <class Key, class T, class Container = std::map<Key, void*>, class Allocator = std::allocator<std::pair<const Key, T>>> class Trie{
+//! Trie is a sorted associative container that contains key-value pairs with unique keys. Any indexed collection can be used as key for the Trie, but the base type should be specified. The Container support class can be specified but by default std::map is used; for keys of one byte AdaptiveRadixMap holds the children of each node far more compactly and searches them faster. Keys are sorted by using the comparison function within Container. Search, removal, and insertion operations have loglinear complexity. This is an implementation of a trie/prefix tree structure.
+//! If Counted is true every node also keeps the number of elements in its subtree, which enables count_prefix() in linear time on the length of the prefix, regardless of the number of elements that begin with it.
+//! If Score is not void every node also keeps the highest score of the elements in its subtree, which enables top_k(). Score must define value_type, ordered by operator<, and the static member functions identity(), which returns a score not greater than any other, combine(lhs, rhs), which returns the greater of lhs and rhs, and lift(element), which returns the score of a std::pair of the last symbol of a key and its mapped value (e.g. MaxMonoid). Changes made to a mapped value through a reference (e.g. returned by operator[] or an iterator) can not be observed by the container, so refresh() must be called after them.
+template <class Key, class T, class Container = std::map<Key, void*>, class Allocator = std::allocator<std::pair<const Key, T>>, bool Counted = false, class Score = void> class Trie{
 	private:
 		struct NodeTrie;
 		struct iterator_actions;
 		// Rebind Allocator
 		using AllocatorNodes = typename std::allocator_traits<Allocator>::rebind_alloc<NodeTrie>;
+		// Augmentation, Score is only inspected if it is not void
+		static constexpr bool scored = !std::is_void_v<Score>;
+		template <class S> struct score_value{
+			using type = typename S::value_type;
+		};
 	public:
 		// Declares member types
 		//! Type of the keys for the key-value pairs.
@@ -42,6 +50,8 @@ template <class Key, class T, class Container = std::map<Key, void*>, class Allo
 		using node_type = NodeTrie;
 		//! Type of container.
 		using container_type = Container;
+		//! Type of the scores kept by the nodes, void if Score is void.
+		using score_type = typename std::conditional_t<scored, score_value<Score>, std::type_identity<void>>::type;
 		
 		//! Constructs an empty container.
 		Trie();
@@ -274,17 +284,34 @@ template <class Key, class T, class Container = std::map<Key, void*>, class Allo
 		//! Returns a range containing all elements with the given key in the container. The range is defined by two iterators, one pointing to the first element that is not less than key and another pointing to the first element greater than key. Alternatively, the first iterator may be obtained with lower_bound(), and the second with upper_bound().
 		template <class K> std::pair<iterator,iterator> equal_range(const K& key);
 		// template<class K> std::pair<const_iterator,const_iterator> equal_range(const K& key);
+		// Prefixes
+		//! Returns an iterator pointing to the element whose key is the longest prefix of key, which may be key itself. If no such element is found, past-the-end (see end()) iterator is returned. Only the path of key is walked, so the complexity is that of a single find().
+		template <class K> iterator longest_prefix_match(const K& key);
+		//! Returns iterators pointing to every element whose key is a prefix of key, which may be key itself, sorted by increasing length of the key. Only the path of key is walked, so the complexity is that of a single find() plus the construction of the iterators.
+		template <class K> std::vector<iterator> all_prefixes_of(const K& key);
+		//! Returns a range containing all elements whose key begins with prefix, in the order of the sorted keys. The range is defined by two iterators, one pointing to the first element that begins with prefix and another pointing to the first element after them. If no key begins with prefix, both iterators are equal to end(). Only the path of prefix is walked to find the range.
+		template <class K> std::pair<iterator,iterator> prefix_range(const K& prefix);
+		//! Returns the number of elements whose key begins with prefix. Linear complexity on the length of prefix if Counted is true, otherwise on the number of nodes below it.
+		template <class K> std::size_t count_prefix(const K& prefix) const;
+		
+		// Scores
+		//! Returns iterators pointing to the k elements with the highest scores among those whose key begins with prefix, sorted by decreasing score. Elements with equal scores are returned in unspecified order. The nodes below prefix are walked best-first, so only the subtrees that may hold one of the k elements are opened. Only available if Score is not void.
+		template <class K> std::vector<iterator> top_k(const K& prefix, std::size_t k) requires scored;
+		//! Recalculates the scores that depend on the element at pos. Must be called after modifying its mapped value through a reference (e.g. returned by operator[] or an iterator), since the container can not observe those changes. Linear complexity on the length of its key. Only available if Score is not void.
+		void refresh(iterator pos) requires scored;
+		//! Recalculates the scores that depend on the element at pos. Must be called after modifying its mapped value through a reference (e.g. returned by operator[] or an iterator), since the container can not observe those changes. Linear complexity on the length of its key. Only available if Score is not void.
+		void refresh(const_iterator pos) requires scored;
 		// Non-member
 		// Operators
 		//! Checks if the contents of lhs and rhs are equal, that is, they have the same number of elements and each element in lhs compares equal with the element in rhs at the same position.
-		template<class A,class B,class C,class D> friend bool operator==(const Trie<A,B,C,D>& lhs, const Trie<A,B,C,D>& rhs);
+		template<class A,class B,class C,class D,bool E,class F> friend bool operator==(const Trie<A,B,C,D,E,F>& lhs, const Trie<A,B,C,D,E,F>& rhs);
 		//! Compares the contents of lhs and rhs lexicographically.
-		template<class A,class B,class C,class D> friend std::strong_ordering operator<=>(const Trie<A,B,C,D>& lhs, const Trie<A,B,C,D>& rhs);
+		template<class A,class B,class C,class D,bool E,class F> friend std::strong_ordering operator<=>(const Trie<A,B,C,D,E,F>& lhs, const Trie<A,B,C,D,E,F>& rhs);
 		// Other
 		//! Erases all elements that satisfy the predicate pred from the container.
-		template<class A,class B,class C,class D, class Pred> friend std::size_t std::erase_if(Trie<A,B,C,D>& trie, Pred pred);
+		template<class A,class B,class C,class D,bool E,class F, class Pred> friend std::size_t std::erase_if(Trie<A,B,C,D,E,F>& trie, Pred pred);
 		//! Specialized swapping function.
-		template<class A,class B,class C,class D> friend void std::swap(Trie<A,B,C,D> &lhs, Trie<A,B,C,D>& rhs);
+		template<class A,class B,class C,class D,bool E,class F> friend void std::swap(Trie<A,B,C,D,E,F> &lhs, Trie<A,B,C,D,E,F>& rhs);
 		// Friendship
 		//! Specialization of the Serialize template to support Trie objects.
 		template<typename Buff, typename... Types> friend struct bpp::collections::serialize::Serialize;
@@ -293,6 +320,8 @@ template <class Key, class T, class Container = std::map<Key, void*>, class Allo
 		
 	private:
 		// Nested class NodeTrie
+		struct Empty{};
+		struct NoScore{};
 		struct NodeTrie{
 			union{
 				NodeTrie *parent;
@@ -301,6 +330,8 @@ template <class Key, class T, class Container = std::map<Key, void*>, class Allo
 			Container children;
 			std::pair<Key,T> data;
 			bool valid;
+			[[no_unique_address]] std::conditional_t<Counted, std::size_t, Empty> count;
+			[[no_unique_address]] std::conditional_t<scored, score_type, NoScore> best;
 			NodeTrie(NodeTrie* parent=0);
 			NodeTrie(const Key& key, NodeTrie* parent=0);
 			NodeTrie(Key&& key, NodeTrie* parent=0);
@@ -316,13 +347,17 @@ template <class Key, class T, class Container = std::map<Key, void*>, class Allo
 		template<class Vector> inline NodeTrie* get_forward(Vector&& key, std::size_t size);
 		template<class Vector> inline NodeTrie* get_forward(const Vector& key, std::size_t size, NodeTrie* hint, std::size_t idx);
 		template<class Vector> inline NodeTrie* get_forward(Vector&& key, std::size_t size, NodeTrie* hint, std::size_t idx);
-		template<class Vector> inline NodeTrie* find_node(Vector key, std::size_t size) const;
+		template<class Vector> inline NodeTrie* find_node(const Vector& key, std::size_t size) const;
+		template<class Vector, class Function> inline void prefix_nodes(const Vector& key, std::size_t size, Function visit) const;
 		template<class Vector> inline std::size_t len_array(const Vector& vec) const;
 		inline std::size_t len_array(const Key* array) const;
 		inline void remove_node(NodeTrie* ptr);
+		inline void recount(NodeTrie* ptr, bool inserted);
+		inline void rescore(NodeTrie* ptr);
+		inline void adopt(Trie& other);
 		// Iterator base structure
 		struct iterator_actions{
-			friend class Trie<Key,T,Container,Allocator>;
+			friend class Trie<Key,T,Container,Allocator,Counted,Score>;
 			iterator_actions();
 			iterator_actions(const iterator_actions& other);
 			iterator_actions(iterator_actions&& other);
@@ -353,12 +388,12 @@ template <class Key, class T, class Container = std::map<Key, void*>, class Allo
 		namespace serialize{
 
 //! Specialization of the Serialize template to support Trie objects.
-template<typename Buff, typename... Types> struct Serialize<Buff,bpp::collections::map::Trie<Types...>>{
-	std::size_t operator()(Buff& buffer, const bpp::collections::map::Trie<Types...>& obj) const;
+template<typename Buff, class Key, class T, class Container, class Allocator, bool Counted, class Score> struct Serialize<Buff,bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>>{
+	std::size_t operator()(Buff& buffer, const bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>& obj) const;
 };
 //! Specialization of the Deserialize template to support Trie objects.
-template<typename Buff, typename... Types> struct Deserialize<Buff,bpp::collections::map::Trie<Types...>>{
-	std::size_t operator()(Buff& buffer, bpp::collections::map::Trie<Types...>& obj) const;
+template<typename Buff, class Key, class T, class Container, class Allocator, bool Counted, class Score> struct Deserialize<Buff,bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>>{
+	std::size_t operator()(Buff& buffer, bpp::collections::map::Trie<Key,T,Container,Allocator,Counted,Score>& obj) const;
 };
 
 		}
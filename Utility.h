@@ -17,10 +17,16 @@ namespace bpp{
 		
 	}
 	
+	//! Memory management structures, like allocators that can be used by the containers of other modules.
+	namespace memory{
+		
+	}
+	
 	//! @}
 	}
 }
 
+#include "Utility/ArenaAllocator.h"
 #include "Utility/ByteOrdering.h"
 
 #endif
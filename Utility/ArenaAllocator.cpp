@@ -0,0 +1,183 @@
+#ifndef BPP_UTILITY_ARENAALLOCATOR_CPP
+#define BPP_UTILITY_ARENAALLOCATOR_CPP
+
+namespace bpp{
+	namespace utility{
+		namespace memory{
+
+// Constructors
+template <class T, std::size_t ChunkBlocks> ArenaAllocator<T,ChunkBlocks>::ArenaAllocator() :
+	arena(new Arena<ChunkBlocks>()),
+	pool(0){ }
+template <class T, std::size_t ChunkBlocks> ArenaAllocator<T,ChunkBlocks>::ArenaAllocator(const ArenaAllocator& other) noexcept :
+	arena(other.arena),
+	pool(other.pool){
+	++this->arena->references;
+}
+template <class T, std::size_t ChunkBlocks> ArenaAllocator<T,ChunkBlocks>::ArenaAllocator(ArenaAllocator&& other) noexcept :
+	arena(other.arena),
+	pool(other.pool){
+	++this->arena->references;
+}
+template <class T, std::size_t ChunkBlocks> template <class U> ArenaAllocator<T,ChunkBlocks>::ArenaAllocator(const ArenaAllocator<U, ChunkBlocks>& other) noexcept :
+	arena(other.arena),
+	pool(0){
+	// The pool for the size of T is looked up on the first allocation, so that rebinding never allocates
+	++this->arena->references;
+}
+
+// Destructor
+template <class T, std::size_t ChunkBlocks> ArenaAllocator<T,ChunkBlocks>::~ArenaAllocator(){
+	this->detach();
+}
+
+// Assignment
+template <class T, std::size_t ChunkBlocks> ArenaAllocator<T,ChunkBlocks>& ArenaAllocator<T,ChunkBlocks>::operator=(const ArenaAllocator& other) noexcept{
+	if(this->arena != other.arena){
+		++other.arena->references;
+		this->detach();
+		this->arena = other.arena;
+		this->pool = other.pool;
+	}
+	return *this;
+}
+template <class T, std::size_t ChunkBlocks> ArenaAllocator<T,ChunkBlocks>& ArenaAllocator<T,ChunkBlocks>::operator=(ArenaAllocator&& other) noexcept{
+	return *this = other;
+}
+
+// Allocation
+template <class T, std::size_t ChunkBlocks> T* ArenaAllocator<T,ChunkBlocks>::allocate(std::size_t n){
+	if(n != 1){ return std::allocator<T>().allocate(n); }
+	if(!this->pool){ this->pool = this->arena->pool(blockSize, blockAlign); }
+	return (T*) this->pool->allocate();
+}
+template <class T, std::size_t ChunkBlocks> void ArenaAllocator<T,ChunkBlocks>::deallocate(T* ptr, std::size_t n) noexcept{
+	if(n != 1){
+		std::allocator<T>().deallocate(ptr, n);
+	}else{
+		// Copies that never allocated have not looked up the pool yet, which must exist if ptr was allocated
+		if(!this->pool){ this->pool = this->arena->find(blockSize, blockAlign); }
+		this->pool->deallocate(ptr);
+	}
+}
+template <class T, std::size_t ChunkBlocks> ArenaAllocator<T,ChunkBlocks> ArenaAllocator<T,ChunkBlocks>::select_on_container_copy_construction() const{
+	return ArenaAllocator();
+}
+
+// Arena
+template <class T, std::size_t ChunkBlocks> bool ArenaAllocator<T,ChunkBlocks>::release(std::size_t expected) noexcept{
+	if(this->arena->live() != expected){ return false; }
+	this->arena->clear();
+	return true;
+}
+template <class T, std::size_t ChunkBlocks> std::size_t ArenaAllocator<T,ChunkBlocks>::allocated() const noexcept{
+	return this->arena->live();
+}
+template <class T, std::size_t ChunkBlocks> std::size_t ArenaAllocator<T,ChunkBlocks>::chunks() const noexcept{
+	std::size_t result = 0;
+	for(Pool* it = this->arena->pools; it; it = it->next){ result += it->chunks.size(); }
+	return result;
+}
+template <class T, std::size_t ChunkBlocks> std::size_t ArenaAllocator<T,ChunkBlocks>::memory() const noexcept{
+	std::size_t result = 0;
+	for(Pool* it = this->arena->pools; it; it = it->next){
+		for(auto chunk = it->chunks.begin(); chunk != it->chunks.end(); ++chunk){ result += chunk->second * it->size; }
+	}
+	return result;
+}
+
+// Operators
+template <class A, class B, std::size_t C> bool operator==(const ArenaAllocator<A,C>& lhs, const ArenaAllocator<B,C>& rhs) noexcept{
+	return lhs.arena == rhs.arena;
+}
+
+// Private members
+template <class T, std::size_t ChunkBlocks> void ArenaAllocator<T,ChunkBlocks>::detach() noexcept{
+	if(!--this->arena->references){ delete this->arena; }
+}
+
+// Class Arena
+template <std::size_t ChunkBlocks> Arena<ChunkBlocks>::Arena() :
+	pools(0),
+	references(1){ }
+template <std::size_t ChunkBlocks> Arena<ChunkBlocks>::~Arena(){
+	while(this->pools){
+		Pool* tmp = this->pools;
+		this->pools = tmp->next;
+		delete tmp;
+	}
+}
+template <std::size_t ChunkBlocks> Arena<ChunkBlocks>::Pool* Arena<ChunkBlocks>::find(std::size_t size, std::size_t align) const noexcept{
+	for(Pool* it = this->pools; it; it = it->next){
+		if(it->size == size && it->align == align){ return it; }
+	}
+	return 0;
+}
+template <std::size_t ChunkBlocks> Arena<ChunkBlocks>::Pool* Arena<ChunkBlocks>::pool(std::size_t size, std::size_t align){
+	Pool* ptr = this->find(size, align);
+	return ptr ? ptr : (this->pools = new Pool(size, align, this->pools));
+}
+template <std::size_t ChunkBlocks> void Arena<ChunkBlocks>::clear() noexcept{
+	for(Pool* it = this->pools; it; it = it->next){ it->clear(); }
+}
+template <std::size_t ChunkBlocks> std::size_t Arena<ChunkBlocks>::live() const noexcept{
+	std::size_t result = 0;
+	for(Pool* it = this->pools; it; it = it->next){ result += it->live; }
+	return result;
+}
+
+// Nested struct Pool
+template <std::size_t ChunkBlocks> Arena<ChunkBlocks>::Pool::Pool(std::size_t size, std::size_t align, Pool* next) :
+	free(0),
+	current(0),
+	last(0),
+	size(size),
+	align(align),
+	live(0),
+	next(next){ }
+template <std::size_t ChunkBlocks> Arena<ChunkBlocks>::Pool::~Pool(){
+	this->clear();
+}
+template <std::size_t ChunkBlocks> void* Arena<ChunkBlocks>::Pool::allocate(){
+	void* ptr;
+	if(this->free){
+		ptr = this->free;
+		this->free = this->free->next;
+	}else{
+		if(this->current == this->last){ this->grow(); }
+		ptr = this->current;
+		this->current += this->size;
+	}
+	++this->live;
+	return ptr;
+}
+template <std::size_t ChunkBlocks> void Arena<ChunkBlocks>::Pool::deallocate(void* ptr) noexcept{
+	Link* block = (Link*) ptr;
+	block->next = this->free;
+	this->free = block;
+	--this->live;
+}
+template <std::size_t ChunkBlocks> void Arena<ChunkBlocks>::Pool::grow(){
+	std::size_t blocks = this->chunks.size() ? this->chunks.back().second << 1 : 16;
+	if(blocks > ChunkBlocks){ blocks = ChunkBlocks ? ChunkBlocks : 1; }
+	this->chunks.reserve(this->chunks.size() + 1);
+	this->current = (unsigned char*) ::operator new(blocks * this->size, std::align_val_t(this->align));
+	this->last = this->current + blocks * this->size;
+	this->chunks.emplace_back(this->current, blocks);
+}
+template <std::size_t ChunkBlocks> void Arena<ChunkBlocks>::Pool::clear() noexcept{
+	for(auto it = this->chunks.begin(); it != this->chunks.end(); ++it){
+		::operator delete(it->first, std::align_val_t(this->align));
+	}
+	this->chunks.clear();
+	this->free = 0;
+	this->current = 0;
+	this->last = 0;
+	this->live = 0;
+}
+
+		}
+	}
+}
+
+#endif
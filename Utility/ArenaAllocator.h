@@ -0,0 +1,125 @@
+#ifndef BPP_UTILITY_ARENAALLOCATOR_H
+#define BPP_UTILITY_ARENAALLOCATOR_H
+#include <cstddef>		// std::size_t, std::ptrdiff_t
+#include <memory>		// std::allocator<>
+#include <new>			// std::bad_alloc, std::align_val_t, operator new, operator delete
+#include <type_traits>	// std::true_type, std::false_type
+#include <utility>		// std::pair
+#include <vector>		// std::vector<>
+
+namespace bpp{
+	namespace utility{
+		namespace memory{
+
+template <class T, std::size_t ChunkBlocks> class ArenaAllocator;
+
+//! Arena is the memory shared by the copies and rebound copies of an ArenaAllocator. It keeps a pool of blocks for every block size and alignment requested, so that allocators of different types never mix their blocks, and only returns the chunks of its pools to the system when it is cleared or destroyed. It can only be used through ArenaAllocator.
+template <std::size_t ChunkBlocks> class Arena{
+	private:
+		template <class T, std::size_t C> friend class ArenaAllocator;
+		// Nested struct Pool
+		struct Pool{
+			struct Link{
+				Link* next;
+			};
+			std::vector<std::pair<unsigned char*, std::size_t>> chunks;
+			Link* free;
+			unsigned char *current, *last;
+			std::size_t size, align, live;
+			Pool* next;
+			Pool(std::size_t size, std::size_t align, Pool* next);
+			~Pool();
+			inline void* allocate();
+			inline void deallocate(void* ptr) noexcept;
+			inline void grow();
+			inline void clear() noexcept;
+		};
+		Pool* pools;
+		std::size_t references;
+		Arena();
+		~Arena();
+		inline Pool* find(std::size_t size, std::size_t align) const noexcept;
+		inline Pool* pool(std::size_t size, std::size_t align);
+		inline void clear() noexcept;
+		inline std::size_t live() const noexcept;
+};
+
+//! ArenaAllocator is an allocator that carves single objects out of large contiguous chunks of memory. Objects released through deallocate() are kept in a free-list and recycled by later allocations, while the chunks themselves are only returned to the system when the last allocator referencing the arena is destroyed or when release() is called. Allocations of more than one object at a time are forwarded to std::allocator. Chunks start with a small number of blocks and double in size up to ChunkBlocks blocks. Copies of an allocator and allocators rebound from it (for a different type) share the same arena, which keeps a separate pool for every block size, so a container that rebinds the allocator to its node type allocates its nodes on the arena of the allocator it was given. The allocator is not thread-safe.
+template <class T, std::size_t ChunkBlocks = 4096> class ArenaAllocator{
+	private:
+		template <class U, std::size_t C> friend class ArenaAllocator;
+		using Pool = typename Arena<ChunkBlocks>::Pool;
+	public:
+		// Declares member types
+		//! Type of the objects allocated.
+		using value_type = T;
+		//! Type used to calculate sizes.
+		using size_type = std::size_t;
+		//! Type used to calculate differences.
+		using difference_type = std::ptrdiff_t;
+		//! Containers copy-constructed or copy-assigned keep their own arena.
+		using propagate_on_container_copy_assignment = std::false_type;
+		//! Containers move-assigned take over the arena of the source container.
+		using propagate_on_container_move_assignment = std::true_type;
+		//! Containers swapped exchange their arenas.
+		using propagate_on_container_swap = std::true_type;
+		//! Different allocators may use different arenas.
+		using is_always_equal = std::false_type;
+		//! Rebinds the allocator to a different type, the rebound allocator shares the arena.
+		template <class U> struct rebind{ using other = ArenaAllocator<U, ChunkBlocks>; };
+		
+		//! Constructs an allocator with a new empty arena.
+		ArenaAllocator();
+		//! Copy constructor. Constructs an allocator that shares the arena of other.
+		ArenaAllocator(const ArenaAllocator& other) noexcept;
+		//! Move constructor. Constructs an allocator that shares the arena of other, other remains usable.
+		ArenaAllocator(ArenaAllocator&& other) noexcept;
+		//! Rebind constructor. Constructs an allocator that shares the arena of other, its blocks are taken from the pool of the size of T.
+		template <class U> ArenaAllocator(const ArenaAllocator<U, ChunkBlocks>& other) noexcept;
+		//! Destructs the allocator. If this was the last allocator referencing the arena then all of its chunks are deallocated.
+		~ArenaAllocator();
+		
+		// Assignment
+		//! Copy assignment operator. Replaces the arena used with the arena of other.
+		ArenaAllocator& operator=(const ArenaAllocator& other) noexcept;
+		//! Move assignment operator. Replaces the arena used with the arena of other, other remains usable.
+		ArenaAllocator& operator=(ArenaAllocator&& other) noexcept;
+		
+		// Allocation
+		//! Allocates storage for n objects. Single objects are taken from the free-list or carved from the current chunk of the pool of the size of T, in any other case the storage is requested to std::allocator.
+		T* allocate(std::size_t n);
+		//! Deallocates the storage for n objects pointed to by ptr, which must have been obtained by a call to allocate(n) of an allocator of the same type sharing the same arena. Single objects are pushed to the free-list for recycling.
+		void deallocate(T* ptr, std::size_t n) noexcept;
+		//! Returns an allocator with a new empty arena, used by containers when they are copy constructed.
+		ArenaAllocator select_on_container_copy_construction() const;
+		
+		// Arena
+		//! Deallocates all chunks of the arena at once if exactly expected single objects, of any type, are currently allocated on it, returns whether the chunks were released. Destructors of the allocated objects are not called.
+		bool release(std::size_t expected) noexcept;
+		//! Returns the number of single objects, of any type, currently allocated on the arena.
+		std::size_t allocated() const noexcept;
+		//! Returns the number of chunks currently held by the arena.
+		std::size_t chunks() const noexcept;
+		//! Returns the total space in memory held by the chunks of the arena.
+		std::size_t memory() const noexcept;
+		
+		// Operators
+		//! Checks whether both allocators share the same arena.
+		template <class A, class B, std::size_t C> friend bool operator==(const ArenaAllocator<A,C>& lhs, const ArenaAllocator<B,C>& rhs) noexcept;
+		
+	private:
+		// Blocks must be able to hold the link of the free-list
+		static constexpr std::size_t blockAlign = alignof(T) < alignof(void*) ? alignof(void*) : alignof(T);
+		static constexpr std::size_t blockSize = ((sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T)) + blockAlign - 1) / blockAlign * blockAlign;
+		Arena<ChunkBlocks>* arena;
+		Pool* pool;
+		inline void detach() noexcept;
+};
+
+		}
+	}
+}
+
+#include "ArenaAllocator.cpp"
+
+#endif